@@ -0,0 +1,97 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef BUILTIN_TABLE_H_
+#define BUILTIN_TABLE_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "tool.h"
+
+// Values greater or equal to 100k are reserved for scripts,
+// so the functions array can't hold more builtins than that.
+#define BUILTIN_FUNCTION_INDEX_LIMIT 100000
+
+// Builtins rarely take more than a handful of arguments,
+// the builder lives on the stack so it stays small.
+#define BUILTIN_ARGUMENTS_CAPACITY 16
+
+// Array index given to builtin getters and setters for plain (non-array) access
+#define ARRAY_INDEX_NO_INDEX INT_MIN
+
+typedef struct builtin_function_entry_s builtin_function_entry_t;
+typedef struct builtin_function_table_s builtin_function_table_t;
+typedef struct builtin_variable_table_s builtin_variable_table_t;
+typedef struct builtin_handle_s builtin_handle_t;
+typedef struct builtin_arguments_s builtin_arguments_t;
+
+struct builtin_function_entry_s
+{
+    // Null-terminated copy of the builtin name, owned by the table
+    const char* name;
+    TRoutine routine;
+    int32_t argument_count;
+    // Index of the builtin in the runner functions array
+    int32_t index;
+};
+
+struct builtin_function_table_s
+{
+    perfect_hash_t name_hash;
+
+    // Dense array indexed by the perfect hash slots,
+    // the slot of a builtin is its id.
+    builtin_function_entry_t* entries;
+    uint32_t entry_count;
+
+    // Backing storage of every entry name
+    char* name_arena;
+};
+
+struct builtin_variable_table_s
+{
+    perfect_hash_t name_hash;
+
+    // Index in the builtin array of the variable hashed in each slot
+    int32_t* slot_indices;
+
+    // The runner builtin array, not owned by the table
+    rvariable_routine_t* variables;
+    uint32_t variable_count;
+};
+
+// Resolved once, then used to call the builtin routine directly
+struct builtin_handle_s
+{
+    TRoutine routine;
+    int32_t id;
+    int32_t argument_count;
+};
+
+// Fixed-capacity argument list, meant to be declared on the stack
+struct builtin_arguments_s
+{
+    rvalue_t values[BUILTIN_ARGUMENTS_CAPACITY];
+    size_t count;
+
+    // Backing refs of the borrowed string arguments, indexed like values
+    ref_string_t strings[BUILTIN_ARGUMENTS_CAPACITY];
+
+    // One bit per value, set for the runner strings made by builtin_arguments_push_str.
+    // Only those are freed on release, pushed rvalues stay owned by the caller.
+    uint32_t owned_strings;
+};
+COMPILE_TIME_ASSERT(BUILTIN_ARGUMENTS_CAPACITY <= 32);
+
+int bt_count_function_entries(rfunction_t*, size_t, size_t*);
+int bt_build_function_table_alloc(rfunction_t*, size_t, size_t, builtin_function_table_t*);
+int bt_lookup_function(const builtin_function_table_t*, const char*, int32_t*);
+int bt_get_function_entry(const builtin_function_table_t*, int32_t, builtin_function_entry_t**);
+int bt_destroy_function_table(builtin_function_table_t*);
+int bt_build_variable_table_alloc(rvariable_routine_t*, size_t, builtin_variable_table_t*);
+int bt_lookup_variable(const builtin_variable_table_t*, const char*, int32_t*);
+int bt_get_variable_entry(const builtin_variable_table_t*, int32_t, rvariable_routine_t**);
+int bt_destroy_variable_table(builtin_variable_table_t*);
+
+#endif  /* !BUILTIN_TABLE_H_ */
@@ -0,0 +1,54 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef DS_BUILDER_H_
+#define DS_BUILDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "utils.h"
+#include "gml_structs.h"
+#include "builtin_table.h"
+#include "runner_interface.h"
+
+typedef enum DS_VALUE_TYPE DS_VALUE_TYPE;
+
+typedef struct ds_value_s ds_value_t;
+
+enum DS_VALUE_TYPE
+{
+    DS_VALUE_REAL = 0,
+    DS_VALUE_INT64 = 1,
+    DS_VALUE_BOOL = 2,
+    DS_VALUE_STRING = 3,
+    // Index of a ds_map, added as a marked map
+    DS_VALUE_MAP = 4,
+    // Index of a ds_list, added as a marked list
+    DS_VALUE_LIST = 5,
+    DS_VALUE_RVALUE = 6
+};
+
+// One value given to the builders, strings are copied by the runner
+struct ds_value_s
+{
+    DS_VALUE_TYPE type;
+    union
+    {
+        double real;
+        int64_t i64;
+        bool boolean;
+        const char* string;
+        int32_t index;
+        rvalue_t* rvalue;
+    };
+};
+
+int db_create_map(const yyrunner_interface_t*, int32_t*);
+int db_create_list(const yyrunner_interface_t*, int32_t*);
+int db_map_add_reals(const yyrunner_interface_t*, int32_t, const char* const*, const double*, size_t);
+int db_map_add_strings(const yyrunner_interface_t*, int32_t, const char* const*, const char* const*, size_t);
+int db_map_add_values(const yyrunner_interface_t*, int32_t, const char* const*, const ds_value_t*, size_t);
+int db_list_add_values(const yyrunner_interface_t*, const builtin_handle_t*, int32_t, const ds_value_t*, size_t);
+
+#endif  /* !DS_BUILDER_H_ */
@@ -10,11 +10,15 @@
 #include "utils.h"
 #include "error.h"
 
+// The upper bits of an rvalue kind hold flags, the type is in the lower ones
+#define RVALUE_KIND_MASK 0x0ffffff
+
 typedef enum EJSRetValBool EJSRetValBool;
 typedef enum YYOBJECT_KIND YYOBJECT_KIND;
 typedef enum RVALUE_TYPE RVALUE_TYPE;
 
 typedef struct rvalue_s rvalue_t;
+typedef struct ref_string_s ref_string_t;
 typedef struct weak_ref_s weak_ref_t;
 typedef struct physics_object_s physics_object_t;
 typedef struct skeleton_instance_s skeleton_instance_t;
@@ -51,7 +55,7 @@ typedef struct yyrect_s yyrect_t;
 typedef struct instance_base_s instance_base_t;
 
 typedef void(*PFUNC_RAW)();
-typedef rvalue_t(*PFUNC_YYGMLScript)(instance_t* self, instance_t* other, rvalue_t* result, int argument_count, rvalue_t** Arguments);
+typedef rvalue_t*(*PFUNC_YYGMLScript)(instance_t* self, instance_t* other, rvalue_t* result, int argument_count, rvalue_t** Arguments);
 typedef void(*PFUNC_YYGML)(instance_t* self, instance_t* other);
 typedef void(*FNGetOwnProperty)(yyobject_base_t* object, rvalue_t* result, const char* name);
 typedef void(*FNDeleteProperty)(yyobject_base_t* object, rvalue_t* result, const char* name, bool throw_on_error);
@@ -67,11 +71,15 @@ typedef layer_t* p_layer_t;
 typedef layer_element_base_t* p_layer_element_base_t;
 typedef layer_instance_element_t* p_layer_instance_element_t;
 DEF_HASHMAP(int32_t, p_rvalue_t)
+DEF_FUNC_HASH(int32_t, p_rvalue_t)
 DEF_HASHMAP(int, p_object_gm_t)
 DEF_HASHMAP(int, p_event_t)
 DEF_HASHMAP(int32_t, p_layer_t)
+DEF_FUNC_HASH(int32_t, p_layer_t)
 DEF_HASHMAP(int32_t, p_layer_element_base_t)
+DEF_FUNC_HASH(int32_t, p_layer_element_base_t)
 DEF_HASHMAP(int32_t, p_layer_instance_element_t)
+DEF_FUNC_HASH(int32_t, p_layer_instance_element_t)
 
 DEF_LINKEDLIST(instance_t)
 DEF_LINKEDLIST(layer_element_base_t)
@@ -179,6 +187,14 @@ struct rvalue_s
     RVALUE_TYPE kind;
 };
 
+// What a VALUE_STRING rvalue points at, the runner frees it once ref_count drops to 0
+struct ref_string_s
+{
+    const char* thing;
+    int32_t ref_count;
+    int32_t size;
+};
+
 struct rtoken_s
 {
     int kind;
@@ -0,0 +1,63 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef HOT_RELOAD_H_
+#define HOT_RELOAD_H_
+
+#include <stdint.h>
+#include "utils.h"
+
+// A file has to stay untouched that long before it's reloaded,
+// a build usually writes the same DLL several times in a row
+#define HOT_RELOAD_SETTLE_MS 250
+// Files waiting to settle, changes past that are dropped until some are reloaded
+#define HOT_RELOAD_MAX_PENDING 64
+#define HOT_RELOAD_NAME_CAPACITY 256
+#define HOT_RELOAD_EVENT_BUFFER_SIZE (16 * 1024)
+#define HOT_RELOAD_EXTENSION ".dll"
+
+typedef struct hot_reload_pending_s hot_reload_pending_t;
+typedef struct hot_reload_watcher_s hot_reload_watcher_t;
+
+struct hot_reload_pending_s
+{
+    char name[HOT_RELOAD_NAME_CAPACITY];
+    uint64_t last_change_ms;
+};
+
+// Watches the DLLs directly inside one folder, sub folders are not watched
+struct hot_reload_watcher_s
+{
+    // Folder with its separator, the name of a changed file is written after it
+    char path[WALKER_PATH_CAPACITY];
+    size_t folder_length;
+
+#ifdef _WIN32
+    HANDLE directory;
+    OVERLAPPED overlapped;
+    bool read_pending;
+    // ReadDirectoryChangesW wants it DWORD aligned
+    DWORD events[HOT_RELOAD_EVENT_BUFFER_SIZE / sizeof(DWORD)];
+#else
+    int inotify;
+    int watch;
+    // inotify events are int aligned
+    int events[HOT_RELOAD_EVENT_BUFFER_SIZE / sizeof(int)];
+#endif
+
+    hot_reload_pending_t pending[HOT_RELOAD_MAX_PENDING];
+    size_t pending_count;
+};
+
+int hr_open(const char*, hot_reload_watcher_t*);
+int hr_poll(hot_reload_watcher_t*, int(*)(const char*, void*), void*);
+int hr_close(hot_reload_watcher_t*);
+
+// Reloading goes through the module loader, the watcher alone also builds on Linux
+#ifdef _WIN32
+int hr_reload_image(const char*, bool*);
+int hr_reload_changed(hot_reload_watcher_t*, size_t*);
+#endif
+
+#endif  /* !HOT_RELOAD_H_ */
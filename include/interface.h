@@ -12,11 +12,18 @@
 #include "gml_structs.h"
 #include "tool.h"
 #include "utils.h"
+#include "builtin_table.h"
+#include "room.h"
+#include "snapshot.h"
+#include "spatial.h"
+#include "rvalue_string.h"
+#include "rvalue_array.h"
+#include "struct_members.h"
+#include "serializer.h"
+#include "ds_builder.h"
 #include "runner_interface.h"
 #include "../safety_hook_wrapper/include/wrapper.h"
 
-typedef const char* str;
-
 typedef enum OBJECT_TYPE OBJECT_TYPE;
 typedef enum EVENT_TRIGGERS EVENT_TRIGGERS;
 typedef enum CM_COLOR CM_COLOR;
@@ -42,6 +49,11 @@ typedef struct interface_impl_s interface_impl_t;
 typedef struct base_object_s base_object_t;
 typedef struct interface_table_entry_s interface_table_entry_t;
 typedef struct system_thread_information_s system_thread_information_t;
+typedef struct module_table_s module_table_t;
+
+// Generation in the high 32 bits, slot in the low 32 bits, see module_table.h
+typedef uint64_t module_handle_t;
+#define MODULE_HANDLE_NULL 0
 
 typedef int(*Entry)(module_t*,const char*);
 typedef int(*LoaderEntry)(module_t*, int(*pp_get_framework_routine)(const char*, void**), Entry, const char*, module_t*);	
@@ -54,8 +66,8 @@ typedef int(*ModuleCallback)(module_t*, MODULE_OPERATION_TYPE, operation_info_t*
 
 DEF_HASHMAP(str, TRoutine)
 DEF_FUNC_HASH(str, TRoutine)
-DEF_HASHMAP(str, size_t)
-DEF_FUNC_HASH(str, size_t)
+DEF_HASHMAP(int32_t, str)
+DEF_FUNC_HASH(int32_t, str)
 DEF_VECTOR(module_callback_descriptor_t)
 DEF_FUNC_VEC(module_callback_descriptor_t) 
 DEF_VECTOR(module_t)
@@ -102,7 +114,9 @@ enum MODULE_OPERATION_TYPE
     // The call is a ModuleInitialize call
     OPERATION_INITIALIZE = 2,
     // The call is a ModuleUnload call
-    OPERATION_UNLOAD = 3
+    OPERATION_UNLOAD = 3,
+    // The call is a ModuleHotReload call, the module was replaced in place
+    OPERATION_RELOAD = 4
 };
 
 enum CM_COLOR
@@ -355,6 +369,10 @@ struct interface_s
     int(*get_global_instance)(instance_t** instance);
     int(*call_builtin)(const char* function_name, rvalue_t* args, size_t arg_size, rvalue_t* out);
     int(*call_builtin_ex)(interface_impl_t*, rvalue_t*, const char*, instance_t*, instance_t*, rvalue_t*, size_t);
+    int(*get_builtin_function_id)(interface_impl_t*, const char*, int32_t*);
+    int(*call_builtin_by_id)(interface_impl_t*, int32_t, rvalue_t*, instance_t*, instance_t*, rvalue_t*, size_t);
+    int(*resolve_builtin)(interface_impl_t*, const char*, builtin_handle_t*);
+    int(*invoke_builtin)(const builtin_handle_t* handle, instance_t* self, instance_t* other, rvalue_t* args, size_t arg_size, rvalue_t* out);
     
     int(*print_warning)(const char*);
 
@@ -362,26 +380,64 @@ struct interface_s
     int(*remove_callback)(module_t* module, void* routine);
     
     int(*get_instance_member)(rvalue_t instance, const char* member_name, rvalue_t** member);
+    int(*get_instance_member_by_slot)(rvalue_t instance, int32_t slot, rvalue_t** member);
     int(*enum_instance_members)(rvalue_t instance, bool(*enum_function)(const char* member_name, rvalue_t* value));
+    int(*count_instance_members)(rvalue_t instance, size_t* count);
+    int(*get_instance_members)(rvalue_t instance, member_entry_t* members, size_t capacity, size_t* count);
+    int(*get_variable_name)(rvalue_t instance, int32_t slot, const char** name);
 
     int(*rvalue_to_string)(rvalue_t* value, char** string);
     int(*string_to_rvalue)(const char* string, rvalue_t* value);
+    int(*rvalue_to_string_buffer)(rvalue_t* value, char* buffer, size_t capacity, size_t* length);
+    int(*get_string_view)(const rvalue_t* value, string_view_t* view);
 
     int(*get_runner_interface)(yyrunner_interface_t* yyrunner_interface);
     void (*invalidate_all_caches)();
 
     int(*get_script_data)(int index, script_t** script);
-    int(*get_builtin_variable_index)(char* name, size_t* index);
+    int(*get_asset_index)(const char* asset_name, int32_t* asset_index);
+    int(*call_script)(const char* script_name, instance_t* self, instance_t* other, rvalue_t* args, size_t arg_size, rvalue_t* out);
+    int(*call_script_by_index)(int32_t script_index, instance_t* self, instance_t* other, rvalue_t* args, size_t arg_size, rvalue_t* out);
+    int(*get_builtin_variable_index)(const char* name, size_t* index);
     int(*get_builtin_variable_information)(size_t index, rvariable_routine_t** variable_information);
-    int(*get_builtin)(char* name, instance_t* target_instance, int array_index, rvalue_t* value);
-    int(*set_builtin)(char* name, instance_t* target_instance, int array_index, rvalue_t* value);
+    int(*get_builtin)(const char* name, instance_t* target_instance, int array_index, rvalue_t* value);
+    int(*set_builtin)(const char* name, instance_t* target_instance, int array_index, rvalue_t* value);
+    int(*get_builtin_by_index)(size_t index, instance_t* target_instance, int array_index, rvalue_t* value);
+    int(*set_builtin_by_index)(size_t index, instance_t* target_instance, int array_index, rvalue_t* value);
+    int(*get_builtin_real_by_index)(size_t index, instance_t* target_instance, double* value);
+    int(*get_builtins_by_index)(const size_t* indices, size_t count, instance_t* target_instance, rvalue_t* values);
     int(*get_array_entry)(rvalue_t* value, size_t array_index, rvalue_t** array_element);
     int(*get_array_size)(rvalue_t* value, size_t* size);
+    int(*get_array_range)(rvalue_t* value, size_t start, size_t count, rvalue_t* values);
+    int(*set_array_range)(rvalue_t* value, size_t start, size_t count, const rvalue_t* values);
+    int(*get_array_reals)(rvalue_t* value, size_t start, size_t count, double* values);
+    int(*set_array_reals)(rvalue_t* value, size_t start, size_t count, const double* values);
+    int(*save_rvalue)(rvalue_t* value, const char* path);
+    int(*load_rvalue)(const char* path, rvalue_t* value);
+    int(*create_ds_map)(int32_t* map);
+    int(*create_ds_list)(int32_t* list);
+    int(*ds_map_add_reals)(int32_t map, const char* const* keys, const double* values, size_t count);
+    int(*ds_map_add_strings)(int32_t map, const char* const* keys, const char* const* values, size_t count);
+    int(*ds_map_add_values)(int32_t map, const char* const* keys, const ds_value_t* values, size_t count);
+    int(*ds_list_add_values)(int32_t list, const ds_value_t* values, size_t count);
     int(*get_room_data)(int32_t room_id, room_t** room);
     int(*get_current_room_data)(room_t** current_room);
     int(*get_instance_object)(int32_t instance_id, instance_t** instance);
     int(*invoke_with_object)(const rvalue_t* object, void(*method)(instance_t* self, instance_t* other));
     int(*get_variable_slot)(const rvalue_t* object, const char* variable_name, int32_t* hash);
+    int(*get_layer_by_id)(int32_t layer_id, layer_t** layer);
+    int(*get_layer_element_by_id)(int32_t element_id, layer_element_base_t** element);
+    int(*get_instance_layer_element)(int32_t instance_id, layer_instance_element_t** element);
+    int(*get_layer_elements)(layer_t* layer, layer_element_base_t** elements, size_t capacity, size_t* count);
+    int(*get_instance_accessors)(const instance_accessors_t** accessors);
+    int(*begin_instance_iteration)(int32_t object_index, instance_iterator_t* iterator);
+    int(*next_instance_batch)(instance_iterator_t* iterator, instance_t** instances, size_t capacity, size_t* count);
+    int(*capture_instance_snapshot)(int32_t object_index, instance_snapshot_t* snapshot);
+    int(*apply_instance_snapshot)(const instance_snapshot_t* snapshot, uint32_t fields);
+    int(*update_spatial_index)(const instance_snapshot_t* snapshot);
+    int(*query_instances_in_rect)(yyrect_t rect, instance_t** instances, size_t capacity, size_t* count);
+    int(*query_instances_in_radius)(float x, float y, float radius, instance_t** instances, size_t capacity, size_t* count);
+    int(*query_nearest_instances)(float x, float y, size_t k, instance_t** instances, float* distances, size_t* count);
 };
 
 struct interface_impl_s
@@ -431,13 +487,47 @@ struct interface_impl_s
     // A pointer to the pointer to the running room
     room_t** run_room;
 
+    // Accessors matching the instance layout of the runner, NULL until detected
+    const instance_accessors_t* instance_accessors;
+
+    // Grid over the instance bounding boxes, fed by update_spatial_index
+    spatial_grid_t spatial_index;
+
     // Cache used for lookups of builtin functions (room_goto, etc.)
     // key = name, value = function pointer
     HASHMAP(str, TRoutine) builtin_function_cache;
 
-    // Cache used for lookups of builtin variables (xprevious, etc.)
+    // Every entry of the functions array, ingested once in a perfect-hashed table
+    // key = name, value = routine, argument count and index in the functions array
+    builtin_function_table_t builtin_function_table;
+
+    // Cache used for lookups of assets (scripts, objects, sprites, etc.)
+    // key = name, value = index returned by asset_get_index
+    HASHMAP(str, int32_t) asset_index_cache;
+
+    // The room the asset cache was filled in, a room change invalidates it
+    room_t* asset_cache_room;
+
+    // Pre-resolved asset_get_index, used to fill the asset cache
+    builtin_handle_t asset_get_index_handle;
+
+    // Pre-resolved ds_list_add, for the list values the runner interface can't add
+    builtin_handle_t ds_list_add_handle;
+
+    // Pre-resolved array_length, asked on every array access
+    builtin_handle_t array_length_handle;
+
+    // Cache used for lookups of variable slots, slots are shared by every object
+    // key = name, value = slot returned by FindAllocSlot
+    HASHMAP(str, int32_t) variable_slot_cache;
+
+    // Reverse of the variable slot cache, the names belong to it
+    // key = slot, value = name
+    HASHMAP(int32_t, str) variable_name_cache;
+
+    // Every entry of the builtin array, ingested once in a perfect-hashed table
     // key = name, value = index in the m_BuiltinArray
-    HASHMAP(str, size_t) builtin_variable_cache;
+    builtin_variable_table_t builtin_variable_table;
 
     // D3D11 stuff
     IDXGISwapChain* engine_swapchain;
@@ -471,6 +561,11 @@ struct interface_impl_s
 
     // === Internal functions ===
     int(*extract_function_entry)(interface_impl_t*, size_t, char**, TRoutine*, int32_t*);
+    int(*build_builtin_function_table)(interface_impl_t*);
+    int(*invalidate_asset_cache)(interface_impl_t*);
+    int(*build_builtin_variable_table)(interface_impl_t*);
+    int(*detect_instance_layout)(interface_impl_t*, OLINKEDLIST(instance_t)*);
+    int(*get_array_range_data)(interface_impl_t*, rvalue_t*, size_t, size_t, rvalue_t**);
     int(*descriptor_comparator)(const void*, const void*);
     int(*sort_module_callbacks)(interface_impl_t*);
     int(*create_callback_descriptor)(module_t*, EVENT_TRIGGERS, void*, int32_t, module_callback_descriptor_t*);
@@ -525,6 +620,14 @@ struct module_s
             // If this bit is set, the module was loaded by a MdMapImage call from another module.
             // This makes it such that its ModulePreload function never gets called.
             bool is_runtime_loaded : 1;
+
+            // If this bit is set, the module is mapped but neither preloaded nor initialized yet.
+            // It is on the first lookup of an interface it provides.
+            bool is_lazy : 1;
+
+            // If this bit is set, the module's operation callback can run on the worker pool,
+            // see ob_set_operation_callback_thread_safe
+            bool has_pooled_operation_callback : 1;
         };
     } flags;
 
@@ -542,6 +645,10 @@ struct module_s
     // The path of the loaded image.
     char* image_path;
 
+    // The copy of image_path that was actually loaded when the module can be hot reloaded,
+    // so the file at image_path can be rebuilt. NULL otherwise.
+    char* shadow_path;
+
     // The address of the Windows entrypoint of the image.
     union
     {
@@ -576,6 +683,13 @@ struct module_s
 
     // If set, notifies the plugin of any module actions
     ModuleCallback module_operation_callback;
+
+    // If set, the module is reloaded in place when its file changes and this
+    // is called instead of ModulePreinitialize and ModuleInitialize
+    Entry module_hot_reload;
+
+    // Set once the module is in global_module_table, MODULE_HANDLE_NULL before
+    module_handle_t handle;
 };
 
 struct system_thread_information_s
@@ -593,11 +707,12 @@ struct system_thread_information_s
     MSL_KWAIT_REASON WaitReason;
 };
 
-extern VECTOR(module_t) global_module_list;
+extern module_table_t global_module_table;
 extern module_t* global_initial_image;
 
 void destructor_inline_hook_t(inline_hook_t*);
 void destructor_mid_hook_t(mid_hook_t*);
+int initialize_interface(interface_impl_t*);
 rvalue_t init_rvalue(void);
 rvalue_t init_rvalue_bool(bool);
 rvalue_t init_rvalue_double(double);
@@ -606,4 +721,14 @@ rvalue_t init_rvalue_i32(int32_t);
 rvalue_t init_rvalue_instance(instance_t*);
 rvalue_t init_rvalue_str(const char*);
 int init_rvalue_str_interface(rvalue_t*, const char*, interface_impl_t*);
+int builtin_arguments_init(builtin_arguments_t*);
+int builtin_arguments_push(builtin_arguments_t*, rvalue_t);
+int builtin_arguments_push_double(builtin_arguments_t*, double);
+int builtin_arguments_push_i64(builtin_arguments_t*, int64_t);
+int builtin_arguments_push_bool(builtin_arguments_t*, bool);
+int builtin_arguments_push_instance(builtin_arguments_t*, instance_t*);
+int builtin_arguments_push_str(builtin_arguments_t*, const char*);
+int builtin_arguments_push_borrowed_str(builtin_arguments_t*, const char*);
+int builtin_arguments_release(builtin_arguments_t*);
+int remove_module_callbacks(interface_impl_t*, module_t*);
 #endif  /* !INTERFACE_H_ */
\ No newline at end of file
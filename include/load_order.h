@@ -0,0 +1,83 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef LOAD_ORDER_H_
+#define LOAD_ORDER_H_
+
+#include <stdint.h>
+#include "utils.h"
+
+// A module foo.dll can be described by a foo.deps text file next to it:
+//     # comment
+//     priority = 10
+//     requires = bar.dll
+//     requires = baz
+//     provides = bar_interface
+// Modules listed in requires are loaded before it, the .dll is optional and names ignore case.
+// Among the modules that are ready, the highest priority goes first, then the file name.
+// provides is read by the lazy initialization, see md_set_lazy_initialization.
+#define LOAD_ORDER_MANIFEST_EXTENSION ".deps"
+#define LOAD_ORDER_IMAGE_EXTENSION ".dll"
+#define LOAD_ORDER_LINE_CAPACITY 512
+
+typedef struct load_order_entry_s load_order_entry_t;
+typedef struct load_order_edge_s load_order_edge_t;
+typedef struct load_order_s load_order_t;
+typedef struct load_order_manifest_context_s load_order_manifest_context_t;
+
+struct load_order_entry_s
+{
+    const char* path;
+    // File name without folder nor image extension, not terminated
+    const char* name;
+    size_t name_length;
+
+    int32_t priority;
+    // Position once sorted by name then path, used to break ties
+    size_t rank;
+    // Dependencies not loaded yet
+    size_t pending;
+    // Dependents, as a range of load_order_t dependents
+    size_t first_dependent;
+    size_t dependent_count;
+    bool emitted;
+};
+
+// dependency is loaded before dependent
+struct load_order_edge_s
+{
+    size_t dependency;
+    size_t dependent;
+};
+
+struct load_order_s
+{
+    load_order_entry_t* entries;
+    size_t count;
+
+    // Entries sorted by name then path
+    size_t* by_name;
+
+    load_order_edge_t* edges;
+    size_t edge_count;
+    size_t edge_capacity;
+
+    size_t* dependents;
+
+    // Ready entries, smallest key on top
+    size_t* heap;
+    size_t heap_size;
+};
+
+// The entry a manifest is read for
+struct load_order_manifest_context_s
+{
+    load_order_t* order;
+    size_t index;
+};
+
+int lo_sort(const char* const*, size_t, size_t*);
+int lo_read_manifest_entries(const char*, int(*)(const char*, const char*, void*), void*);
+
+#endif  /* !LOAD_ORDER_H_ */
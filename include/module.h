@@ -6,14 +6,106 @@
 #define MODULE_H_
 
 #include "interface.h"
+#include "module_table.h"
+
+// First sizes of a module path list, enough for most mod folders without growing
+#define MODULE_PATH_ARENA_CAPACITY (16 * 1024)
+#define MODULE_PATH_LIST_CAPACITY 128
+// Appended with a number to the path of the copy a hot reloadable module is loaded from
+#define MODULE_SHADOW_EXTENSION ".hot"
+
+typedef struct module_candidate_s module_candidate_t;
+typedef struct module_path_list_s module_path_list_t;
+typedef struct module_index_keys_s module_index_keys_t;
+typedef struct module_index_s module_index_t;
+typedef struct startup_timings_s startup_timings_t;
+
+DEF_HASHMAP(file_identity_t, int32_t)
+DEF_FUNC_HASH(file_identity_t, int32_t)
+
+// What the validation of an image file found, before anything gets loaded
+struct module_candidate_s
+{
+    const char* image_path;
+
+    // MSL_SUCCESS if the image can be loaded as a module
+    int status;
+    unsigned short architecture;
+
+    // Export offsets in the image, 0 when missing
+    uintptr_t framework_initialize_offset;
+    uintptr_t module_initialize_offset;
+    uintptr_t module_preinitialize_offset;
+    uintptr_t module_operation_callback_offset;
+    uintptr_t module_unload_offset;
+    uintptr_t module_hot_reload_offset;
+};
+
+// Paths found while discovering modules, stored back to back in one arena.
+// Offsets are kept instead of pointers since the arena moves when it grows.
+struct module_path_list_s
+{
+    char* arena;
+    size_t arena_size;
+    size_t arena_capacity;
+
+    size_t* offsets;
+    size_t count;
+    size_t capacity;
+};
+
+// Keys of the module in the same slot of global_module_table, computed once when it's added
+struct module_index_keys_s
+{
+    // See canonical_path, NULL if the module has no path
+    char* path;
+    file_identity_t identity;
+    bool has_identity;
+};
+
+// Finds a module by path without going through the file system for every module.
+// Both maps give the slot of the module, keys has one entry per slot of global_module_table.
+struct module_index_s
+{
+    HASHMAP(str, int32_t) by_path;
+    HASHMAP(file_identity_t, int32_t) by_identity;
+
+    module_index_keys_t* keys;
+    size_t capacity;
+};
+
+// Where the time goes while modules are mapped, see md_get_startup_timings
+struct startup_timings_s
+{
+    // Reading and checking the files of a folder
+    phase_timer_t validate;
+    // Loading and initializing them
+    phase_timer_t load;
+    // Module operation callbacks, delivering batched ones included
+    phase_timer_t operation_callbacks;
+};
+
+extern startup_timings_t global_startup_timings;
 
 int mdp_create_module(const char*, HMODULE, bool, uint8_t, module_t*);
 int mdp_is_module_marked_for_purge(module_t*, bool*);
 int mdp_mark_module_for_purge(module_t*);
 int mdp_purge_marked_modules(void);
 int mdp_map_image(const char*, HMODULE*);
-int mdp_build_module_list(const char*, bool, int(*predicate)(const char*, bool*), VECTOR(str)*);
-int mdp_add_module_to_list(module_t*);
+int mdp_validate_image(const char*, unsigned short, module_candidate_t*);
+int mdp_validate_images(module_candidate_t*, size_t);
+int mdp_load_validated_image(const module_candidate_t*, HMODULE*, char**);
+void mdp_delete_shadow_copy(char**);
+int mdp_apply_image_exports(const module_candidate_t*, HMODULE, module_t*);
+int mdp_path_list_add(module_path_list_t*, const char*, size_t);
+int mdp_path_list_get(const module_path_list_t*, size_t, const char**);
+int mdp_path_list_free(module_path_list_t*);
+int mdp_build_module_list(const char*, bool, const char*, module_path_list_t*);
+int mdp_add_module_to_list(module_t*, module_t**);
+int mdp_remove_module_from_list(module_t*);
+int mdp_index_add_module(const module_t*);
+int mdp_index_remove_module(const module_t*);
+int mdp_index_update_module(const module_t*);
 int mdp_query_module_information(HMODULE, void**, uint32_t*, void**);
 int mdp_get_image_path(module_t*, char**);
 int mdp_get_image_folder_alloc(module_t*, char**);
@@ -23,13 +115,20 @@ int mdp_lookup_module_by_path(const char*, module_t**);
 int mdp_process_image_exports(const char*, HMODULE, module_t*);
 int mdp_unmap_image(module_t*, bool, bool);
 int mdp_dispatch_entry(module_t*, Entry);
+int mdp_defer_module_initialization(module_t*, bool*);
 int md_map_image(const char*, module_t*);
 int md_map_image_ex(const char*, bool, module_t*, bool*);
+int md_map_validated_image_ex(const module_candidate_t*, bool, module_t*, bool*);
 int md_is_image_initialized(module_t*, bool*);
 int md_is_image_preinitialized(module_t*, bool*);
 int md_map_folder(const char*, bool);
 int md_get_image_filename_alloc(module_t*, char**);
 int md_is_image_preinitialized(module_t*, bool*);
 int md_unmap_image(module_t*);
+int md_reload_image(module_t*, const char*);
+int md_set_lazy_initialization(bool);
+int md_activate_module(module_t*);
+int md_get_startup_timings(startup_timings_t*);
+int md_reset_startup_timings(void);
 
 #endif  /* !MODULE_H_ */
\ No newline at end of file
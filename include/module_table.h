@@ -0,0 +1,50 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef MODULE_TABLE_H_
+#define MODULE_TABLE_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "interface.h"
+
+// Modules allocated at once, a chunk never moves once allocated
+#define MODULE_TABLE_CHUNK_SIZE 64
+
+// Marks a slot without module in dense_positions
+#define MODULE_TABLE_FREE_SLOT UINT32_MAX
+
+#define MODULE_HANDLE_SLOT(handle) ((uint32_t)(handle))
+#define MODULE_HANDLE_GENERATION(handle) ((uint32_t)((handle) >> 32))
+#define MODULE_HANDLE(slot, generation) (((module_handle_t)(generation) << 32) | (slot))
+
+// Slot map of the loaded modules.
+// A module_t* stays valid until the module is removed, a handle is refused once
+// its slot is reused since the generation of the slot changes on every removal.
+struct module_table_s
+{
+    module_t** chunks;
+    size_t chunk_count;
+
+    // Per slot, slot_count of them
+    uint32_t* generations;
+    uint32_t* dense_positions;
+    size_t slot_count;
+
+    // Slots without module, the last freed is reused first
+    uint32_t* free_slots;
+    size_t free_count;
+
+    // Live modules back to back, removing one moves the last in its place
+    module_t** modules;
+    size_t count;
+};
+
+int mt_insert(module_table_t*, const module_t*, module_t**);
+int mt_remove(module_table_t*, module_handle_t);
+int mt_resolve(const module_table_t*, module_handle_t, module_t**);
+int mt_get_slot(const module_table_t*, uint32_t, module_t**);
+int mt_destroy(module_table_t*);
+
+#endif  /* !MODULE_TABLE_H_ */
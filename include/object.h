@@ -7,6 +7,63 @@
 
 #include "interface.h"
 
+// Longest interface name, terminator included
+#define INTERFACE_NAME_CAPACITY 256
+
+typedef struct interface_registry_entry_s interface_registry_entry_t;
+typedef struct interface_registry_s interface_registry_t;
+typedef struct module_operation_s module_operation_t;
+typedef struct module_operation_batch_s module_operation_batch_t;
+typedef struct module_operation_delivery_s module_operation_delivery_t;
+
+struct interface_registry_entry_s
+{
+    // Lower case copy of the name, the key in by_name
+    char* folded_name;
+    // NULL while the name is only reserved by a lazy module
+    interface_base_t* intf;
+    module_t* owner_module;
+};
+
+// Every interface of every module by name, names are case insensitive.
+// by_name gives the position in entries, removing one moves the last in its place.
+struct interface_registry_s
+{
+    HASHMAP(str, int32_t) by_name;
+
+    interface_registry_entry_t* entries;
+    size_t count;
+    size_t capacity;
+};
+
+// A notification for the thread safe callbacks, delivered before the dispatch that made it returns
+struct module_operation_s
+{
+    module_t* affected_module;
+    MODULE_OPERATION_TYPE type;
+    operation_info_t information;
+};
+
+// Notifications for the thread safe callbacks while a batch is open,
+// every callback then goes through all of them in order on the worker pool
+struct module_operation_batch_s
+{
+    module_operation_t* operations;
+    size_t count;
+    size_t capacity;
+    // Nested batches end with the outer one
+    uint32_t depth;
+};
+
+// One delivery of a batch, every observer is an item of the worker pool
+struct module_operation_delivery_s
+{
+    module_t** observers;
+    const module_operation_batch_t* batch;
+    // First error a callback returned
+    volatile LONG status;
+};
+
 int ob_create_interface(module_t*, interface_base_t*, const char*);
 int ob_interface_exists(const char*);
 int obp_destroy_interface_by_name(const char*);
@@ -18,6 +75,13 @@ int obp_add_interface_to_table(module_t*, interface_table_entry_t*);
 int obp_create_operation_info(module_t*, bool, operation_info_t*);
 int obp_destroy_interface(module_t*, interface_base_t*, bool, bool);
 int obp_lookup_interface_owner(const char*, bool, module_t**, interface_table_entry_t**);
+int obp_register_interface(module_t*, interface_base_t*, const char*);
+int obp_unregister_interface(const char*);
+int obp_reserve_interface(module_t*, const char*);
+int obp_release_reserved_interfaces(module_t*);
+int obp_begin_operation_batch(void);
+int obp_end_operation_batch(void);
+int ob_set_operation_callback_thread_safe(module_t*, bool);
 int ob_get_interface(const char*, interface_base_t**);
 int ob_destroy_interface(module_t*, const char*);
 
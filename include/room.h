@@ -0,0 +1,84 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef ROOM_H_
+#define ROOM_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+
+// Object index given to the iterator to walk every instance of the room
+#define INSTANCE_ITERATOR_ALL_OBJECTS (-1)
+
+// Members offset of an iterator that never reads members, see rm_iterator_init_single
+#define INSTANCE_MEMBERS_OFFSET_UNKNOWN SIZE_MAX
+
+// Reads a member through the accessors of the detected layout, a single load
+#define INSTANCE_MEMBER(accessors, instance, field) \
+    (((instance_internal_t*)((char*)(instance) + (accessors)->members_offset))->field)
+
+typedef enum INSTANCE_LAYOUT INSTANCE_LAYOUT;
+
+typedef struct instance_accessors_s instance_accessors_t;
+typedef struct instance_iterator_s instance_iterator_t;
+
+// Which member of the instance_s union the runner uses
+enum INSTANCE_LAYOUT
+{
+    // Islets 1.0.0.3 Steam (x86), GM 2022.6
+    INSTANCE_LAYOUT_MEMBERS_ONLY = 0,
+    // 2023.x => 2023.8 (and presumably 2023.11)
+    INSTANCE_LAYOUT_SEQUENCE_INSTANCE_ONLY = 1,
+    // 2022.1 => 2023.1
+    INSTANCE_LAYOUT_WITH_SKELETON_MASK = 2,
+    INSTANCE_LAYOUT_COUNT = 3
+};
+
+// Accessors generated for one layout, the right table is picked once
+struct instance_accessors_s
+{
+    INSTANCE_LAYOUT layout;
+
+    // Byte offset of instance_internal_t inside an instance
+    size_t members_offset;
+
+    instance_internal_t* (*get_members)(instance_t*);
+    int32_t (*get_id)(instance_t*);
+    int32_t (*get_object_index)(instance_t*);
+    float (*get_x)(instance_t*);
+    float (*get_y)(instance_t*);
+    instance_t* (*get_flink)(instance_t*);
+};
+
+// Walks a room active instances list, a batch at a time
+struct instance_iterator_s
+{
+    // Next instance to look at, NULL once the list is exhausted
+    instance_t* next;
+
+    // Instances left in the list, guards against a corrupted flink chain
+    int32_t remaining;
+
+    // Only instances of this object are yielded, unless INSTANCE_ITERATOR_ALL_OBJECTS
+    int32_t object_index;
+
+    // Byte offset of instance_internal_t inside an instance, see instance_accessors_t
+    size_t members_offset;
+};
+
+int rm_get_active_instances(room_t*, OLINKEDLIST(instance_t)**);
+int rm_get_instance_accessors(INSTANCE_LAYOUT, const instance_accessors_t**);
+int rm_detect_layout_by_id(instance_t*, int32_t, INSTANCE_LAYOUT*);
+int rm_detect_layout_by_elements(room_t*, instance_t*, INSTANCE_LAYOUT*);
+int rm_get_instance_members(instance_t*, size_t, instance_internal_t**);
+int rm_iterator_init(OLINKEDLIST(instance_t)*, int32_t, size_t, instance_iterator_t*);
+int rm_iterator_init_single(instance_t*, instance_iterator_t*);
+int rm_iterator_next_batch(instance_iterator_t*, instance_t**, size_t, size_t*);
+int rm_find_layer_by_id(room_t*, int32_t, layer_t**);
+int rm_find_layer_element_by_id(room_t*, int32_t, layer_element_base_t**);
+int rm_find_instance_element(room_t*, int32_t, layer_instance_element_t**);
+int rm_get_layer_elements(layer_t*, layer_element_base_t**, size_t, size_t*);
+
+#endif  /* !ROOM_H_ */
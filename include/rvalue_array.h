@@ -0,0 +1,24 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef RVALUE_ARRAY_H_
+#define RVALUE_ARRAY_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+
+// Kinds without a runner reference behind them, they can be overwritten in place
+#define RVALUE_ARRAY_PLAIN_KINDS                                        \
+    ((1u << VALUE_REAL) | (1u << VALUE_PTR) | (1u << VALUE_UNDEFINED) | \
+     (1u << VALUE_INT32) | (1u << VALUE_INT64) | (1u << VALUE_NULL) |   \
+     (1u << VALUE_BOOL))
+
+int ra_get_data(const rvalue_t*, int64_t, rvalue_t**);
+int ra_copy_out(const rvalue_t*, size_t, rvalue_t*);
+int ra_copy_in(rvalue_t*, size_t, const rvalue_t*);
+int ra_read_reals(const rvalue_t*, size_t, double*);
+int ra_write_reals(rvalue_t*, size_t, const double*);
+
+#endif  /* !RVALUE_ARRAY_H_ */
@@ -0,0 +1,31 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef RVALUE_STRING_H_
+#define RVALUE_STRING_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+
+// Reference count given to borrowed strings, high enough that the runner never frees them
+#define RVALUE_STRING_PINNED_REF_COUNT (INT32_MAX / 2)
+
+// Large enough for any value rs_to_buffer formats without a string ref
+#define RVALUE_STRING_SCRATCH_SIZE 64
+
+typedef struct string_view_s string_view_t;
+
+// Read-only window into a string owned by someone else, not null-terminated by contract
+struct string_view_s
+{
+    const char* data;
+    size_t length;
+};
+
+int rs_get_view(const rvalue_t*, string_view_t*);
+int rs_to_buffer(const rvalue_t*, char*, size_t, size_t*);
+int rs_init_borrowed(ref_string_t*, const char*, rvalue_t*);
+
+#endif  /* !RVALUE_STRING_H_ */
@@ -0,0 +1,79 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef SERIALIZER_H_
+#define SERIALIZER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+#include "runner_interface.h"
+
+#define SERIALIZER_MAGIC 0x534C534Du // "MSLS"
+#define SERIALIZER_VERSION 1
+
+// Arrays can hold themselves and have no visited field, nesting is bounded instead
+#define SERIALIZER_MAX_DEPTH 512
+
+// Bytes gathered before each write to the file
+#define SERIALIZER_BUFFER_SIZE (64 * 1024)
+
+// Written in place of visited while a struct is being serialized
+#define SERIALIZER_VISITED_MARK 0x4D534C53u
+
+typedef enum SERIALIZER_TAG SERIALIZER_TAG;
+
+typedef struct serializer_s serializer_t;
+
+// Every value starts with one of these tags, on a single byte.
+// Counts and lengths are uint32_t, numbers are stored as in memory (little endian).
+enum SERIALIZER_TAG
+{
+    SERIALIZER_TAG_REAL = 0,        // double
+    SERIALIZER_TAG_INT32 = 1,       // int32_t
+    SERIALIZER_TAG_INT64 = 2,       // int64_t
+    SERIALIZER_TAG_BOOL = 3,        // uint8_t
+    SERIALIZER_TAG_UNDEFINED = 4,
+    SERIALIZER_TAG_NULL = 5,
+    SERIALIZER_TAG_STRING = 6,      // length, bytes, the string gets the next table index
+    SERIALIZER_TAG_STRING_REF = 7,  // table index of a string written before
+    SERIALIZER_TAG_ARRAY = 8,       // count, values
+    SERIALIZER_TAG_STRUCT = 9,      // count, (name string, value) pairs
+    SERIALIZER_TAG_COUNT = 10
+};
+
+// State of one save or one load, the string table is built as the stream goes
+struct serializer_s
+{
+    const yyrunner_interface_t* runner;
+
+    // See interface rvalue_array_offset
+    int64_t rvalue_array_offset;
+
+    FILE* file;
+    uint8_t* buffer;
+    size_t buffer_used;
+    size_t buffer_read;
+
+    // Saving: text => index, keys are borrowed from the runner
+    HASHMAP(str, int32_t) string_indices;
+
+    // Loading: index => text, owned by the serializer
+    char** strings;
+    uint32_t string_count;
+    uint32_t string_capacity;
+
+    // Struct keys of every struct being walked, each level uses the top of the stack
+    const char** keys;
+    size_t key_count;
+    size_t key_capacity;
+
+    uint32_t depth;
+};
+
+int sr_save(const yyrunner_interface_t*, int64_t, rvalue_t*, const char*);
+int sr_load(const yyrunner_interface_t*, int64_t, const char*, rvalue_t*);
+
+#endif  /* !SERIALIZER_H_ */
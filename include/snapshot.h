@@ -0,0 +1,87 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+#include "room.h"
+
+// Instances gathered per iterator batch
+#define SNAPSHOT_BATCH_SIZE 64
+
+typedef enum SNAPSHOT_FIELD SNAPSHOT_FIELD;
+
+typedef struct instance_snapshot_s instance_snapshot_t;
+
+// Fields of instance_internal_t mirrored by a snapshot, usable as a mask
+enum SNAPSHOT_FIELD
+{
+    SNAPSHOT_X = 1 << 0,
+    SNAPSHOT_Y = 1 << 1,
+    SNAPSHOT_SPEED = 1 << 2,
+    SNAPSHOT_DIRECTION = 1 << 3,
+    SNAPSHOT_HORIZONTAL_SPEED = 1 << 4,
+    SNAPSHOT_VERTICAL_SPEED = 1 << 5,
+    SNAPSHOT_IMAGE_INDEX = 1 << 6,
+    SNAPSHOT_IMAGE_SPEED = 1 << 7,
+    SNAPSHOT_IMAGE_SCALE_X = 1 << 8,
+    SNAPSHOT_IMAGE_SCALE_Y = 1 << 9,
+    SNAPSHOT_IMAGE_ANGLE = 1 << 10,
+    SNAPSHOT_IMAGE_ALPHA = 1 << 11,
+    SNAPSHOT_BBOX_LEFT = 1 << 12,
+    SNAPSHOT_BBOX_TOP = 1 << 13,
+    SNAPSHOT_BBOX_RIGHT = 1 << 14,
+    SNAPSHOT_BBOX_BOTTOM = 1 << 15,
+    SNAPSHOT_FIELD_COUNT = 16,
+    SNAPSHOT_ALL = (1 << 16) - 1,
+};
+
+// Structure-of-arrays copy of the instance transforms, one entry per instance.
+// Arrays are indexed like instances, and all live in the same allocation.
+struct instance_snapshot_s
+{
+    instance_t** instances;
+    size_t count;
+    size_t capacity;
+
+    // Byte offset of instance_internal_t inside an instance
+    size_t members_offset;
+
+    float* x;
+    float* y;
+    float* speed;
+    float* direction;
+    float* horizontal_speed;
+    float* vertical_speed;
+    float* image_index;
+    float* image_speed;
+    float* image_scale_x;
+    float* image_scale_y;
+    float* image_angle;
+    float* image_alpha;
+    float* bbox_left;
+    float* bbox_top;
+    float* bbox_right;
+    float* bbox_bottom;
+
+    // Backing storage of every array above
+    float* arena;
+};
+
+int sn_capture(instance_iterator_t*, instance_snapshot_t*);
+int sn_apply(const instance_snapshot_t*, uint32_t);
+int sn_destroy(instance_snapshot_t*);
+
+// Example kernels, the _sse and _avx2 variants are only built when the compiler targets them
+int sn_distance_squared(const instance_snapshot_t*, float, float, float*);
+int sn_distance_squared_sse(const instance_snapshot_t*, float, float, float*);
+int sn_distance_squared_avx2(const instance_snapshot_t*, float, float, float*);
+int sn_integrate_speed(instance_snapshot_t*, float);
+int sn_integrate_speed_sse(instance_snapshot_t*, float);
+int sn_integrate_speed_avx2(instance_snapshot_t*, float);
+
+#endif  /* !SNAPSHOT_H_ */
@@ -0,0 +1,84 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef SPATIAL_H_
+#define SPATIAL_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+#include "snapshot.h"
+
+// Cell size used when the grid is created with a size of 0, in pixels
+#define SPATIAL_DEFAULT_CELL_SIZE 64.0f
+
+// Marks the end of a bucket chain or of the free list
+#define SPATIAL_NO_ENTRY (-1)
+
+#define HASH_KEY_p_instance_t hash_key_ptr
+#define KEY_EQUAL_p_instance_t(A, B) ((A) == (B))
+
+typedef instance_t* p_instance_t;
+
+typedef struct spatial_entry_s spatial_entry_t;
+typedef struct spatial_grid_s spatial_grid_t;
+
+DEF_HASHMAP(p_instance_t, int32_t)
+DEF_FUNC_HASH(p_instance_t, int32_t)
+
+// One instance, filed under the cell holding the center of its bounding box
+struct spatial_entry_s
+{
+    instance_t* instance;
+    yyrect_t bounding_box;
+    uint64_t cell;
+
+    // Chain of the entries sharing a bucket, or of the free entries
+    int32_t next;
+    int32_t previous;
+
+    // Update the entry was last seen in, older entries are gone from the room
+    uint32_t generation;
+};
+
+// Loose uniform grid, cells are hashed so the room size doesn't matter
+struct spatial_grid_s
+{
+    float cell_size;
+    float inverse_cell_size;
+
+    // Head entry of every bucket, bucket_count is a power of two
+    int32_t* buckets;
+    uint32_t bucket_count;
+
+    spatial_entry_t* entries;
+    int32_t entry_count;
+    int32_t entry_capacity;
+    int32_t free_entry;
+    int32_t live_count;
+
+    // key = instance, value = entry index
+    HASHMAP(p_instance_t, int32_t) entry_lookup;
+
+    // Largest half extents of every box, queries are widened by them
+    float max_half_width;
+    float max_half_height;
+
+    // Cells holding at least one entry, bounds the nearest search
+    int32_t min_cell_x;
+    int32_t min_cell_y;
+    int32_t max_cell_x;
+    int32_t max_cell_y;
+
+    uint32_t generation;
+};
+
+int sg_create(float, spatial_grid_t*);
+int sg_update(spatial_grid_t*, const instance_snapshot_t*);
+int sg_query_rect(const spatial_grid_t*, yyrect_t, instance_t**, size_t, size_t*);
+int sg_query_radius(const spatial_grid_t*, float, float, float, instance_t**, size_t, size_t*);
+int sg_query_nearest(const spatial_grid_t*, float, float, size_t, instance_t**, float*, size_t*);
+int sg_destroy(spatial_grid_t*);
+
+#endif  /* !SPATIAL_H_ */
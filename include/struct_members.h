@@ -0,0 +1,24 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef STRUCT_MEMBERS_H_
+#define STRUCT_MEMBERS_H_
+
+#include <stdint.h>
+#include "utils.h"
+#include "gml_structs.h"
+
+typedef struct member_entry_s member_entry_t;
+
+// One variable of a struct or instance, the slot is the runner-wide handle of its name
+struct member_entry_s
+{
+    int32_t slot;
+    rvalue_t* value;
+};
+
+int sm_count_members(const yyobject_base_t*, size_t*);
+int sm_get_members(const yyobject_base_t*, member_entry_t*, size_t, size_t*);
+
+#endif  /* !STRUCT_MEMBERS_H_ */
@@ -9,25 +9,77 @@
 #include <string.h>
 #include <limits.h>
 #include <stdlib.h>
-#include <Windows.h>
 #include <stdbool.h>
 #include "utils_macro.h"
 
-typedef struct directory_iterator_s directory_iterator_t;
-typedef struct directory_stack_node_s directory_stack_node_t;
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#endif
+
+// Deepest folder level a walker can enter, below the root
+#define WALKER_MAX_DEPTH 32
+#define WALKER_PATH_CAPACITY 4096
+
+typedef struct directory_walker_s directory_walker_t;
+typedef struct perfect_hash_s perfect_hash_t;
+typedef struct file_identity_s file_identity_t;
+typedef struct phase_timer_s phase_timer_t;
+
+// Walks a folder tree depth first, one file at a time.
+// The path of the current file is built in place in a single buffer,
+// nothing is allocated once the walker is open.
+struct directory_walker_s {
+    // Full path of the current file, valid until the next call to walker_next
+    char path[WALKER_PATH_CAPACITY];
+    size_t path_length;
+    // File name part of path
+    const char* name;
+
+    // Only files ending with it are yielded, compared without case, NULL for every file
+    const char* extension;
+    size_t extension_length;
+
+    // 0 only lists the root folder
+    uint32_t max_depth;
+    // Number of folders currently open, the last one is read
+    uint32_t open_count;
+    // Length of the path of each open folder, separator included
+    size_t folder_lengths[WALKER_MAX_DEPTH + 1];
+#ifdef _WIN32
+    HANDLE handles[WALKER_MAX_DEPTH + 1];
+    WIN32_FIND_DATAA find_data;
+    // FindFirstFile already returned an entry that hasn't been looked at
+    bool has_pending_entry;
+#else
+    DIR* handles[WALKER_MAX_DEPTH + 1];
+#endif
+};
+
+// Minimal perfect hash over a fixed set of strings.
+// Keys are spread into buckets with hash_key_str, then every bucket stores
+// the seed that sends all its keys to distinct slots in [0, slot_count).
+// A lookup always lands on a slot, callers have to compare the stored key.
+struct perfect_hash_s {
+    uint32_t* displacements;
+    uint32_t bucket_count;
+    uint32_t slot_count;
+};
 
-struct directory_stack_node_s {
-    HANDLE find_handle;
-    char* path;
-    directory_stack_node_t* next;
+// Identifies a file whatever the path used to reach it
+struct file_identity_s {
+    uint32_t volume_serial;
+    uint64_t file_index;
 };
 
-struct directory_iterator_s {
-    HANDLE find_handle;
-    WIN32_FIND_DATA find_data;
-    char* current_path;
-    char* pattern;
-    directory_stack_node_t* stack;  // For managing directory hierarchy
+// Time spent in a phase, summed over its runs.
+// Starting it again while it runs only counts once, nested calls don't add up twice.
+struct phase_timer_s {
+    uint64_t total_us;
+    uint64_t runs;
+    uint64_t started_us;
+    uint32_t depth;
 };
 
 typedef uint32_t hash_t;
@@ -51,16 +103,22 @@ typedef struct SS_CAT_UND(hm, K, V, s) {        \
 	void(*delete_value)(K* key, V* value);      \
 } HASHMAP(K, V);
 
+#define HASHMAP_DEFAULT_SIZE 16
+
 #define GET_CONTAINER(K, V) S_CAT_UND(get_container, K, V)
 #define _GET_CONTAINER(K, V)                                                                        \
 int GET_CONTAINER(K, V)(HASHMAP(K, V)* hashmap, K key, HASHMAP_ELMT(K, V)* value)                   \
 {                                                                                                   \
+    if (!hashmap->elements) return MSL_OBJECT_NOT_IN_LIST;                                          \
     hash_t value_hash = HASH_KEY(K)(key);                                                           \
+    if (value_hash == 0) value_hash = 1; /* Same remapping as INSERT */                             \
     int32_t ideal_position = (int)(value_hash & hashmap->current_mask);                             \
-    for (HASHMAP_ELMT(K, V) current_element = hashmap->elements[ideal_position];                    \
-        current_element.hash != 0;                                                                  \
-        current_element = hashmap->elements[(++ideal_position) & hashmap->current_mask]) {          \
-        if (current_element.key != key) continue;                                                   \
+    /* A full map has no empty slot to stop on, never probe more than its size */                  \
+    for (int32_t probed = 0; probed < hashmap->current_size; probed++) {                            \
+        HASHMAP_ELMT(K, V) current_element = hashmap->elements[ideal_position];                     \
+        if (current_element.hash == 0) break;                                                       \
+        ideal_position = (ideal_position + 1) & hashmap->current_mask;                              \
+        if (!KEY_EQUAL(K)(current_element.key, key)) continue;                                      \
         *value = current_element;                                                                   \
         return MSL_SUCCESS;                                                                         \
     }                                                                                               \
@@ -71,21 +129,43 @@ int GET_CONTAINER(K, V)(HASHMAP(K, V)* hashmap, K key, HASHMAP_ELMT(K, V)* value
 #define _GET_VALUE(K, V)                                                                    \
 int GET_VALUE(K, V)(HASHMAP(K, V)* hashmap, K key, V* value)                                \
 {                                                                                           \
-    HASHMAP_ELMT(K, V)* object_container = NULL;                                            \
-    if (GET_CONTAINER(K, V)(hashmap, key, object_container) == MSL_OBJECT_NOT_IN_LIST)      \
+    HASHMAP_ELMT(K, V) object_container;                                                    \
+    if (GET_CONTAINER(K, V)(hashmap, key, &object_container) == MSL_OBJECT_NOT_IN_LIST)     \
         return MSL_OBJECT_NOT_IN_LIST;                                                      \
-    *value = object_container->value;                                                       \
+    *value = object_container.value;                                                        \
     return MSL_SUCCESS;                                                                     \
 }
 
+#define INIT_HASHMAP(K, V) SS_CAT_UND(init, hm, K, V)
+#define _INIT_HASHMAP(K, V)                                                                     \
+int INIT_HASHMAP(K, V)(HASHMAP(K, V)* hashmap, int32_t size)                                    \
+{                                                                                               \
+    /* The mask only works with a power of two */                                               \
+    int32_t new_size = HASHMAP_DEFAULT_SIZE;                                                    \
+    while (new_size < size) new_size *= 2;                                                      \
+    hashmap->elements = calloc(new_size, sizeof(HASHMAP_ELMT(K, V)));                           \
+    if (!hashmap->elements) return MSL_ALLOCATION_ERROR;                                        \
+    hashmap->current_size = new_size;                                                           \
+    hashmap->current_mask = new_size - 1;                                                       \
+    hashmap->used_count = 0;                                                                    \
+    hashmap->grow_threshold = (new_size * 3) / 4; /* 75% load factor */                         \
+    return MSL_SUCCESS;                                                                         \
+}
+
 #define INSERT(K, V) S_CAT_UND(insert, K, V)
 #define _INSERT(K, V)                                                                                           \
 int INSERT(K, V)(HASHMAP(K, V)* hashmap, K key, V value)                                                        \
 {                                                                                                               \
+    int status = MSL_SUCCESS;                                                                                   \
+    /* Maps owned by us start zeroed, allocate them on the first insertion */                                  \
+    if (!hashmap->elements) {                                                                                   \
+        status = INIT_HASHMAP(K, V)(hashmap, HASHMAP_DEFAULT_SIZE);                                             \
+        if (status) return status;                                                                              \
+    }                                                                                                           \
     /* Check if we need to grow the hashmap */                                                                  \
     if (hashmap->used_count >= hashmap->grow_threshold) {                                                       \
-        /* TODO: Implement grow function if needed */                                                           \
-        return MSL_INSUFFICIENT_MEMORY;                                                                         \
+        status = GROW(K, V)(hashmap);                                                                           \
+        if (status) return status;                                                                              \
     }                                                                                                           \
     hash_t value_hash = HASH_KEY(K)(key);                                                                       \
     if (value_hash == 0) value_hash = 1; /* Reserve 0 for empty slots */                                        \
@@ -94,11 +174,12 @@ int INSERT(K, V)(HASHMAP(K, V)* hashmap, K key, V value)
     /* Find a slot using linear probing */                                                                      \
     while (hashmap->elements[position].hash != 0) {                                                             \
         /* Check if key already exists */                                                                       \
-        if (hashmap->elements[position].key == key) {                                                           \
+        if (KEY_EQUAL(K)(hashmap->elements[position].key, key)) {                                               \
             /* Handle value replacement */                                                                      \
             if (hashmap->delete_value) {                                                                        \
                 hashmap->delete_value(&hashmap->elements[position].key, &hashmap->elements[position].value);    \
             }                                                                                                   \
+            hashmap->elements[position].key = key;                                                              \
             hashmap->elements[position].value = value;                                                          \
             return MSL_SUCCESS;                                                                                 \
         }                                                                                                       \
@@ -141,6 +222,68 @@ int GROW(K, V)(HASHMAP(K, V)* hashmap)
     return MSL_SUCCESS;                                                                         \
 }
 
+#define CLEAR_HASHMAP(K, V) SS_CAT_UND(clear, hm, K, V)
+#define _CLEAR_HASHMAP(K, V)                                                                    \
+int CLEAR_HASHMAP(K, V)(HASHMAP(K, V)* hashmap)                                                 \
+{                                                                                               \
+    if (!hashmap->elements) return MSL_SUCCESS;                                                 \
+    for (int32_t i = 0; i < hashmap->current_size; i++) {                                       \
+        if (hashmap->elements[i].hash != 0 && hashmap->delete_value) {                          \
+            hashmap->delete_value(&hashmap->elements[i].key, &hashmap->elements[i].value);      \
+        }                                                                                       \
+    }                                                                                           \
+    memset(hashmap->elements, 0, hashmap->current_size * sizeof(HASHMAP_ELMT(K, V)));           \
+    hashmap->used_count = 0;                                                                    \
+    return MSL_SUCCESS;                                                                         \
+}
+
+#define REMOVE(K, V) S_CAT_UND(remove, K, V)
+#define _REMOVE(K, V)                                                                           \
+int REMOVE(K, V)(HASHMAP(K, V)* hashmap, K key)                                                 \
+{                                                                                               \
+    if (!hashmap->elements) return MSL_OBJECT_NOT_IN_LIST;                                      \
+    hash_t value_hash = HASH_KEY(K)(key);                                                       \
+    if (value_hash == 0) value_hash = 1; /* Same remapping as INSERT */                         \
+    int32_t position = (int)(value_hash & hashmap->current_mask);                               \
+    int32_t probed = 0;                                                                         \
+    for (; probed < hashmap->current_size; probed++) {                                          \
+        if (hashmap->elements[position].hash == 0) return MSL_OBJECT_NOT_IN_LIST;               \
+        if (KEY_EQUAL(K)(hashmap->elements[position].key, key)) break;                          \
+        position = (position + 1) & hashmap->current_mask;                                      \
+    }                                                                                           \
+    if (probed == hashmap->current_size) return MSL_OBJECT_NOT_IN_LIST;                         \
+    if (hashmap->delete_value) {                                                                \
+        hashmap->delete_value(&hashmap->elements[position].key, &hashmap->elements[position].value); \
+    }                                                                                           \
+    /* Backward shift, so the probing of the following elements never stops on the hole */     \
+    int32_t hole = position;                                                                    \
+    int32_t next = (position + 1) & hashmap->current_mask;                                      \
+    while (hashmap->elements[next].hash != 0) {                                                 \
+        int32_t ideal_position = (int)(hashmap->elements[next].hash & hashmap->current_mask);   \
+        if (((next - ideal_position) & hashmap->current_mask) >= ((next - hole) & hashmap->current_mask)) { \
+            hashmap->elements[hole] = hashmap->elements[next];                                  \
+            hole = next;                                                                        \
+        }                                                                                       \
+        next = (next + 1) & hashmap->current_mask;                                              \
+    }                                                                                           \
+    memset(&hashmap->elements[hole], 0, sizeof(HASHMAP_ELMT(K, V)));                            \
+    hashmap->used_count--;                                                                      \
+    return MSL_SUCCESS;                                                                         \
+}
+
+#define DESTROY_HASHMAP(K, V) SS_CAT_UND(destroy, hm, K, V)
+#define _DESTROY_HASHMAP(K, V)                                                                  \
+int DESTROY_HASHMAP(K, V)(HASHMAP(K, V)* hashmap)                                               \
+{                                                                                               \
+    CLEAR_HASHMAP(K, V)(hashmap);                                                               \
+    free(hashmap->elements);                                                                    \
+    hashmap->elements = NULL;                                                                   \
+    hashmap->current_size = 0;                                                                  \
+    hashmap->current_mask = 0;                                                                  \
+    hashmap->grow_threshold = 0;                                                                \
+    return MSL_SUCCESS;                                                                         \
+}
+
 #define DEF_HASHMAP(K, V)   \
     _HASHMAP_ELMT(K, V)     \
     _HASHMAP(K, V)          \
@@ -148,14 +291,23 @@ int GROW(K, V)(HASHMAP(K, V)* hashmap)
 #define DEF_FUNC_HASH(K, V) \
     int GET_CONTAINER(K, V)(HASHMAP(K, V)*, K, HASHMAP_ELMT(K, V)*);  \
     int GET_VALUE(K, V)(HASHMAP(K, V)*, K, V*);                       \
+    int INIT_HASHMAP(K, V)(HASHMAP(K, V)*, int32_t);                  \
     int INSERT(K, V)(HASHMAP(K, V)*, K, V);                           \
-    int GROW(K, V)(HASHMAP(K, V)*);   
-
-#define FUNC_HASH(K, V) \
-    _GET_CONTAINER(K, V) \
-    _GET_VALUE(K, V)     \
-    _INSERT(K, V)        \
-    _GROW(K, V)   
+    int GROW(K, V)(HASHMAP(K, V)*);                                   \
+    int CLEAR_HASHMAP(K, V)(HASHMAP(K, V)*);                          \
+    int REMOVE(K, V)(HASHMAP(K, V)*, K);                              \
+    int DESTROY_HASHMAP(K, V)(HASHMAP(K, V)*);
+
+#define FUNC_HASH(K, V)     \
+    _GET_CONTAINER(K, V)    \
+    _GET_VALUE(K, V)        \
+    _INIT_HASHMAP(K, V)     \
+    int GROW(K, V)(HASHMAP(K, V)*); \
+    _INSERT(K, V)           \
+    _GROW(K, V)             \
+    _CLEAR_HASHMAP(K, V)    \
+    _REMOVE(K, V)           \
+    _DESTROY_HASHMAP(K, V)
 
 #define LINKEDLIST(T) S_CAT_UND(ll, T, t)
 #define _LINKEDLIST(T)                  \
@@ -287,43 +439,37 @@ int ADD_VECTOR(T)(VECTOR(T)* vec, T* elmt) {        \
 #define REMOVE_VECTOR(T) S_CAT_UND(remove, vec, T)
 #define _REMOVE_VECTOR(T)                           \
 int REMOVE_VECTOR(T)(VECTOR(T)* vec, T* elmt, void (*destructor)(T*)) {     \
-	size_t new_size = vec->size;                    \
-    for(size_t i = 0; i < vec->size; ) {            \
-        if (&vec->arr[i] == elmt) {                 \
-            vec->arr[i] = vec->arr[new_size - 1];   \
-            if (destructor != NULL) {               \
-                destructor(&vec->arr[new_size - 1]);\
-            }                                       \
-            new_size--;                             \
-            if (!new_size) break;                   \
-        } else {                                    \
-            i++;                                    \
+    /* elmt is an address in the vector, it can only match once */          \
+    for(size_t i = 0; i < vec->size; i++) {         \
+        if (&vec->arr[i] != elmt) continue;         \
+        if (destructor != NULL) {                   \
+            destructor(&vec->arr[i]);               \
         }                                           \
+        vec->arr[i] = vec->arr[vec->size - 1];      \
+        vec->size--;                                \
+        break;                                      \
     }                                               \
-    vec->size = new_size;                           \
 	return MSL_SUCCESS;                             \
 }
 
 #define REMOVE_VECTOR_IF(T) S_CAT_UND(removeif, vec, T)
 #define _REMOVE_VECTOR_IF(T)                        \
 int REMOVE_VECTOR_IF(T)(VECTOR(T)* vec, int (*predicate)(T*, void*, bool*), void* context, void (*destructor)(T*)) {     \
-	size_t new_size = vec->size;                    \
 	int last_status = MSL_SUCCESS;                  \
 	bool flag;                                      \
+    /* The moved element is checked next, the ones past size are stale copies */  \
     for(size_t i = 0; i < vec->size; ) {            \
         CHECK_CALL(predicate, &vec->arr[i], context, &flag);  \
         if (flag) {                                 \
-            vec->arr[i] = vec->arr[new_size - 1];   \
             if (destructor != NULL) {               \
-                destructor(&vec->arr[new_size - 1]);\
+                destructor(&vec->arr[i]);           \
             }                                       \
-            new_size--;                             \
-            if (!new_size) break;                   \
+            vec->arr[i] = vec->arr[vec->size - 1];  \
+            vec->size--;                            \
         } else {                                    \
             i++;                                    \
         }                                           \
     }                                               \
-    vec->size = new_size;                           \
 	return last_status;                             \
 }
 
@@ -362,21 +508,45 @@ int SORT_VECTOR(T)(VECTOR(T)* vec, int(*comparator)(const void *, const void *))
 #define HASH_KEY_str hash_key_str
 #define HASH_KEY_int hash_key_int
 #define HASH_KEY_int32_t hash_key_int
+#define HASH_KEY_file_identity_t hash_key_file_identity
+
+#define KEY_EQUAL(K) CAT_UND(KEY_EQUAL, K)
+#define KEY_EQUAL_str(A, B) (!strcmp((A), (B)))
+#define KEY_EQUAL_int(A, B) ((A) == (B))
+#define KEY_EQUAL_int32_t(A, B) ((A) == (B))
+#define KEY_EQUAL_file_identity_t(A, B) ((A).volume_serial == (B).volume_serial && (A).file_index == (B).file_index)
+
+typedef const char* str;
 
-int iterator_create_alloc(const char*, const char*, directory_iterator_t**);
-int iterator_next(directory_iterator_t*);
-int iterator_enter_directory_alloc(directory_iterator_t*);
-int iterator_destroy(directory_iterator_t*);
+DEF_HASHMAP(str, int32_t)
+DEF_FUNC_HASH(str, int32_t)
+
+int walker_open(const char*, const char*, uint32_t, directory_walker_t*);
+int walker_next(directory_walker_t*, bool*);
+int walker_close(directory_walker_t*);
 int has_parent_path(const char*, bool*);
 int parent_path_alloc(const char*, char**);
-int paths_are_equivalent(const char*, const char*, int*);
-int is_regular_file(const char*, bool*);
 int has_filename(const char*, bool*);
 int filename_alloc(const char*, char**);
 int has_extension(const char*, bool*);
 int extension(const char*, char**);
+#ifdef _WIN32
+// These ask Windows about the file system
+int paths_are_equivalent(const char*, const char*, int*);
+int canonical_path(const char*, char*, size_t, size_t*);
+int get_file_identity(const char*, file_identity_t*);
+int is_regular_file(const char*, bool*);
 int compare(const char*, const char*, int*);
+#endif
 hash_t hash_key_int(int);
 hash_t hash_key_ptr(void*);
 hash_t hash_key_str(const char*);
+hash_t hash_key_str_seed(const char*, uint32_t);
+hash_t hash_key_file_identity(file_identity_t);
+int perfect_hash_build_alloc(const char**, uint32_t, perfect_hash_t*, uint32_t*);
+int perfect_hash_lookup(const perfect_hash_t*, const char*, uint32_t*);
+int perfect_hash_destroy(perfect_hash_t*);
+uint64_t time_now_us(void);
+void timer_start(phase_timer_t*);
+void timer_stop(phase_timer_t*);
 #endif  /* !UTILS_H_ */
\ No newline at end of file
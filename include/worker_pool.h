@@ -0,0 +1,33 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <stdint.h>
+#include "utils.h"
+
+#ifdef _WIN32
+// Upper bound of the threads of one run, WaitForMultipleObjects can't wait on more
+#define WORKER_POOL_MAX_THREADS MAXIMUM_WAIT_OBJECTS
+#else
+// Elsewhere every item runs on the calling thread
+#define WORKER_POOL_MAX_THREADS 1
+#endif
+
+typedef struct worker_pool_job_s worker_pool_job_t;
+
+// Items are handed out one at a time, whoever is free takes the next one
+struct worker_pool_job_s
+{
+    void(*task)(void* context, size_t index);
+    void* context;
+    size_t count;
+    volatile long next;
+};
+
+int wp_get_thread_count(size_t, uint32_t*);
+int wp_run(size_t, uint32_t, void(*)(void*, size_t), void*);
+
+#endif  /* !WORKER_POOL_H_ */
@@ -24,24 +24,18 @@ int save_game(FWCodeEvent* code_event)
 
     if (strstr(code->name, "gml_Object_o_player_KeyPress_116") != NULL)
     {
-        rvalue_t scr_smoothSaveAuto;
-        rvalue_t scr_actionsLogUpdate;
-        rvalue_t arg_smoothSaveAuto = init_rvalue_str("scr_smoothSaveAuto");
-        rvalue_t arg_actionsLogUpdate = init_rvalue_str("scr_actionsLogUpdate");
-        rvalue_t arg_message = init_rvalue_str("You Save Game (Can I play, Daddy?)");
+        builtin_arguments_t args;
 
-        rvalue_t args[2] = { arg_smoothSaveAuto };
-        CHECK_CALL(global_interface->call_builtin, "asset_get_index", args, 1, &scr_smoothSaveAuto);
+        // Script names are resolved once and cached, no asset_get_index nor script_execute round trip
+        CHECK_CALL(global_interface->call_script, "scr_smoothSaveAuto", NULL, NULL, NULL, 0, NULL);
 
-        args[0] = scr_smoothSaveAuto;
-        CHECK_CALL(global_interface->call_builtin, "script_execute", args, 1, NULL);
+        CHECK_CALL(builtin_arguments_init, &args);
+        CHECK_CALL(builtin_arguments_push_str, &args, "You Save Game (Can I play, Daddy?)");
 
-        args[0] = arg_actionsLogUpdate;
-        CHECK_CALL(global_interface->call_builtin, "asset_get_index", args, 1, &scr_actionsLogUpdate);
-
-        args[0] = scr_actionsLogUpdate;
-        args[1] = arg_message;
-        CHECK_CALL(global_interface->call_builtin, "script_execute", args, 2, NULL);
+        // The message is a runner string, released whether the script ran or not
+        int call_status = LOG_ON_ERR(global_interface->call_script, "scr_actionsLogUpdate", NULL, NULL, args.values, args.count, NULL);
+        CHECK_CALL(builtin_arguments_release, &args);
+        if (call_status) return call_status;
     }
 
     CHECK_CALL(code_event->Call);
@@ -53,8 +47,8 @@ int module_initialize(module_t* module, const char* module_path)
     UNREFERENCED_PARAMETER(module_path);
     int last_status = MSL_SUCCESS;
     CHECK_CALL_CUSTOM_ERROR(ob_get_interface, MSL_MODULE_DEPENDENCY_NOT_RESOLVED, "YYTK_Main", (interface_base_t**)(&global_interface));
-
     CHECK_CALL(global_interface->print_warning, "Hello Mod");
+
     CHECK_CALL(global_interface->create_callback, module, EVENT_OBJECT_CALL, save_game, 0);
 
     return last_status;
@@ -0,0 +1,282 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include "../include/builtin_table.h"
+#include "../include/error.h"
+
+static int bt_read_function_entry(rfunction_t* functions, size_t entry_size, size_t index, const char** name, size_t* name_length, TRoutine* routine, int32_t* argument_count)
+{
+    if (entry_size == sizeof(rfunction_string_ref_t))
+    {
+        rfunction_string_ref_t* function_entry = (rfunction_string_ref_t*)((char*)(functions) + entry_size * index);
+
+        *name = function_entry->name;
+        *name_length = function_entry->name ? strlen(function_entry->name) : 0;
+        *routine = function_entry->routine;
+        *argument_count = function_entry->argument_count;
+        return MSL_SUCCESS;
+    }
+
+    if (entry_size == sizeof(rfunction_string_full_t))
+    {
+        rfunction_string_full_t* function_entry = (rfunction_string_full_t*)((char*)(functions) + entry_size * index);
+
+        // The inline name isn't null-terminated when it uses all 64 chars
+        *name = function_entry->name;
+        *name_length = strnlen(function_entry->name, sizeof(function_entry->name));
+        *routine = function_entry->routine;
+        *argument_count = function_entry->argument_count;
+        return MSL_SUCCESS;
+    }
+
+    return MSL_INVALID_PARAMETER;
+}
+
+// The runner doesn't export the size of the functions array,
+// the array ends with the first entry that has no name or no routine.
+int bt_count_function_entries(rfunction_t* functions, size_t entry_size, size_t* count)
+{
+    int last_status = MSL_SUCCESS;
+    *count = 0;
+    if (!functions) return MSL_NULL_BUFFER;
+
+    const char* name = NULL;
+    size_t name_length = 0;
+    TRoutine routine = NULL;
+    int32_t argument_count = 0;
+
+    for (size_t i = 0; i < BUILTIN_FUNCTION_INDEX_LIMIT; i++)
+    {
+        CHECK_CALL(bt_read_function_entry, functions, entry_size, i, &name, &name_length, &routine, &argument_count);
+        if (!name_length || !routine) break;
+        (*count)++;
+    }
+
+    return last_status;
+}
+
+int bt_build_function_table_alloc(rfunction_t* functions, size_t entry_size, size_t count, builtin_function_table_t* table)
+{
+    int last_status = MSL_SUCCESS;
+    const char** names = NULL;
+    uint32_t* slots = NULL;
+    size_t* name_offsets = NULL;
+
+    table->entries = NULL;
+    table->entry_count = 0;
+    table->name_arena = NULL;
+    table->name_hash.displacements = NULL;
+    table->name_hash.bucket_count = 0;
+    table->name_hash.slot_count = 0;
+
+    if (!functions) return MSL_NULL_BUFFER;
+    if (count > BUILTIN_FUNCTION_INDEX_LIMIT) return MSL_INVALID_PARAMETER;
+    if (!count) return MSL_SUCCESS;
+
+    const char* name = NULL;
+    size_t name_length = 0;
+    TRoutine routine = NULL;
+    int32_t argument_count = 0;
+
+    // First pass, size the arena so every name gets copied in one allocation
+    size_t arena_size = 0;
+    name_offsets = (size_t*)malloc(sizeof(size_t) * count);
+    if (!name_offsets)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK_CALL_GOTO_ERROR(bt_read_function_entry, cleanup, functions, entry_size, i, &name, &name_length, &routine, &argument_count);
+        name_offsets[i] = arena_size;
+        arena_size += name_length + 1;
+    }
+
+    table->name_arena = (char*)malloc(arena_size);
+    names = (const char**)malloc(sizeof(const char*) * count);
+    slots = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    if (!table->name_arena || !names || !slots)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK_CALL_GOTO_ERROR(bt_read_function_entry, cleanup, functions, entry_size, i, &name, &name_length, &routine, &argument_count);
+        memcpy(&table->name_arena[name_offsets[i]], name, name_length);
+        table->name_arena[name_offsets[i] + name_length] = '\0';
+        names[i] = &table->name_arena[name_offsets[i]];
+    }
+
+    CHECK_CALL_GOTO_ERROR(perfect_hash_build_alloc, cleanup, names, (uint32_t)count, &table->name_hash, slots);
+
+    table->entry_count = table->name_hash.slot_count;
+    table->entries = (builtin_function_entry_t*)calloc(table->entry_count, sizeof(builtin_function_entry_t));
+    if (!table->entries)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        // Duplicated names keep the first index, like Code_Function_Find does
+        if (table->entries[slots[i]].name) continue;
+
+        CHECK_CALL_GOTO_ERROR(bt_read_function_entry, cleanup, functions, entry_size, i, &name, &name_length, &routine, &argument_count);
+        table->entries[slots[i]].name = names[i];
+        table->entries[slots[i]].routine = routine;
+        table->entries[slots[i]].argument_count = argument_count;
+        table->entries[slots[i]].index = (int32_t)i;
+    }
+
+    ret:
+    free(name_offsets);
+    free(names);
+    free(slots);
+    return last_status;
+
+    cleanup:
+    bt_destroy_function_table(table);
+    goto ret;
+}
+
+int bt_lookup_function(const builtin_function_table_t* table, const char* function_name, int32_t* function_id)
+{
+    uint32_t slot = 0;
+    if (perfect_hash_lookup(&table->name_hash, function_name, &slot)) return MSL_OBJECT_NOT_IN_LIST;
+
+    // The perfect hash only knows the indexed names, anything else lands on a random slot
+    if (strcmp(table->entries[slot].name, function_name)) return MSL_OBJECT_NOT_IN_LIST;
+
+    *function_id = (int32_t)slot;
+    return MSL_SUCCESS;
+}
+
+int bt_get_function_entry(const builtin_function_table_t* table, int32_t function_id, builtin_function_entry_t** entry)
+{
+    if (function_id < 0 || (uint32_t)function_id >= table->entry_count) return MSL_INVALID_PARAMETER;
+
+    *entry = &table->entries[function_id];
+    return MSL_SUCCESS;
+}
+
+int bt_destroy_function_table(builtin_function_table_t* table)
+{
+    int last_status = MSL_SUCCESS;
+    if (!table) return MSL_NULL_BUFFER;
+
+    CHECK_CALL(perfect_hash_destroy, &table->name_hash);
+
+    free(table->entries);
+    free(table->name_arena);
+    table->entries = NULL;
+    table->name_arena = NULL;
+    table->entry_count = 0;
+    return last_status;
+}
+
+int bt_build_variable_table_alloc(rvariable_routine_t* variables, size_t count, builtin_variable_table_t* table)
+{
+    int last_status = MSL_SUCCESS;
+    const char** names = NULL;
+    uint32_t* slots = NULL;
+
+    table->slot_indices = NULL;
+    table->variables = variables;
+    table->variable_count = 0;
+    table->name_hash.displacements = NULL;
+    table->name_hash.bucket_count = 0;
+    table->name_hash.slot_count = 0;
+
+    if (!variables) return MSL_NULL_BUFFER;
+    if (!count) return MSL_SUCCESS;
+
+    // The names live in the runner .rdata section, no need to copy them
+    names = (const char**)malloc(sizeof(const char*) * count);
+    slots = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    if (!names || !slots)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!variables[i].name)
+        {
+            last_status = MSL_INVALID_PARAMETER;
+            goto cleanup;
+        }
+        names[i] = variables[i].name;
+    }
+
+    CHECK_CALL_GOTO_ERROR(perfect_hash_build_alloc, cleanup, names, (uint32_t)count, &table->name_hash, slots);
+
+    table->slot_indices = (int32_t*)malloc(sizeof(int32_t) * table->name_hash.slot_count);
+    if (!table->slot_indices)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < table->name_hash.slot_count; i++)
+        table->slot_indices[i] = -1;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        // Duplicated names keep the first index
+        if (table->slot_indices[slots[i]] != -1) continue;
+        table->slot_indices[slots[i]] = (int32_t)i;
+    }
+
+    table->variable_count = (uint32_t)count;
+
+    ret:
+    free(names);
+    free(slots);
+    return last_status;
+
+    cleanup:
+    bt_destroy_variable_table(table);
+    goto ret;
+}
+
+int bt_lookup_variable(const builtin_variable_table_t* table, const char* variable_name, int32_t* variable_index)
+{
+    uint32_t slot = 0;
+    if (perfect_hash_lookup(&table->name_hash, variable_name, &slot)) return MSL_OBJECT_NOT_IN_LIST;
+
+    // Same as functions, a miss still lands on a slot
+    int32_t index = table->slot_indices[slot];
+    if (strcmp(table->variables[index].name, variable_name)) return MSL_OBJECT_NOT_IN_LIST;
+
+    *variable_index = index;
+    return MSL_SUCCESS;
+}
+
+int bt_get_variable_entry(const builtin_variable_table_t* table, int32_t variable_index, rvariable_routine_t** entry)
+{
+    if (variable_index < 0 || (uint32_t)variable_index >= table->variable_count) return MSL_INVALID_PARAMETER;
+
+    *entry = &table->variables[variable_index];
+    return MSL_SUCCESS;
+}
+
+int bt_destroy_variable_table(builtin_variable_table_t* table)
+{
+    int last_status = MSL_SUCCESS;
+    if (!table) return MSL_NULL_BUFFER;
+
+    CHECK_CALL(perfect_hash_destroy, &table->name_hash);
+
+    free(table->slot_indices);
+    table->slot_indices = NULL;
+    table->variables = NULL;
+    table->variable_count = 0;
+    return last_status;
+}
@@ -0,0 +1,212 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include "../include/ds_builder.h"
+#include "../include/error.h"
+
+// The runner only adds int64 and maps to lists, everything else goes through ds_list_add.
+// It takes the list then any number of values, so values are sent by batches.
+typedef struct ds_list_batch_s
+{
+    const yyrunner_interface_t* runner;
+    const builtin_handle_t* list_add;
+    rvalue_t arguments[BUILTIN_ARGUMENTS_CAPACITY];
+    // Strings created for the batch, released once the list has copied them
+    bool owned[BUILTIN_ARGUMENTS_CAPACITY];
+    size_t count;
+} ds_list_batch_t;
+
+static int db_flush_list_batch(ds_list_batch_t* batch)
+{
+    // Only the list itself
+    if (batch->count <= 1) return MSL_SUCCESS;
+
+    rvalue_t result;
+    result.real = 0;
+    result.flags = 0;
+    result.kind = VALUE_UNDEFINED;
+    batch->list_add->routine(&result, NULL, NULL, (int)batch->count, batch->arguments);
+
+    for (size_t i = 1; i < batch->count; i++)
+    {
+        if (batch->owned[i])
+            batch->runner->FREE_rvalue_t(&batch->arguments[i]);
+    }
+
+    batch->count = 1;
+    return MSL_SUCCESS;
+}
+
+int db_create_map(const yyrunner_interface_t* runner, int32_t* map)
+{
+    if (!runner->CreateDsMap) return MSL_EXTERNAL_ERROR;
+
+    *map = runner->CreateDsMap(0);
+    return *map < 0 ? MSL_EXTERNAL_ERROR : MSL_SUCCESS;
+}
+
+int db_create_list(const yyrunner_interface_t* runner, int32_t* list)
+{
+    if (!runner->DsListCreate) return MSL_EXTERNAL_ERROR;
+
+    *list = runner->DsListCreate();
+    return *list < 0 ? MSL_EXTERNAL_ERROR : MSL_SUCCESS;
+}
+
+int db_map_add_reals(const yyrunner_interface_t* runner, int32_t map, const char* const* keys, const double* values, size_t count)
+{
+    if (!runner->DsMapAddDouble) return MSL_EXTERNAL_ERROR;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!runner->DsMapAddDouble(map, keys[i], values[i])) return MSL_EXTERNAL_ERROR;
+    }
+
+    return MSL_SUCCESS;
+}
+
+int db_map_add_strings(const yyrunner_interface_t* runner, int32_t map, const char* const* keys, const char* const* values, size_t count)
+{
+    if (!runner->DsMapAddString) return MSL_EXTERNAL_ERROR;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!runner->DsMapAddString(map, keys[i], values[i])) return MSL_EXTERNAL_ERROR;
+    }
+
+    return MSL_SUCCESS;
+}
+
+// Stops on the first value the runner refuses, the previous ones stay in the map
+int db_map_add_values(const yyrunner_interface_t* runner, int32_t map, const char* const* keys, const ds_value_t* values, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        bool added = true;
+
+        switch (values[i].type)
+        {
+        case DS_VALUE_REAL:
+            if (!runner->DsMapAddDouble) return MSL_EXTERNAL_ERROR;
+            added = runner->DsMapAddDouble(map, keys[i], values[i].real);
+            break;
+        case DS_VALUE_INT64:
+            if (!runner->DsMapAddInt64) return MSL_EXTERNAL_ERROR;
+            added = runner->DsMapAddInt64(map, keys[i], values[i].i64);
+            break;
+        case DS_VALUE_BOOL:
+            if (!runner->DsMapAddBool) return MSL_EXTERNAL_ERROR;
+            runner->DsMapAddBool(map, keys[i], values[i].boolean);
+            break;
+        case DS_VALUE_STRING:
+            if (!runner->DsMapAddString) return MSL_EXTERNAL_ERROR;
+            added = runner->DsMapAddString(map, keys[i], values[i].string);
+            break;
+        case DS_VALUE_LIST:
+            if (!runner->DsMapAddList) return MSL_EXTERNAL_ERROR;
+            runner->DsMapAddList(map, keys[i], values[i].index);
+            break;
+        case DS_VALUE_RVALUE:
+            if (!runner->DsMapAddrvalue_t) return MSL_EXTERNAL_ERROR;
+            runner->DsMapAddrvalue_t(map, keys[i], values[i].rvalue);
+            break;
+        // The runner can't mark a map inside a map, ds_map_add_map has to be used
+        case DS_VALUE_MAP:
+        default:
+            return MSL_INVALID_PARAMETER;
+        }
+
+        if (!added) return MSL_EXTERNAL_ERROR;
+    }
+
+    return MSL_SUCCESS;
+}
+
+// list_add is the resolved ds_list_add builtin, only needed for reals, bools, strings and rvalues.
+// Values are appended in order, stops on the first one that can't be added.
+int db_list_add_values(const yyrunner_interface_t* runner, const builtin_handle_t* list_add, int32_t list, const ds_value_t* values, size_t count)
+{
+    int last_status = MSL_SUCCESS;
+
+    ds_list_batch_t batch;
+    batch.runner = runner;
+    batch.list_add = list_add;
+    batch.arguments[0].real = (double)list;
+    batch.arguments[0].flags = 0;
+    batch.arguments[0].kind = VALUE_REAL;
+    batch.owned[0] = false;
+    batch.count = 1;
+
+    for (size_t i = 0; i < count && last_status == MSL_SUCCESS; i++)
+    {
+        DS_VALUE_TYPE type = values[i].type;
+
+        if (type == DS_VALUE_INT64 || type == DS_VALUE_MAP)
+        {
+            if ((type == DS_VALUE_INT64 && !runner->DsListAddInt64) || (type == DS_VALUE_MAP && !runner->DsListAddMap))
+            {
+                last_status = MSL_EXTERNAL_ERROR;
+                break;
+            }
+
+            // Keep the values in order
+            last_status = db_flush_list_batch(&batch);
+            if (last_status != MSL_SUCCESS) break;
+
+            if (type == DS_VALUE_INT64)
+                runner->DsListAddInt64(list, values[i].i64);
+            else
+                runner->DsListAddMap(list, values[i].index);
+            continue;
+        }
+
+        if (!list_add || !list_add->routine)
+        {
+            last_status = MSL_INVALID_PARAMETER;
+            break;
+        }
+
+        rvalue_t* argument = &batch.arguments[batch.count];
+        argument->flags = 0;
+        batch.owned[batch.count] = false;
+
+        switch (type)
+        {
+        case DS_VALUE_REAL:
+            argument->real = values[i].real;
+            argument->kind = VALUE_REAL;
+            break;
+        case DS_VALUE_BOOL:
+            argument->real = values[i].boolean ? 1.0 : 0.0;
+            argument->kind = VALUE_BOOL;
+            break;
+        case DS_VALUE_STRING:
+            if (!runner->YYCreateString || !runner->FREE_rvalue_t)
+            {
+                last_status = MSL_EXTERNAL_ERROR;
+                continue;
+            }
+            runner->YYCreateString(argument, values[i].string);
+            batch.owned[batch.count] = true;
+            break;
+        case DS_VALUE_RVALUE:
+            // Borrowed, the list takes its own reference
+            *argument = *values[i].rvalue;
+            break;
+        // The runner can't mark a list inside a list, ds_list_mark_as_list has to be used
+        case DS_VALUE_LIST:
+        default:
+            last_status = MSL_INVALID_PARAMETER;
+            continue;
+        }
+
+        batch.count++;
+        if (batch.count == BUILTIN_ARGUMENTS_CAPACITY)
+            last_status = db_flush_list_batch(&batch);
+    }
+
+    // Whatever was gathered before a failure is still added
+    int flush_status = db_flush_list_batch(&batch);
+    return last_status != MSL_SUCCESS ? last_status : flush_status;
+}
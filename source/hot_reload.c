@@ -0,0 +1,338 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <ctype.h>
+#include "../include/hot_reload.h"
+#include "../include/error.h"
+
+#ifdef _WIN32
+#include "../include/module.h"
+#else
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#ifdef _WIN32
+#define HOT_RELOAD_SEPARATOR '\\'
+#else
+#define HOT_RELOAD_SEPARATOR '/'
+#endif
+
+static uint64_t hr_now_ms(void)
+{
+#ifdef _WIN32
+    return GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+#endif
+}
+
+static bool hr_has_extension(const char* name, size_t name_length)
+{
+    size_t extension_length = sizeof(HOT_RELOAD_EXTENSION) - 1;
+    if (name_length < extension_length) return false;
+
+    const char* extension = name + name_length - extension_length;
+    for (size_t i = 0; i < extension_length; i++)
+    {
+        if (tolower((unsigned char)extension[i]) != HOT_RELOAD_EXTENSION[i]) return false;
+    }
+
+    return true;
+}
+
+// Changes to the same file are merged, only the last one counts for settling
+static void hr_note_change(hot_reload_watcher_t* watcher, const char* name, size_t name_length, uint64_t now)
+{
+    if (name_length >= HOT_RELOAD_NAME_CAPACITY || !hr_has_extension(name, name_length)) return;
+
+    for (size_t i = 0; i < watcher->pending_count; i++)
+    {
+        hot_reload_pending_t* pending = &watcher->pending[i];
+        if (!strncmp(pending->name, name, name_length) && !pending->name[name_length])
+        {
+            pending->last_change_ms = now;
+            return;
+        }
+    }
+
+    if (watcher->pending_count == HOT_RELOAD_MAX_PENDING) return;
+
+    hot_reload_pending_t* pending = &watcher->pending[watcher->pending_count++];
+    memcpy(pending->name, name, name_length);
+    pending->name[name_length] = 0;
+    pending->last_change_ms = now;
+}
+
+#ifdef _WIN32
+static int hr_start_read(hot_reload_watcher_t* watcher)
+{
+    ResetEvent(watcher->overlapped.hEvent);
+    watcher->read_pending = ReadDirectoryChangesW(
+        watcher->directory,
+        watcher->events,
+        sizeof(watcher->events),
+        FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+        NULL,
+        &watcher->overlapped,
+        NULL
+    );
+
+    return watcher->read_pending ? MSL_SUCCESS : MSL_EXTERNAL_ERROR;
+}
+#endif
+
+// Never blocks, only takes what the system already queued
+static int hr_read_events(hot_reload_watcher_t* watcher)
+{
+    int last_status = MSL_SUCCESS;
+    uint64_t now = hr_now_ms();
+
+#ifdef _WIN32
+    DWORD size = 0;
+    if (!GetOverlappedResult(watcher->directory, &watcher->overlapped, &size, FALSE))
+    {
+        if (GetLastError() == ERROR_IO_INCOMPLETE) return MSL_SUCCESS;
+
+        // The read failed, start a new one
+        CHECK_CALL(hr_start_read, watcher);
+        return last_status;
+    }
+
+    // A size of 0 means the buffer overflowed, the changes are lost
+    char name[HOT_RELOAD_NAME_CAPACITY];
+    const char* event = (const char*)watcher->events;
+    while (size)
+    {
+        const FILE_NOTIFY_INFORMATION* information = (const FILE_NOTIFY_INFORMATION*)event;
+
+        if (information->Action != FILE_ACTION_REMOVED && information->Action != FILE_ACTION_RENAMED_OLD_NAME)
+        {
+            int name_length = WideCharToMultiByte(CP_ACP, 0, information->FileName, (int)(information->FileNameLength / sizeof(WCHAR)), name, sizeof(name) - 1, NULL, NULL);
+            if (name_length > 0) hr_note_change(watcher, name, (size_t)name_length, now);
+        }
+
+        if (!information->NextEntryOffset) break;
+        event += information->NextEntryOffset;
+    }
+
+    CHECK_CALL(hr_start_read, watcher);
+#else
+    for (;;)
+    {
+        ssize_t size = read(watcher->inotify, watcher->events, sizeof(watcher->events));
+        if (size < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return MSL_EXTERNAL_ERROR;
+        }
+        if (!size) break;
+
+        const char* event = (const char*)watcher->events;
+        const char* end = event + size;
+        while (event < end)
+        {
+            const struct inotify_event* information = (const struct inotify_event*)event;
+            if (information->len) hr_note_change(watcher, information->name, strlen(information->name), now);
+
+            event += sizeof(struct inotify_event) + information->len;
+        }
+    }
+#endif
+
+    return last_status;
+}
+
+int hr_open(const char* folder, hot_reload_watcher_t* watcher)
+{
+    int last_status = MSL_SUCCESS;
+    watcher->pending_count = 0;
+#ifdef _WIN32
+    watcher->directory = INVALID_HANDLE_VALUE;
+    watcher->read_pending = false;
+    memset(&watcher->overlapped, 0, sizeof(watcher->overlapped));
+#else
+    watcher->inotify = -1;
+    watcher->watch = -1;
+#endif
+
+    if (!folder || !*folder) return MSL_INVALID_PARAMETER;
+
+    size_t folder_length = strlen(folder);
+    if (folder_length + 2 > WALKER_PATH_CAPACITY) return MSL_INVALID_PARAMETER;
+
+    memcpy(watcher->path, folder, folder_length + 1);
+
+#ifdef _WIN32
+    watcher->directory = CreateFileA(
+        watcher->path,
+        FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        NULL
+    );
+    if (watcher->directory == INVALID_HANDLE_VALUE) return MSL_FILE_NOT_FOUND;
+
+    watcher->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (!watcher->overlapped.hEvent)
+    {
+        last_status = MSL_EXTERNAL_ERROR;
+        goto cleanup;
+    }
+
+    CHECK_CALL_GOTO_ERROR(hr_start_read, cleanup, watcher);
+#else
+    watcher->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher->inotify < 0) return MSL_EXTERNAL_ERROR;
+
+    watcher->watch = inotify_add_watch(watcher->inotify, watcher->path, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watcher->watch < 0)
+    {
+        last_status = MSL_FILE_NOT_FOUND;
+        goto cleanup;
+    }
+#endif
+
+    if (folder[folder_length - 1] != '\\' && folder[folder_length - 1] != '/')
+    {
+        watcher->path[folder_length++] = HOT_RELOAD_SEPARATOR;
+        watcher->path[folder_length] = 0;
+    }
+    watcher->folder_length = folder_length;
+    return last_status;
+
+    cleanup:
+    hr_close(watcher);
+    return last_status;
+}
+
+// on_change gets the full path of every DLL that settled since the last poll.
+// The path is only valid during the call, stops on the first error on_change returns.
+int hr_poll(hot_reload_watcher_t* watcher, int(*on_change)(const char*, void*), void* context)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(hr_read_events, watcher);
+
+    uint64_t now = hr_now_ms();
+    for (size_t i = 0; i < watcher->pending_count; )
+    {
+        hot_reload_pending_t* pending = &watcher->pending[i];
+        if (now - pending->last_change_ms < HOT_RELOAD_SETTLE_MS)
+        {
+            i++;
+            continue;
+        }
+
+        size_t name_length = strlen(pending->name);
+        if (watcher->folder_length + name_length + 1 <= WALKER_PATH_CAPACITY)
+        {
+            memcpy(watcher->path + watcher->folder_length, pending->name, name_length + 1);
+            last_status = on_change(watcher->path, context);
+        }
+
+        *pending = watcher->pending[--watcher->pending_count];
+        if (last_status != MSL_SUCCESS) break;
+    }
+
+    watcher->path[watcher->folder_length] = 0;
+    return last_status;
+}
+
+#ifdef _WIN32
+// Reloads the module mapped from image_path, or maps it if it's a new one.
+// Modules exporting ModuleHotReload keep their module_t, see md_reload_image.
+// Modules copy the path, image_path only has to live during the call.
+int hr_reload_image(const char* image_path, bool* reloaded)
+{
+    int last_status = MSL_SUCCESS;
+    module_t* module = NULL;
+    module_t new_module;
+    *reloaded = false;
+
+    if (mdp_lookup_module_by_path(image_path, &module) != MSL_SUCCESS)
+    {
+        CHECK_CALL(md_map_image, image_path, &new_module);
+        *reloaded = true;
+        return last_status;
+    }
+
+    if (module->module_hot_reload)
+    {
+        CHECK_CALL(md_reload_image, module, image_path);
+    }
+    else
+    {
+        CHECK_CALL(md_unmap_image, module);
+        CHECK_CALL(md_map_image, image_path, &new_module);
+    }
+
+    *reloaded = true;
+    return last_status;
+}
+
+static int hr_reload_callback(const char* image_path, void* context)
+{
+    bool reloaded = false;
+
+    // A broken build shouldn't stop the other modules from reloading
+    if (hr_reload_image(image_path, &reloaded) == MSL_SUCCESS && reloaded)
+        (*(size_t*)context)++;
+
+    return MSL_SUCCESS;
+}
+
+// Meant to be called regularly from the game loop, reloaded_count can be NULL
+int hr_reload_changed(hot_reload_watcher_t* watcher, size_t* reloaded_count)
+{
+    int last_status = MSL_SUCCESS;
+    size_t count = 0;
+
+    CHECK_CALL(hr_poll, watcher, hr_reload_callback, &count);
+
+    if (reloaded_count)
+        *reloaded_count = count;
+
+    return last_status;
+}
+#endif
+
+int hr_close(hot_reload_watcher_t* watcher)
+{
+    if (!watcher) return MSL_NULL_BUFFER;
+
+#ifdef _WIN32
+    if (watcher->directory != INVALID_HANDLE_VALUE)
+    {
+        // The pending read has to finish before the buffer goes away
+        if (watcher->read_pending)
+        {
+            DWORD size = 0;
+            CancelIo(watcher->directory);
+            GetOverlappedResult(watcher->directory, &watcher->overlapped, &size, TRUE);
+        }
+        CloseHandle(watcher->directory);
+    }
+    if (watcher->overlapped.hEvent) CloseHandle(watcher->overlapped.hEvent);
+
+    watcher->directory = INVALID_HANDLE_VALUE;
+    watcher->overlapped.hEvent = NULL;
+    watcher->read_pending = false;
+#else
+    if (watcher->inotify >= 0) close(watcher->inotify);
+
+    watcher->inotify = -1;
+    watcher->watch = -1;
+#endif
+
+    watcher->pending_count = 0;
+    return MSL_SUCCESS;
+}
@@ -8,7 +8,7 @@
 #include "d3d11.h"
 
 FUNC_HASH(str, TRoutine)
-FUNC_HASH(str, size_t)
+FUNC_HASH(int32_t, str)
 FUNC_VEC(module_callback_descriptor_t)
 FUNC_VEC(module_t)
 FUNC_VEC(interface_table_entry_t) 
@@ -17,6 +17,21 @@ FUNC_VEC(memory_allocation_t)
 FUNC_VEC(inline_hook_t)
 FUNC_VEC(mid_hook_t)
 
+// The interface this framework exposes, used where no interface is passed around
+interface_impl_t global_module_interface;
+
+static void delete_cached_name_TRoutine(str* key, TRoutine* value)
+{
+	UNREFERENCED_PARAMETER(value);
+	free((char*)*key);
+}
+
+static void delete_cached_name_int32_t(str* key, int32_t* value)
+{
+	UNREFERENCED_PARAMETER(value);
+	free((char*)*key);
+}
+
 void destructor_inline_hook_t(inline_hook_t* inline_hook)
 {
 	shi_destroy(inline_hook->hook_instance);
@@ -234,11 +249,104 @@ int get_named_routine_pointer(interface_impl_t* interface_impl, const char* func
 	return MSL_SUCCESS;
 }
 
+int build_builtin_function_table(interface_impl_t* interface_impl)
+{
+	int last_status = MSL_SUCCESS;
+
+	// Already ingested
+	if (interface_impl->builtin_function_table.entries)
+		return MSL_SUCCESS;
+
+	if (!interface_impl->functions_array || !*interface_impl->functions_array)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	if (!interface_impl->function_entry_size)
+	{
+		CHECK_CALL(determine_function_entry_size, interface_impl, &interface_impl->function_entry_size);
+	}
+
+	size_t function_count = 0;
+	CHECK_CALL(bt_count_function_entries, *interface_impl->functions_array, interface_impl->function_entry_size, &function_count);
+	CHECK_CALL(bt_build_function_table_alloc, *interface_impl->functions_array, interface_impl->function_entry_size, function_count, &interface_impl->builtin_function_table);
+	return last_status;
+}
+
+int get_builtin_function_id(interface_impl_t* interface_impl, const char* function_name, int32_t* function_id)
+{
+	int last_status = MSL_SUCCESS;
+
+	// Filled by initialize_interface, built here if a lookup comes first.
+	// Returns right away once built, the functions array doesn't change afterwards.
+	CHECK_CALL(build_builtin_function_table, interface_impl);
+
+	return bt_lookup_function(&interface_impl->builtin_function_table, function_name, function_id);
+}
+
+int call_builtin_by_id(interface_impl_t* interface_impl, int32_t function_id, rvalue_t* result, instance_t* self_instance, instance_t* other_instance, rvalue_t* arguments, size_t arguments_size)
+{
+	int last_status = MSL_SUCCESS;
+	builtin_function_entry_t* entry = NULL;
+	CHECK_CALL(bt_get_function_entry, &interface_impl->builtin_function_table, function_id, &entry);
+
+	entry->routine(
+		result,
+		self_instance,
+		other_instance,
+		(int)arguments_size,
+		arguments
+	);
+
+	return MSL_SUCCESS;
+}
+
+int resolve_builtin(interface_impl_t* interface_impl, const char* function_name, builtin_handle_t* handle)
+{
+	int last_status = MSL_SUCCESS;
+	int32_t function_id = -1;
+	builtin_function_entry_t* entry = NULL;
+
+	CHECK_CALL(get_builtin_function_id, interface_impl, function_name, &function_id);
+	CHECK_CALL(bt_get_function_entry, &interface_impl->builtin_function_table, function_id, &entry);
+
+	handle->routine = entry->routine;
+	handle->id = function_id;
+	handle->argument_count = entry->argument_count;
+	return last_status;
+}
+
+int invoke_builtin(const builtin_handle_t* handle, instance_t* self_instance, instance_t* other_instance, rvalue_t* arguments, size_t arguments_size, rvalue_t* result)
+{
+	if (!handle || !handle->routine) return MSL_INVALID_PARAMETER;
+
+	// Routines always write their result, give them somewhere to do it
+	rvalue_t discarded_result = init_rvalue();
+	if (!result) result = &discarded_result;
+
+	handle->routine(
+		result,
+		self_instance,
+		other_instance,
+		(int)arguments_size,
+		arguments
+	);
+
+	return MSL_SUCCESS;
+}
+
 int call_builtin_ex(interface_impl_t* interface_impl, rvalue_t* result, const char* function_name, instance_t* self_instance, instance_t* other_instance, rvalue_t* arguments, size_t arguments_size)
 {
+	int last_status = MSL_SUCCESS;
+
+	// Builtins are resolved through the dense table, no need to cache them
+	int32_t function_id = -1;
+	if (get_builtin_function_id(interface_impl, function_name, &function_id) == MSL_SUCCESS)
+	{
+		CHECK_CALL(call_builtin_by_id, interface_impl, function_id, result, self_instance, other_instance, arguments, arguments_size);
+		return last_status;
+	}
+
 	// Use the cached result if possible
 	TRoutine function = NULL;
-	int last_status = MSL_SUCCESS;
 	last_status = GET_VALUE(str, TRoutine)(&interface_impl->builtin_function_cache, function_name, &function);
 	if (last_status == MSL_SUCCESS)
 	{
@@ -255,13 +363,19 @@ int call_builtin_ex(interface_impl_t* interface_impl, rvalue_t* result, const ch
 
 	// Query for the function pointer
 	// Make sure we found a function
-	CHECK_CALL(interface_impl->intf.get_named_routine_pointer, function_name, (void*)function);
+	CHECK_CALL(interface_impl->intf.get_named_routine_pointer, function_name, (void**)&function);
 
 	// Previous check should've fired
 	RUNTIME_ASSERT(function != NULL);
 
-	// Cache the result
-	CHECK_CALL(INSERT(str, TRoutine), &interface_impl->builtin_function_cache, function_name, function);
+	// Cache the result, the cache outlives the caller's string so it keeps its own copy
+	char* cached_name = strdup(function_name);
+	if (!cached_name) return MSL_ALLOCATION_ERROR;
+
+	interface_impl->builtin_function_cache.delete_value = delete_cached_name_TRoutine;
+	// A failed insertion doesn't keep the key, the lookup still succeeds uncached
+	if (INSERT(str, TRoutine)(&interface_impl->builtin_function_cache, cached_name, function) != MSL_SUCCESS)
+		free(cached_name);
 	
 	function(
 		result,
@@ -274,137 +388,1057 @@ int call_builtin_ex(interface_impl_t* interface_impl, rvalue_t* result, const ch
 	return MSL_SUCCESS;
 }
 
-rvalue_t init_rvalue(void)
+int build_builtin_variable_table(interface_impl_t* interface_impl)
 {
-	rvalue_t rvalue;
-	rvalue.real = 0;
-	rvalue.flags = 0;
-	rvalue.kind = VALUE_UNDEFINED;
+	int last_status = MSL_SUCCESS;
 
-    return rvalue;
+	// Already ingested
+	if (interface_impl->builtin_variable_table.slot_indices)
+		return MSL_SUCCESS;
+
+	if (!interface_impl->builtin_array || !interface_impl->builtin_count || *interface_impl->builtin_count <= 0)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	CHECK_CALL(bt_build_variable_table_alloc, interface_impl->builtin_array, (size_t)(*interface_impl->builtin_count), &interface_impl->builtin_variable_table);
+	return last_status;
 }
 
-rvalue_t init_rvalue_bool(bool value)
+// Second stage of initializing, once the runner interface and the functions array are found.
+// The builtin tables are filled here so no lookup pays for building them.
+int initialize_interface(interface_impl_t* interface_impl)
 {
-	rvalue_t rvalue;
-	rvalue.real = (double)(value);
-	rvalue.flags = 0;
-	rvalue.kind = VALUE_BOOL;
+	int last_status = MSL_SUCCESS;
 
-    return rvalue;
+	if (interface_impl->second_init_complete)
+		return MSL_SUCCESS;
+
+	CHECK_CALL(build_builtin_function_table, interface_impl);
+	CHECK_CALL(build_builtin_variable_table, interface_impl);
+
+	interface_impl->second_init_complete = true;
+	return last_status;
 }
 
-rvalue_t init_rvalue_double(double value)
+int get_builtin_variable_index(interface_impl_t* interface_impl, const char* variable_name, size_t* variable_index)
 {
-	rvalue_t rvalue;
-	rvalue.real = value;
-	rvalue.flags = 0;
-	rvalue.kind = VALUE_REAL;
+	int last_status = MSL_SUCCESS;
 
-    return rvalue;
+	// Filled by initialize_interface, built here if a lookup comes first.
+	// Returns right away once built, the builtin array is fixed once the runner started.
+	CHECK_CALL(build_builtin_variable_table, interface_impl);
+
+	int32_t index = -1;
+	CHECK_CALL(bt_lookup_variable, &interface_impl->builtin_variable_table, variable_name, &index);
+
+	*variable_index = (size_t)index;
+	return last_status;
 }
 
-rvalue_t init_rvalue_i64(int64_t value)
+int get_builtin_variable_information(interface_impl_t* interface_impl, size_t variable_index, rvariable_routine_t** variable_information)
 {
-	rvalue_t rvalue;
-	rvalue.i64 = value;
-	rvalue.flags = 0;
-	rvalue.kind = VALUE_INT64;
+	int last_status = MSL_SUCCESS;
+	CHECK_CALL(build_builtin_variable_table, interface_impl);
 
-    return rvalue;
+	return bt_get_variable_entry(&interface_impl->builtin_variable_table, (int32_t)variable_index, variable_information);
 }
 
-rvalue_t init_rvalue_i32(int32_t value)
+int get_builtin_by_index(interface_impl_t* interface_impl, size_t variable_index, instance_t* target_instance, int array_index, rvalue_t* value)
 {
-	rvalue_t rvalue;
-	rvalue.i32 = value;
-	rvalue.flags = 0;
-	rvalue.kind = VALUE_INT32;
+	int last_status = MSL_SUCCESS;
+	rvariable_routine_t* variable = NULL;
+	CHECK_CALL(get_builtin_variable_information, interface_impl, variable_index, &variable);
 
-    return rvalue;
+	if (!variable->get_variable(target_instance, array_index, value))
+		return MSL_EXTERNAL_ERROR;
+
+	return MSL_SUCCESS;
 }
 
-rvalue_t init_rvalue_instance(instance_t* object)
+int set_builtin_by_index(interface_impl_t* interface_impl, size_t variable_index, instance_t* target_instance, int array_index, rvalue_t* value)
 {
-	rvalue_t rvalue;
-	rvalue.object = object;
-	rvalue.flags = 0;
-	rvalue.kind = VALUE_OBJECT;
+	int last_status = MSL_SUCCESS;
+	rvariable_routine_t* variable = NULL;
+	CHECK_CALL(get_builtin_variable_information, interface_impl, variable_index, &variable);
 
-    return rvalue;
+	// Read-only builtins (fps, instance_count, etc.)
+	if (!variable->can_be_set || !variable->set_variable)
+		return MSL_ACCESS_DENIED;
+
+	if (!variable->set_variable(target_instance, array_index, value))
+		return MSL_EXTERNAL_ERROR;
+
+	return MSL_SUCCESS;
 }
 
-rvalue_t init_rvalue_str(const char* value)
+int get_builtin_real_by_index(interface_impl_t* interface_impl, size_t variable_index, instance_t* target_instance, double* value)
 {
-	// Init to empty
-	return *(rvalue_t*)value;
+	int last_status = MSL_SUCCESS;
+	rvalue_t result = init_rvalue();
+	CHECK_CALL(get_builtin_by_index, interface_impl, variable_index, target_instance, ARRAY_INDEX_NO_INDEX, &result);
+
+	switch (result.kind)
+	{
+	case VALUE_REAL:
+	case VALUE_BOOL:
+		*value = result.real;
+		return MSL_SUCCESS;
+	case VALUE_INT32:
+		*value = (double)(result.i32);
+		return MSL_SUCCESS;
+	case VALUE_INT64:
+		*value = (double)(result.i64);
+		return MSL_SUCCESS;
+	default:
+		return MSL_INVALID_PARAMETER;
+	}
 }
 
-int init_rvalue_str_interface(rvalue_t* rvalue, const char* value, interface_impl_t* interface_impl)
+int get_builtins_by_index(interface_impl_t* interface_impl, const size_t* variable_indices, size_t count, instance_t* target_instance, rvalue_t* values)
 {
-	// Initialize it to just empty stuff
-	*rvalue = init_rvalue();
+	int last_status = MSL_SUCCESS;
+	CHECK_CALL(build_builtin_variable_table, interface_impl);
 
-	// Let's not crash on invalid interfaces provided
-	if (!interface_impl) return MSL_MODULE_INTERNAL_ERROR;
+	// Resolve the whole batch first, so the getters run back to back
+	const builtin_variable_table_t* table = &interface_impl->builtin_variable_table;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (variable_indices[i] >= table->variable_count)
+			return MSL_INVALID_PARAMETER;
+	}
 
-	// We can ignore this, because if it fails, we're just initialized to UNSET
-	interface_impl->intf.string_to_rvalue(value, rvalue);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (!table->variables[variable_indices[i]].get_variable(target_instance, ARRAY_INDEX_NO_INDEX, &values[i]))
+			return MSL_EXTERNAL_ERROR;
+	}
 
-    return MSL_SUCCESS;
+	return MSL_SUCCESS;
 }
 
-int descriptor_comparator(const void* first, const void* second) 
+int get_builtin(interface_impl_t* interface_impl, const char* variable_name, instance_t* target_instance, int array_index, rvalue_t* value)
 {
-    int32_t first_priority = ((const module_callback_descriptor_t *)first)->priority;
-    int32_t second_priority  = ((const module_callback_descriptor_t *)second)->priority;
-    return first_priority  - second_priority;
+	int last_status = MSL_SUCCESS;
+	size_t variable_index = 0;
+	CHECK_CALL(get_builtin_variable_index, interface_impl, variable_name, &variable_index);
+	CHECK_CALL(get_builtin_by_index, interface_impl, variable_index, target_instance, array_index, value);
+	return last_status;
 }
 
-int sort_module_callbacks(interface_impl_t* interface_impl)
+int set_builtin(interface_impl_t* interface_impl, const char* variable_name, instance_t* target_instance, int array_index, rvalue_t* value)
 {
-	qsort(
-		interface_impl->registered_callbacks.arr, 
-		interface_impl->registered_callbacks.size, 
-		sizeof(module_callback_descriptor_t), interface_impl->descriptor_comparator);
+	int last_status = MSL_SUCCESS;
+	size_t variable_index = 0;
+	CHECK_CALL(get_builtin_variable_index, interface_impl, variable_name, &variable_index);
+	CHECK_CALL(set_builtin_by_index, interface_impl, variable_index, target_instance, array_index, value);
+	return last_status;
+}
+
+int get_variable_slot(interface_impl_t* interface_impl, const rvalue_t* object, const char* variable_name, int32_t* slot)
+{
+	int last_status = MSL_SUCCESS;
+
+	// Use the cached result if possible
+	last_status = GET_VALUE(str, int32_t)(&interface_impl->variable_slot_cache, variable_name, slot);
+	if (last_status == MSL_SUCCESS)
+		return MSL_SUCCESS;
+
+	if (!interface_impl->find_alloc_slot)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	if (object->kind != VALUE_OBJECT || !object->object)
+		return MSL_INVALID_PARAMETER;
+
+	// Slot ids come from a runner-wide name table, so any object resolves the same name to the same slot
+	int32_t variable_slot = interface_impl->find_alloc_slot((yyobject_base_t*)(object->object), variable_name);
+	if (variable_slot < 0)
+		return MSL_OBJECT_NOT_FOUND;
+
+	char* cached_name = strdup(variable_name);
+	if (!cached_name) return MSL_ALLOCATION_ERROR;
+
+	interface_impl->variable_slot_cache.delete_value = delete_cached_name_int32_t;
+	// A failed insertion doesn't keep the key, the lookup still succeeds uncached
+	if (INSERT(str, int32_t)(&interface_impl->variable_slot_cache, cached_name, variable_slot) != MSL_SUCCESS)
+	{
+		free(cached_name);
+	}
+	else if (INSERT(int32_t, str)(&interface_impl->variable_name_cache, variable_slot, cached_name) != MSL_SUCCESS)
+	{
+		// Both caches have to agree, the name is only found again through its slot
+		REMOVE(str, int32_t)(&interface_impl->variable_slot_cache, cached_name);
+	}
+
+	*slot = variable_slot;
 	return MSL_SUCCESS;
 }
 
-int find_descriptor(interface_impl_t* interface_impl, module_callback_descriptor_t* descriptor, module_callback_descriptor_t* element)
+int get_instance_member_by_slot(interface_impl_t* interface_impl, rvalue_t instance, int32_t slot, rvalue_t** member)
 {
-	for(size_t i = 0; i < interface_impl->registered_callbacks.size; i++)
+	UNREFERENCED_PARAMETER(interface_impl);
+
+	if (instance.kind != VALUE_OBJECT || !instance.object || slot < 0)
+		return MSL_INVALID_PARAMETER;
+
+	yyobject_base_t* object = (yyobject_base_t*)(instance.object);
+
+	// Structs and most instances keep their variables in the hashmap, keyed by slot
+	if (object->yyvars_map)
+		return GET_VALUE(int32_t, p_rvalue_t)(object->yyvars_map, slot, member);
+
+	// Otherwise the variables are a plain array indexed by slot, capacity entries long
+	if (!object->instance_base.yyvars || (uint32_t)slot >= object->capacity)
+		return MSL_OBJECT_NOT_FOUND;
+
+	*member = &object->instance_base.yyvars[slot];
+	return MSL_SUCCESS;
+}
+
+int get_instance_member(interface_impl_t* interface_impl, rvalue_t instance, const char* member_name, rvalue_t** member)
+{
+	int last_status = MSL_SUCCESS;
+	int32_t slot = -1;
+	CHECK_CALL(get_variable_slot, interface_impl, &instance, member_name, &slot);
+	CHECK_CALL(get_instance_member_by_slot, interface_impl, instance, slot, member);
+	return last_status;
+}
+
+int count_instance_members(interface_impl_t* interface_impl, rvalue_t instance, size_t* count)
+{
+	UNREFERENCED_PARAMETER(interface_impl);
+
+	if (instance.kind != VALUE_OBJECT || !instance.object)
+		return MSL_INVALID_PARAMETER;
+
+	return sm_count_members((yyobject_base_t*)(instance.object), count);
+}
+
+int get_instance_members(interface_impl_t* interface_impl, rvalue_t instance, member_entry_t* members, size_t capacity, size_t* count)
+{
+	UNREFERENCED_PARAMETER(interface_impl);
+
+	if (instance.kind != VALUE_OBJECT || !instance.object)
+		return MSL_INVALID_PARAMETER;
+
+	return sm_get_members((yyobject_base_t*)(instance.object), members, capacity, count);
+}
+
+// Name of a member slot, as returned by get_instance_members. Slots are runner-wide,
+// a slot the caches don't know yet is found by resolving every key of the instance once.
+// The name stays valid until the caches are invalidated.
+int get_variable_name(interface_impl_t* interface_impl, rvalue_t instance, int32_t slot, const char** name)
+{
+	int last_status = MSL_SUCCESS;
+
+	if (GET_VALUE(int32_t, str)(&interface_impl->variable_name_cache, slot, name) == MSL_SUCCESS)
+		return MSL_SUCCESS;
+
+	if (instance.kind != VALUE_OBJECT || !instance.object)
+		return MSL_INVALID_PARAMETER;
+
+	const yyrunner_interface_t* runner = &interface_impl->runner_interface;
+	if (!runner->StructGetKeys)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	int key_count = runner->StructGetKeys(&instance, NULL, NULL);
+	if (key_count < 0)
+		return MSL_EXTERNAL_ERROR;
+	if (!key_count)
+		return MSL_OBJECT_NOT_FOUND;
+
+	const char** keys = (const char**)malloc(sizeof(const char*) * (size_t)key_count);
+	if (!keys)
+		return MSL_ALLOCATION_ERROR;
+
+	runner->StructGetKeys(&instance, keys, &key_count);
+
+	// Resolving a name fills both caches
+	for (int i = 0; i < key_count; i++)
 	{
-		if (interface_impl->registered_callbacks.arr[i].routine == descriptor->routine && 
-			interface_impl->registered_callbacks.arr[i].owner_module == descriptor->owner_module &&
-			interface_impl->registered_callbacks.arr[i].trigger == descriptor->trigger &&
-			interface_impl->registered_callbacks.arr[i].priority == descriptor->priority)
+		int32_t key_slot = -1;
+		CHECK_CALL_GOTO_ERROR(get_variable_slot, cleanup, interface_impl, &instance, keys[i], &key_slot);
+	}
+
+	last_status = GET_VALUE(int32_t, str)(&interface_impl->variable_name_cache, slot, name) == MSL_SUCCESS ? MSL_SUCCESS : MSL_OBJECT_NOT_FOUND;
+
+	cleanup:
+	free(keys);
+	return last_status;
+}
+
+int detect_instance_layout(interface_impl_t* interface_impl, OLINKEDLIST(instance_t)* active_instances)
+{
+	int last_status = MSL_SUCCESS;
+
+	// The layout doesn't change while the game runs
+	if (interface_impl->instance_accessors)
+		return MSL_SUCCESS;
+
+	if (!active_instances->first)
+		return MSL_OBJECT_NOT_FOUND;
+
+	// Compare the id read through each layout to what the runner says the id is
+	INSTANCE_LAYOUT layout = INSTANCE_LAYOUT_MEMBERS_ONLY;
+	rvalue_t id = init_rvalue();
+	last_status = get_builtin(interface_impl, "id", active_instances->first, ARRAY_INDEX_NO_INDEX, &id);
+	if (last_status == MSL_SUCCESS)
+	{
+		int32_t instance_id = -1;
+		switch (id.kind)
 		{
-			*element = interface_impl->registered_callbacks.arr[i];
-			return MSL_SUCCESS;
+		case VALUE_REAL:
+			instance_id = (int32_t)(id.real);
+			break;
+		case VALUE_INT32:
+			instance_id = id.i32;
+			break;
+		case VALUE_INT64:
+		case VALUE_REF:
+			instance_id = (int32_t)(id.i64 & 0xFFFFFFFF);
+			break;
+		default:
+			break;
 		}
+
+		last_status = rm_detect_layout_by_id(active_instances->first, instance_id, &layout);
 	}
-	element = NULL;
-	return MSL_OBJECT_NOT_IN_LIST;
+
+	// Without the builtin, fall back on the instance element map of the room
+	if (last_status)
+	{
+		if (!interface_impl->run_room || !*interface_impl->run_room)
+			return MSL_MODULE_INTERNAL_ERROR;
+
+		CHECK_CALL(rm_detect_layout_by_elements, *interface_impl->run_room, active_instances->first, &layout);
+	}
+
+	CHECK_CALL(rm_get_instance_accessors, layout, &interface_impl->instance_accessors);
+	return MSL_SUCCESS;
 }
 
-int remove_callback_from_list(interface_impl_t* interface_impl, module_t* module, void* routine)
+int get_instance_accessors(interface_impl_t* interface_impl, const instance_accessors_t** accessors)
 {
-	if (!interface_impl->registered_callbacks.size)
+	int last_status = MSL_SUCCESS;
+
+	if (!interface_impl->instance_accessors)
 	{
-		return MSL_NULL_BUFFER;
+		if (!interface_impl->run_room || !*interface_impl->run_room)
+			return MSL_MODULE_INTERNAL_ERROR;
+
+		OLINKEDLIST(instance_t)* active_instances = NULL;
+		CHECK_CALL(rm_get_active_instances, *interface_impl->run_room, &active_instances);
+		CHECK_CALL(interface_impl->detect_instance_layout, interface_impl, active_instances);
 	}
 
-	for(size_t i = 0; i < interface_impl->registered_callbacks.size; i++)
+	*accessors = interface_impl->instance_accessors;
+	return MSL_SUCCESS;
+}
+
+int begin_instance_iteration(interface_impl_t* interface_impl, int32_t object_index, instance_iterator_t* iterator)
+{
+	int last_status = MSL_SUCCESS;
+
+	if (!interface_impl->run_room || !*interface_impl->run_room)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	OLINKEDLIST(instance_t)* active_instances = NULL;
+	CHECK_CALL(rm_get_active_instances, *interface_impl->run_room, &active_instances);
+
+	// An empty room yields nothing, the layout isn't needed to tell
+	if (active_instances->count <= 0 || !active_instances->first)
 	{
-		if (interface_impl->registered_callbacks.arr[i].routine == routine && interface_impl->registered_callbacks.arr[i].owner_module == module)
-		{
-			interface_impl->registered_callbacks.arr[i] = interface_impl->registered_callbacks.arr[interface_impl->registered_callbacks.size - 1];
-			interface_impl->registered_callbacks.size--;
+		CHECK_CALL(rm_iterator_init_single, NULL, iterator);
+		return MSL_SUCCESS;
+	}
 
-			return interface_impl->sort_module_callbacks(interface_impl);
-		}
+	if (!interface_impl->instance_accessors)
+	{
+		last_status = interface_impl->detect_instance_layout(interface_impl, active_instances);
+		if (last_status && active_instances->count > 1)
+			return last_status;
+
+		// A lone instance is yielded without reading its members, the builtin gives its object
+		if (last_status)
+		{
+			instance_t* instance = active_instances->first;
+			if (object_index != INSTANCE_ITERATOR_ALL_OBJECTS)
+			{
+				size_t variable_index = 0;
+				double instance_object_index = -1.0;
+				CHECK_CALL(get_builtin_variable_index, interface_impl, "object_index", &variable_index);
+				CHECK_CALL(get_builtin_real_by_index, interface_impl, variable_index, instance, &instance_object_index);
+
+				if ((int32_t)(instance_object_index) != object_index)
+					instance = NULL;
+			}
+
+			CHECK_CALL(rm_iterator_init_single, instance, iterator);
+			return MSL_SUCCESS;
+		}
+	}
+
+	CHECK_CALL(rm_iterator_init, active_instances, object_index, interface_impl->instance_accessors->members_offset, iterator);
+	return MSL_SUCCESS;
+}
+
+int next_instance_batch(interface_impl_t* interface_impl, instance_iterator_t* iterator, instance_t** instances, size_t capacity, size_t* count)
+{
+	UNREFERENCED_PARAMETER(interface_impl);
+	return rm_iterator_next_batch(iterator, instances, capacity, count);
+}
+
+int capture_instance_snapshot(interface_impl_t* interface_impl, int32_t object_index, instance_snapshot_t* snapshot)
+{
+	int last_status = MSL_SUCCESS;
+	instance_iterator_t iterator;
+	const instance_accessors_t* accessors = NULL;
+
+	// Fields are read at the offset of the detected layout, never at a guessed one
+	CHECK_CALL(get_instance_accessors, interface_impl, &accessors);
+	CHECK_CALL(begin_instance_iteration, interface_impl, object_index, &iterator);
+	CHECK_CALL(sn_capture, &iterator, snapshot);
+	return last_status;
+}
+
+int apply_instance_snapshot(interface_impl_t* interface_impl, const instance_snapshot_t* snapshot, uint32_t fields)
+{
+	// Only snapshots captured with the detected layout are written back
+	if (!interface_impl->instance_accessors || snapshot->members_offset != interface_impl->instance_accessors->members_offset)
+		return MSL_INVALID_PARAMETER;
+
+	return sn_apply(snapshot, fields);
+}
+
+int update_spatial_index(interface_impl_t* interface_impl, const instance_snapshot_t* snapshot)
+{
+	int last_status = MSL_SUCCESS;
+
+	if (!interface_impl->spatial_index.buckets)
+	{
+		CHECK_CALL(sg_create, SPATIAL_DEFAULT_CELL_SIZE, &interface_impl->spatial_index);
+	}
+
+	CHECK_CALL(sg_update, &interface_impl->spatial_index, snapshot);
+	return last_status;
+}
+
+int query_instances_in_rect(interface_impl_t* interface_impl, yyrect_t rect, instance_t** instances, size_t capacity, size_t* count)
+{
+	*count = 0;
+	if (!interface_impl->spatial_index.buckets)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	return sg_query_rect(&interface_impl->spatial_index, rect, instances, capacity, count);
+}
+
+int query_instances_in_radius(interface_impl_t* interface_impl, float x, float y, float radius, instance_t** instances, size_t capacity, size_t* count)
+{
+	*count = 0;
+	if (!interface_impl->spatial_index.buckets)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	return sg_query_radius(&interface_impl->spatial_index, x, y, radius, instances, capacity, count);
+}
+
+int query_nearest_instances(interface_impl_t* interface_impl, float x, float y, size_t k, instance_t** instances, float* distances, size_t* count)
+{
+	*count = 0;
+	if (!interface_impl->spatial_index.buckets)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	return sg_query_nearest(&interface_impl->spatial_index, x, y, k, instances, distances, count);
+}
+
+int get_layer_by_id(interface_impl_t* interface_impl, int32_t layer_id, layer_t** layer)
+{
+	if (!interface_impl->run_room || !*interface_impl->run_room)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	return rm_find_layer_by_id(*interface_impl->run_room, layer_id, layer);
+}
+
+int get_layer_element_by_id(interface_impl_t* interface_impl, int32_t element_id, layer_element_base_t** element)
+{
+	if (!interface_impl->run_room || !*interface_impl->run_room)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	return rm_find_layer_element_by_id(*interface_impl->run_room, element_id, element);
+}
+
+int get_instance_layer_element(interface_impl_t* interface_impl, int32_t instance_id, layer_instance_element_t** element)
+{
+	if (!interface_impl->run_room || !*interface_impl->run_room)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	return rm_find_instance_element(*interface_impl->run_room, instance_id, element);
+}
+
+int get_layer_elements(interface_impl_t* interface_impl, layer_t* layer, layer_element_base_t** elements, size_t capacity, size_t* count)
+{
+	UNREFERENCED_PARAMETER(interface_impl);
+	return rm_get_layer_elements(layer, elements, capacity, count);
+}
+
+int get_string_view(interface_impl_t* interface_impl, const rvalue_t* value, string_view_t* view)
+{
+	UNREFERENCED_PARAMETER(interface_impl);
+	return rs_get_view(value, view);
+}
+
+int rvalue_to_string_buffer(interface_impl_t* interface_impl, rvalue_t* value, char* buffer, size_t capacity, size_t* length)
+{
+	int last_status = rs_to_buffer(value, buffer, capacity, length);
+	if (last_status != MSL_INVALID_PARAMETER)
+		return last_status;
+
+	// Arrays, structs and the like are formatted by the runner, this path allocates
+	rvalue_t result = init_rvalue();
+	CHECK_CALL(call_builtin_ex, interface_impl, &result, "string", NULL, NULL, value, 1);
+
+	last_status = rs_to_buffer(&result, buffer, capacity, length);
+
+	if (interface_impl->runner_interface.FREE_rvalue_t)
+		interface_impl->runner_interface.FREE_rvalue_t(&result);
+
+	return last_status;
+}
+
+int get_array_size(interface_impl_t* interface_impl, rvalue_t* value, size_t* size)
+{
+	int last_status = MSL_SUCCESS;
+
+	// Resolved once, array accesses don't look the builtin up by name
+	if (!interface_impl->array_length_handle.routine)
+	{
+		CHECK_CALL(resolve_builtin, interface_impl, "array_length", &interface_impl->array_length_handle);
+	}
+
+	rvalue_t result = init_rvalue();
+	CHECK_CALL(invoke_builtin, &interface_impl->array_length_handle, NULL, NULL, value, 1, &result);
+
+	switch (result.kind & RVALUE_KIND_MASK)
+	{
+	case VALUE_REAL:
+		*size = (size_t)(result.real);
+		break;
+	case VALUE_INT32:
+		*size = (size_t)(result.i32);
+		break;
+	case VALUE_INT64:
+		*size = (size_t)(result.i64);
+		break;
+	default:
+		return MSL_EXTERNAL_ERROR;
+	}
+
+	return MSL_SUCCESS;
+}
+
+// Start of the [start, start + count[ range of the array, the size is only asked once
+int get_array_range_data(interface_impl_t* interface_impl, rvalue_t* value, size_t start, size_t count, rvalue_t** data)
+{
+	int last_status = MSL_SUCCESS;
+
+	size_t size = 0;
+	CHECK_CALL(get_array_size, interface_impl, value, &size);
+	if (start > size || count > size - start) return MSL_INVALID_PARAMETER;
+
+	rvalue_t* array_data = NULL;
+	CHECK_CALL(ra_get_data, value, interface_impl->rvalue_array_offset, &array_data);
+
+	*data = array_data + start;
+	return MSL_SUCCESS;
+}
+
+int get_array_entry(interface_impl_t* interface_impl, rvalue_t* value, size_t array_index, rvalue_t** array_element)
+{
+	return get_array_range_data(interface_impl, value, array_index, 1, array_element);
+}
+
+int get_array_range(interface_impl_t* interface_impl, rvalue_t* value, size_t start, size_t count, rvalue_t* values)
+{
+	int last_status = MSL_SUCCESS;
+
+	rvalue_t* data = NULL;
+	CHECK_CALL(get_array_range_data, interface_impl, value, start, count, &data);
+
+	return ra_copy_out(data, count, values);
+}
+
+int set_array_range(interface_impl_t* interface_impl, rvalue_t* value, size_t start, size_t count, const rvalue_t* values)
+{
+	int last_status = MSL_SUCCESS;
+
+	rvalue_t* data = NULL;
+	CHECK_CALL(get_array_range_data, interface_impl, value, start, count, &data);
+
+	last_status = ra_copy_in(data, count, values);
+	if (last_status != MSL_INVALID_PARAMETER)
+		return last_status;
+
+	// Some values hold references, the runner has to release and take them
+	if (!interface_impl->runner_interface.FREE_rvalue_t || !interface_impl->runner_interface.COPY_rvalue_t)
+		return MSL_EXTERNAL_ERROR;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		interface_impl->runner_interface.FREE_rvalue_t(&data[i]);
+		interface_impl->runner_interface.COPY_rvalue_t(&data[i], &values[i]);
+	}
+
+	return MSL_SUCCESS;
+}
+
+int get_array_reals(interface_impl_t* interface_impl, rvalue_t* value, size_t start, size_t count, double* values)
+{
+	int last_status = MSL_SUCCESS;
+
+	rvalue_t* data = NULL;
+	CHECK_CALL(get_array_range_data, interface_impl, value, start, count, &data);
+
+	return ra_read_reals(data, count, values);
+}
+
+int set_array_reals(interface_impl_t* interface_impl, rvalue_t* value, size_t start, size_t count, const double* values)
+{
+	int last_status = MSL_SUCCESS;
+
+	rvalue_t* data = NULL;
+	CHECK_CALL(get_array_range_data, interface_impl, value, start, count, &data);
+
+	return ra_write_reals(data, count, values);
+}
+
+int save_rvalue(interface_impl_t* interface_impl, rvalue_t* value, const char* path)
+{
+	return sr_save(&interface_impl->runner_interface, interface_impl->rvalue_array_offset, value, path);
+}
+
+int load_rvalue(interface_impl_t* interface_impl, const char* path, rvalue_t* value)
+{
+	return sr_load(&interface_impl->runner_interface, interface_impl->rvalue_array_offset, path, value);
+}
+
+int create_ds_map(interface_impl_t* interface_impl, int32_t* map)
+{
+	return db_create_map(&interface_impl->runner_interface, map);
+}
+
+int create_ds_list(interface_impl_t* interface_impl, int32_t* list)
+{
+	return db_create_list(&interface_impl->runner_interface, list);
+}
+
+int ds_map_add_reals(interface_impl_t* interface_impl, int32_t map, const char* const* keys, const double* values, size_t count)
+{
+	return db_map_add_reals(&interface_impl->runner_interface, map, keys, values, count);
+}
+
+int ds_map_add_strings(interface_impl_t* interface_impl, int32_t map, const char* const* keys, const char* const* values, size_t count)
+{
+	return db_map_add_strings(&interface_impl->runner_interface, map, keys, values, count);
+}
+
+int ds_map_add_values(interface_impl_t* interface_impl, int32_t map, const char* const* keys, const ds_value_t* values, size_t count)
+{
+	return db_map_add_values(&interface_impl->runner_interface, map, keys, values, count);
+}
+
+int ds_list_add_values(interface_impl_t* interface_impl, int32_t list, const ds_value_t* values, size_t count)
+{
+	int last_status = MSL_SUCCESS;
+
+	if (!interface_impl->ds_list_add_handle.routine)
+	{
+		CHECK_CALL(resolve_builtin, interface_impl, "ds_list_add", &interface_impl->ds_list_add_handle);
+	}
+
+	return db_list_add_values(&interface_impl->runner_interface, &interface_impl->ds_list_add_handle, list, values, count);
+}
+
+int invalidate_asset_cache(interface_impl_t* interface_impl)
+{
+	int last_status = MSL_SUCCESS;
+	CHECK_CALL(CLEAR_HASHMAP(str, int32_t), &interface_impl->asset_index_cache);
+
+	interface_impl->asset_cache_room = interface_impl->run_room ? *interface_impl->run_room : NULL;
+	return last_status;
+}
+
+void invalidate_all_caches(interface_impl_t* interface_impl)
+{
+	CLEAR_HASHMAP(str, TRoutine)(&interface_impl->builtin_function_cache);
+	CLEAR_HASHMAP(int32_t, str)(&interface_impl->variable_name_cache);
+	CLEAR_HASHMAP(str, int32_t)(&interface_impl->variable_slot_cache);
+	interface_impl->invalidate_asset_cache(interface_impl);
+}
+
+int get_asset_index(interface_impl_t* interface_impl, const char* asset_name, int32_t* asset_index)
+{
+	int last_status = MSL_SUCCESS;
+
+	// Indices are only trusted in the room they were resolved in
+	room_t* current_room = interface_impl->run_room ? *interface_impl->run_room : NULL;
+	if (current_room != interface_impl->asset_cache_room)
+	{
+		CHECK_CALL(interface_impl->invalidate_asset_cache, interface_impl);
+	}
+
+	// Use the cached result if possible
+	last_status = GET_VALUE(str, int32_t)(&interface_impl->asset_index_cache, asset_name, asset_index);
+	if (last_status == MSL_SUCCESS)
+		return MSL_SUCCESS;
+
+	if (!interface_impl->asset_get_index_handle.routine)
+	{
+		CHECK_CALL(resolve_builtin, interface_impl, "asset_get_index", &interface_impl->asset_get_index_handle);
+	}
+
+	// asset_get_index doesn't keep its argument, no need for a runner string
+	ref_string_t argument_string;
+	rvalue_t argument;
+	CHECK_CALL(rs_init_borrowed, &argument_string, asset_name, &argument);
+
+	rvalue_t result = init_rvalue();
+	CHECK_CALL(invoke_builtin, &interface_impl->asset_get_index_handle, NULL, NULL, &argument, 1, &result);
+
+	// Older runners return a real, newer ones a reference holding the index in its low bits
+	int32_t index = -1;
+	switch (result.kind)
+	{
+	case VALUE_REAL:
+		index = (int32_t)(result.real);
+		break;
+	case VALUE_INT32:
+		index = result.i32;
+		break;
+	case VALUE_INT64:
+	case VALUE_REF:
+		index = (int32_t)(result.i64 & 0xFFFFFFFF);
+		break;
+	default:
+		return MSL_EXTERNAL_ERROR;
+	}
+
+	// Unknown names are not cached, the asset might exist later
+	if (index < 0)
+		return MSL_OBJECT_NOT_FOUND;
+
+	char* cached_name = strdup(asset_name);
+	if (!cached_name) return MSL_ALLOCATION_ERROR;
+
+	interface_impl->asset_index_cache.delete_value = delete_cached_name_int32_t;
+	// A failed insertion doesn't keep the key, the lookup still succeeds uncached
+	if (INSERT(str, int32_t)(&interface_impl->asset_index_cache, cached_name, index) != MSL_SUCCESS)
+		free(cached_name);
+
+	*asset_index = index;
+	return MSL_SUCCESS;
+}
+
+int get_script_data(interface_impl_t* interface_impl, int index, script_t** script)
+{
+	if (!interface_impl->get_script_data)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	// Values greater or equal to 100k are function indices of scripts
+	if (index >= 100000)
+		index -= 100000;
+
+	*script = interface_impl->get_script_data(index);
+	if (!*script)
+		return MSL_OBJECT_NOT_FOUND;
+
+	return MSL_SUCCESS;
+}
+
+int call_script_by_index(interface_impl_t* interface_impl, int32_t script_index, instance_t* self_instance, instance_t* other_instance, rvalue_t* arguments, size_t arguments_size, rvalue_t* result)
+{
+	// Scripts always write their result, give them somewhere to do it
+	rvalue_t discarded_result = init_rvalue();
+	if (!result) result = &discarded_result;
+
+	// Compiled scripts are called directly, skipping both script_execute and Script_Perform.
+	// The argument pointers live on the stack, longer argument lists go through Script_Perform.
+	script_t* script = NULL;
+	if (arguments_size <= BUILTIN_ARGUMENTS_CAPACITY &&
+		get_script_data(interface_impl, script_index, &script) == MSL_SUCCESS &&
+		script->functions && script->functions->script_function)
+	{
+		rvalue_t* argument_pointers[BUILTIN_ARGUMENTS_CAPACITY];
+		for (size_t i = 0; i < arguments_size; i++)
+			argument_pointers[i] = &arguments[i];
+
+		script->functions->script_function(
+			self_instance,
+			other_instance,
+			result,
+			(int)arguments_size,
+			argument_pointers
+		);
+
+		return MSL_SUCCESS;
+	}
+
+	// Let the runner deal with anything else
+	if (!interface_impl->runner_interface.Script_Perform)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	if (script_index >= 100000)
+		script_index -= 100000;
+
+	if (!interface_impl->runner_interface.Script_Perform(script_index, self_instance, other_instance, (int)arguments_size, result, arguments))
+		return MSL_EXTERNAL_ERROR;
+
+	return MSL_SUCCESS;
+}
+
+int call_script(interface_impl_t* interface_impl, const char* script_name, instance_t* self_instance, instance_t* other_instance, rvalue_t* arguments, size_t arguments_size, rvalue_t* result)
+{
+	int last_status = MSL_SUCCESS;
+	int32_t script_index = -1;
+
+	// Once cached, running a script by name costs a single hashmap lookup more than by index
+	CHECK_CALL(get_asset_index, interface_impl, script_name, &script_index);
+	CHECK_CALL(call_script_by_index, interface_impl, script_index, self_instance, other_instance, arguments, arguments_size, result);
+	return last_status;
+}
+
+rvalue_t init_rvalue(void)
+{
+	rvalue_t rvalue;
+	rvalue.real = 0;
+	rvalue.flags = 0;
+	rvalue.kind = VALUE_UNDEFINED;
+
+    return rvalue;
+}
+
+rvalue_t init_rvalue_bool(bool value)
+{
+	rvalue_t rvalue;
+	rvalue.real = (double)(value);
+	rvalue.flags = 0;
+	rvalue.kind = VALUE_BOOL;
+
+    return rvalue;
+}
+
+rvalue_t init_rvalue_double(double value)
+{
+	rvalue_t rvalue;
+	rvalue.real = value;
+	rvalue.flags = 0;
+	rvalue.kind = VALUE_REAL;
+
+    return rvalue;
+}
+
+rvalue_t init_rvalue_i64(int64_t value)
+{
+	rvalue_t rvalue;
+	rvalue.i64 = value;
+	rvalue.flags = 0;
+	rvalue.kind = VALUE_INT64;
+
+    return rvalue;
+}
+
+rvalue_t init_rvalue_i32(int32_t value)
+{
+	rvalue_t rvalue;
+	rvalue.i32 = value;
+	rvalue.flags = 0;
+	rvalue.kind = VALUE_INT32;
+
+    return rvalue;
+}
+
+rvalue_t init_rvalue_instance(instance_t* object)
+{
+	rvalue_t rvalue;
+	rvalue.object = object;
+	rvalue.flags = 0;
+	rvalue.kind = VALUE_OBJECT;
+
+    return rvalue;
+}
+
+rvalue_t init_rvalue_str(const char* value)
+{
+	rvalue_t rvalue;
+
+	// We can ignore this, because if it fails, we're just initialized to UNDEFINED
+	init_rvalue_str_interface(&rvalue, value, &global_module_interface);
+
+    return rvalue;
+}
+
+int init_rvalue_str_interface(rvalue_t* rvalue, const char* value, interface_impl_t* interface_impl)
+{
+	// Initialize it to just empty stuff
+	*rvalue = init_rvalue();
+
+	// Let's not crash on invalid interfaces provided
+	if (!interface_impl) return MSL_MODULE_INTERNAL_ERROR;
+
+	// The runner copies the text into a string it owns
+	if (interface_impl->runner_interface.YYCreateString)
+	{
+		interface_impl->runner_interface.YYCreateString(rvalue, value);
+		return MSL_SUCCESS;
+	}
+
+	if (interface_impl->intf.string_to_rvalue)
+		return interface_impl->intf.string_to_rvalue(value, rvalue);
+
+    return MSL_EXTERNAL_ERROR;
+}
+
+int builtin_arguments_init(builtin_arguments_t* arguments)
+{
+	arguments->count = 0;
+	arguments->owned_strings = 0;
+	return MSL_SUCCESS;
+}
+
+int builtin_arguments_push(builtin_arguments_t* arguments, rvalue_t value)
+{
+	if (arguments->count >= BUILTIN_ARGUMENTS_CAPACITY) return MSL_INSUFFICIENT_MEMORY;
+
+	arguments->values[arguments->count++] = value;
+	return MSL_SUCCESS;
+}
+
+int builtin_arguments_push_double(builtin_arguments_t* arguments, double value)
+{
+	return builtin_arguments_push(arguments, init_rvalue_double(value));
+}
+
+int builtin_arguments_push_i64(builtin_arguments_t* arguments, int64_t value)
+{
+	return builtin_arguments_push(arguments, init_rvalue_i64(value));
+}
+
+int builtin_arguments_push_bool(builtin_arguments_t* arguments, bool value)
+{
+	return builtin_arguments_push(arguments, init_rvalue_bool(value));
+}
+
+int builtin_arguments_push_instance(builtin_arguments_t* arguments, instance_t* value)
+{
+	return builtin_arguments_push(arguments, init_rvalue_instance(value));
+}
+
+int builtin_arguments_push_str(builtin_arguments_t* arguments, const char* value)
+{
+	int last_status = MSL_SUCCESS;
+	if (arguments->count >= BUILTIN_ARGUMENTS_CAPACITY) return MSL_INSUFFICIENT_MEMORY;
+
+	CHECK_CALL(builtin_arguments_push, arguments, init_rvalue_str(value));
+	arguments->owned_strings |= 1u << (arguments->count - 1);
+	return last_status;
+}
+
+// No allocation, but the callee must not keep the string, see rs_init_borrowed
+int builtin_arguments_push_borrowed_str(builtin_arguments_t* arguments, const char* value)
+{
+	if (arguments->count >= BUILTIN_ARGUMENTS_CAPACITY) return MSL_INSUFFICIENT_MEMORY;
+
+	rvalue_t rvalue;
+	int last_status = rs_init_borrowed(&arguments->strings[arguments->count], value, &rvalue);
+	if (last_status != MSL_SUCCESS) return last_status;
+
+	return builtin_arguments_push(arguments, rvalue);
+}
+
+// Frees the runner strings made by builtin_arguments_push_str and empties the arguments.
+// Other values, borrowed strings included, aren't owned by the arguments and are left alone.
+// Nothing is freed if the runner can't free strings, so the release can be retried.
+int builtin_arguments_release(builtin_arguments_t* arguments)
+{
+	if (arguments->owned_strings && !global_module_interface.runner_interface.FREE_rvalue_t)
+		return MSL_MODULE_INTERNAL_ERROR;
+
+	for (size_t i = 0; i < arguments->count; i++)
+	{
+		if (!(arguments->owned_strings & (1u << i)))
+			continue;
+
+		global_module_interface.runner_interface.FREE_rvalue_t(&arguments->values[i]);
+		arguments->values[i] = init_rvalue();
+	}
+
+	arguments->count = 0;
+	arguments->owned_strings = 0;
+	return MSL_SUCCESS;
+}
+
+int descriptor_comparator(const void* first, const void* second) 
+{
+    int32_t first_priority = ((const module_callback_descriptor_t *)first)->priority;
+    int32_t second_priority  = ((const module_callback_descriptor_t *)second)->priority;
+    return first_priority  - second_priority;
+}
+
+int sort_module_callbacks(interface_impl_t* interface_impl)
+{
+	qsort(
+		interface_impl->registered_callbacks.arr, 
+		interface_impl->registered_callbacks.size, 
+		sizeof(module_callback_descriptor_t), interface_impl->descriptor_comparator);
+	return MSL_SUCCESS;
+}
+
+int find_descriptor(interface_impl_t* interface_impl, module_callback_descriptor_t* descriptor, module_callback_descriptor_t* element)
+{
+	for(size_t i = 0; i < interface_impl->registered_callbacks.size; i++)
+	{
+		if (interface_impl->registered_callbacks.arr[i].routine == descriptor->routine && 
+			interface_impl->registered_callbacks.arr[i].owner_module == descriptor->owner_module &&
+			interface_impl->registered_callbacks.arr[i].trigger == descriptor->trigger &&
+			interface_impl->registered_callbacks.arr[i].priority == descriptor->priority)
+		{
+			*element = interface_impl->registered_callbacks.arr[i];
+			return MSL_SUCCESS;
+		}
+	}
+	element = NULL;
+	return MSL_OBJECT_NOT_IN_LIST;
+}
+
+int remove_callback_from_list(interface_impl_t* interface_impl, module_t* module, void* routine)
+{
+	if (!interface_impl->registered_callbacks.size)
+	{
+		return MSL_NULL_BUFFER;
+	}
+
+	for(size_t i = 0; i < interface_impl->registered_callbacks.size; i++)
+	{
+		if (interface_impl->registered_callbacks.arr[i].routine == routine && interface_impl->registered_callbacks.arr[i].owner_module == module)
+		{
+			interface_impl->registered_callbacks.arr[i] = interface_impl->registered_callbacks.arr[interface_impl->registered_callbacks.size - 1];
+			interface_impl->registered_callbacks.size--;
+
+			return interface_impl->sort_module_callbacks(interface_impl);
+		}
+	}
+
+	return MSL_SUCCESS;
+}
+
+// Drops every callback of the module, its routines go away with its image.
+// The others keep their order, so the list stays sorted.
+int remove_module_callbacks(interface_impl_t* interface_impl, module_t* module)
+{
+	size_t kept = 0;
+	for(size_t i = 0; i < interface_impl->registered_callbacks.size; i++)
+	{
+		if (interface_impl->registered_callbacks.arr[i].owner_module != module)
+			interface_impl->registered_callbacks.arr[kept++] = interface_impl->registered_callbacks.arr[i];
 	}
 
+	interface_impl->registered_callbacks.size = kept;
 	return MSL_SUCCESS;
 }
 
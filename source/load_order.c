@@ -0,0 +1,411 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdio.h>
+#include <ctype.h>
+#include "../include/load_order.h"
+#include "../include/error.h"
+
+static int lo_compare_names(const char* first, size_t first_length, const char* second, size_t second_length)
+{
+    size_t length = first_length < second_length ? first_length : second_length;
+    for (size_t i = 0; i < length; i++)
+    {
+        int first_char = tolower((unsigned char)first[i]);
+        int second_char = tolower((unsigned char)second[i]);
+        if (first_char != second_char) return first_char - second_char;
+    }
+
+    return (first_length > second_length) - (first_length < second_length);
+}
+
+static int lo_name_comparator(const load_order_entry_t* entries, size_t first, size_t second)
+{
+    const load_order_entry_t* first_entry = &entries[first];
+    const load_order_entry_t* second_entry = &entries[second];
+
+    int cmp = lo_compare_names(first_entry->name, first_entry->name_length, second_entry->name, second_entry->name_length);
+    if (cmp) return cmp;
+
+    // Same file in different folders
+    cmp = strcmp(first_entry->path, second_entry->path);
+    if (cmp) return cmp;
+
+    return (first > second) - (first < second);
+}
+
+// Bottom up merge sort of indices into entries, qsort can't be given the entries without a global.
+// scratch holds count indices, the result always ends up in indices.
+static void lo_sort_by_name(const load_order_entry_t* entries, size_t* indices, size_t* scratch, size_t count)
+{
+    size_t* source = indices;
+    size_t* destination = scratch;
+
+    for (size_t width = 1; width < count; width *= 2)
+    {
+        for (size_t low = 0; low < count; low += 2 * width)
+        {
+            size_t middle = low + width < count ? low + width : count;
+            size_t high = middle + width < count ? middle + width : count;
+            size_t left = low;
+            size_t right = middle;
+
+            for (size_t i = low; i < high; i++)
+            {
+                if (left < middle && (right >= high || lo_name_comparator(entries, source[left], source[right]) <= 0))
+                    destination[i] = source[left++];
+                else
+                    destination[i] = source[right++];
+            }
+        }
+
+        size_t* swap = source;
+        source = destination;
+        destination = swap;
+    }
+
+    if (source != indices) memcpy(indices, source, count * sizeof(size_t));
+}
+
+static int lo_edge_comparator(const void* first, const void* second)
+{
+    const load_order_edge_t* first_edge = (const load_order_edge_t*)first;
+    const load_order_edge_t* second_edge = (const load_order_edge_t*)second;
+
+    if (first_edge->dependency != second_edge->dependency)
+        return first_edge->dependency < second_edge->dependency ? -1 : 1;
+
+    return (first_edge->dependent > second_edge->dependent) - (first_edge->dependent < second_edge->dependent);
+}
+
+static bool lo_has_image_extension(const char* name, size_t length)
+{
+    size_t extension_length = sizeof(LOAD_ORDER_IMAGE_EXTENSION) - 1;
+    if (length < extension_length) return false;
+
+    return !lo_compare_names(name + length - extension_length, extension_length, LOAD_ORDER_IMAGE_EXTENSION, extension_length);
+}
+
+static void lo_init_entry(const char* path, load_order_entry_t* entry)
+{
+    const char* name = path;
+    for (const char* p = path; *p; p++)
+    {
+        if (*p == '\\' || *p == '/') name = p + 1;
+    }
+
+    size_t name_length = strlen(name);
+    if (lo_has_image_extension(name, name_length))
+        name_length -= sizeof(LOAD_ORDER_IMAGE_EXTENSION) - 1;
+
+    entry->path = path;
+    entry->name = name;
+    entry->name_length = name_length;
+    entry->priority = 0;
+    entry->rank = 0;
+    entry->pending = 0;
+    entry->first_dependent = 0;
+    entry->dependent_count = 0;
+    entry->emitted = false;
+}
+
+static int lo_add_edge(load_order_t* order, size_t dependency, size_t dependent)
+{
+    if (order->edge_count == order->edge_capacity)
+    {
+        size_t capacity = order->edge_capacity ? order->edge_capacity * 2 : 16;
+        load_order_edge_t* edges = (load_order_edge_t*)realloc(order->edges, capacity * sizeof(load_order_edge_t));
+        if (!edges) return MSL_ALLOCATION_ERROR;
+
+        order->edges = edges;
+        order->edge_capacity = capacity;
+    }
+
+    order->edges[order->edge_count].dependency = dependency;
+    order->edges[order->edge_count].dependent = dependent;
+    order->edge_count++;
+    return MSL_SUCCESS;
+}
+
+// Every module with that name becomes a dependency, names that match nothing are ignored
+static int lo_add_requirement(load_order_t* order, size_t dependent, const char* name, size_t name_length)
+{
+    int last_status = MSL_SUCCESS;
+
+    if (lo_has_image_extension(name, name_length))
+        name_length -= sizeof(LOAD_ORDER_IMAGE_EXTENSION) - 1;
+
+    // Lower bound in by_name
+    size_t low = 0;
+    size_t high = order->count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        const load_order_entry_t* entry = &order->entries[order->by_name[middle]];
+        if (lo_compare_names(entry->name, entry->name_length, name, name_length) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (; low < order->count; low++)
+    {
+        size_t dependency = order->by_name[low];
+        const load_order_entry_t* entry = &order->entries[dependency];
+        if (lo_compare_names(entry->name, entry->name_length, name, name_length)) break;
+        if (dependency == dependent) continue;
+
+        CHECK_CALL(lo_add_edge, order, dependency, dependent);
+    }
+
+    return last_status;
+}
+
+static char* lo_trim(char* text)
+{
+    while (isspace((unsigned char)*text)) text++;
+
+    size_t length = strlen(text);
+    while (length && isspace((unsigned char)text[length - 1])) text[--length] = 0;
+
+    return text;
+}
+
+static int lo_apply_manifest_entry(const char* key, const char* value, void* context)
+{
+    int last_status = MSL_SUCCESS;
+    load_order_manifest_context_t* manifest_context = (load_order_manifest_context_t*)context;
+    load_order_entry_t* entry = &manifest_context->order->entries[manifest_context->index];
+
+    if (!stricmp(key, "priority"))
+    {
+        entry->priority = (int32_t)strtol(value, NULL, 10);
+    }
+    else if (!stricmp(key, "requires") && *value)
+    {
+        CHECK_CALL(lo_add_requirement, manifest_context->order, manifest_context->index, value, strlen(value));
+    }
+
+    return last_status;
+}
+
+static int lo_read_manifest(load_order_t* order, size_t index)
+{
+    int last_status = MSL_SUCCESS;
+    load_order_manifest_context_t context = { .order = order, .index = index };
+    CHECK_CALL(lo_read_manifest_entries, order->entries[index].path, lo_apply_manifest_entry, &context);
+    return last_status;
+}
+
+// Calls on_entry for every "key = value" line of the manifest of the image, keys it doesn't know included.
+// A missing manifest is not an error, the module just has nothing to declare.
+int lo_read_manifest_entries(const char* image_path, int(*on_entry)(const char*, const char*, void*), void* context)
+{
+    int last_status = MSL_SUCCESS;
+    char manifest_path[WALKER_PATH_CAPACITY];
+    char line[LOAD_ORDER_LINE_CAPACITY];
+    load_order_entry_t entry;
+
+    // foo.dll => foo.deps, next to it
+    lo_init_entry(image_path, &entry);
+    size_t stem_length = (size_t)(entry.name - entry.path) + entry.name_length;
+    if (stem_length + sizeof(LOAD_ORDER_MANIFEST_EXTENSION) > WALKER_PATH_CAPACITY) return MSL_INVALID_PARAMETER;
+
+    memcpy(manifest_path, entry.path, stem_length);
+    memcpy(manifest_path + stem_length, LOAD_ORDER_MANIFEST_EXTENSION, sizeof(LOAD_ORDER_MANIFEST_EXTENSION));
+
+    FILE* file = fopen(manifest_path, "r");
+    if (!file) return MSL_SUCCESS;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        // A line longer than the buffer is dropped whole rather than read as several lines
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n' && !feof(file))
+        {
+            int c;
+            while ((c = fgetc(file)) != EOF && c != '\n');
+            continue;
+        }
+
+        char* comment = strchr(line, '#');
+        if (comment) *comment = 0;
+
+        char* separator = strchr(line, '=');
+        if (!separator) continue;
+
+        *separator = 0;
+        char* key = lo_trim(line);
+        char* value = lo_trim(separator + 1);
+
+        CHECK_CALL_GOTO_ERROR(on_entry, cleanup, key, value, context);
+    }
+
+    cleanup:
+    fclose(file);
+    return last_status;
+}
+
+// Highest priority first, then by name
+static bool lo_goes_before(const load_order_t* order, size_t first, size_t second)
+{
+    const load_order_entry_t* first_entry = &order->entries[first];
+    const load_order_entry_t* second_entry = &order->entries[second];
+
+    if (first_entry->priority != second_entry->priority)
+        return first_entry->priority > second_entry->priority;
+
+    return first_entry->rank < second_entry->rank;
+}
+
+static void lo_heap_push(load_order_t* order, size_t index)
+{
+    size_t position = order->heap_size++;
+    while (position)
+    {
+        size_t parent = (position - 1) / 2;
+        if (!lo_goes_before(order, index, order->heap[parent])) break;
+
+        order->heap[position] = order->heap[parent];
+        position = parent;
+    }
+
+    order->heap[position] = index;
+}
+
+static size_t lo_heap_pop(load_order_t* order)
+{
+    size_t top = order->heap[0];
+    size_t last = order->heap[--order->heap_size];
+    size_t position = 0;
+
+    for (;;)
+    {
+        size_t child = position * 2 + 1;
+        if (child >= order->heap_size) break;
+        if (child + 1 < order->heap_size && lo_goes_before(order, order->heap[child + 1], order->heap[child])) child++;
+        if (!lo_goes_before(order, order->heap[child], last)) break;
+
+        order->heap[position] = order->heap[child];
+        position = child;
+    }
+
+    if (order->heap_size) order->heap[position] = last;
+    return top;
+}
+
+static void lo_free(load_order_t* order)
+{
+    free(order->entries);
+    free(order->by_name);
+    free(order->edges);
+    free(order->dependents);
+    free(order->heap);
+}
+
+// result[i] is the index in paths of the i-th module to load.
+// The same set of files always gives the same order, whatever order they were found in.
+// Modules caught in a requirement cycle are loaded by priority then name once nothing else is ready.
+int lo_sort(const char* const* paths, size_t count, size_t* result)
+{
+    int last_status = MSL_SUCCESS;
+    load_order_t order;
+    memset(&order, 0, sizeof(order));
+
+    if (!count) return MSL_SUCCESS;
+
+    order.count = count;
+    order.entries = (load_order_entry_t*)malloc(count * sizeof(load_order_entry_t));
+    order.by_name = (size_t*)malloc(count * sizeof(size_t));
+    order.heap = (size_t*)malloc(count * sizeof(size_t));
+    if (!order.entries || !order.by_name || !order.heap)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        lo_init_entry(paths[i], &order.entries[i]);
+        order.by_name[i] = i;
+    }
+
+    // The heap is still empty, it serves as scratch
+    lo_sort_by_name(order.entries, order.by_name, order.heap, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        order.entries[order.by_name[i]].rank = i;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK_CALL_GOTO_ERROR(lo_read_manifest, cleanup, &order, i);
+    }
+
+    // Group the edges by dependency, requiring the same module twice only counts once
+    if (order.edge_count)
+    {
+        qsort(order.edges, order.edge_count, sizeof(load_order_edge_t), lo_edge_comparator);
+
+        order.dependents = (size_t*)malloc(order.edge_count * sizeof(size_t));
+        if (!order.dependents)
+        {
+            last_status = MSL_ALLOCATION_ERROR;
+            goto cleanup;
+        }
+    }
+
+    size_t dependent_count = 0;
+    for (size_t i = 0; i < order.edge_count; i++)
+    {
+        const load_order_edge_t* edge = &order.edges[i];
+        if (i && !lo_edge_comparator(edge, &order.edges[i - 1])) continue;
+
+        load_order_entry_t* dependency = &order.entries[edge->dependency];
+        if (!dependency->dependent_count) dependency->first_dependent = dependent_count;
+        dependency->dependent_count++;
+
+        order.dependents[dependent_count++] = edge->dependent;
+        order.entries[edge->dependent].pending++;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!order.entries[i].pending) lo_heap_push(&order, i);
+    }
+
+    for (size_t emitted = 0; emitted < count; emitted++)
+    {
+        // Only cycles are left, break the one with the module that would go first
+        if (!order.heap_size)
+        {
+            size_t best = SIZE_MAX;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (order.entries[i].emitted) continue;
+                if (best == SIZE_MAX || lo_goes_before(&order, i, best)) best = i;
+            }
+
+            order.entries[best].pending = 0;
+            lo_heap_push(&order, best);
+        }
+
+        size_t next = lo_heap_pop(&order);
+        load_order_entry_t* entry = &order.entries[next];
+        entry->emitted = true;
+        result[emitted] = next;
+
+        for (size_t i = 0; i < entry->dependent_count; i++)
+        {
+            load_order_entry_t* dependent = &order.entries[order.dependents[entry->first_dependent + i]];
+            if (dependent->emitted || !dependent->pending) continue;
+
+            if (!--dependent->pending) lo_heap_push(&order, order.dependents[entry->first_dependent + i]);
+        }
+    }
+
+    cleanup:
+    lo_free(&order);
+    return last_status;
+}
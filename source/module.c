@@ -3,11 +3,14 @@
 // This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
 
 #include "../include/module.h"
+#include "../include/module_table.h"
 #include "../include/error.h"
 #include "../include/object.h"
 #include "../include/pe_parser.h"
 #include "../include/memory_management.h"
 #include "../include/early_launch.h"
+#include "../include/worker_pool.h"
+#include "../include/load_order.h"
 #include "Psapi.h"
 
 #ifdef WIN32
@@ -16,27 +19,40 @@
 #define access _access
 #endif
 
-VECTOR(module_t) global_module_list;
+module_table_t global_module_table;
+static module_index_t global_module_index;
+static bool global_lazy_initialization;
+startup_timings_t global_startup_timings;
+
+FUNC_HASH(file_identity_t, int32_t)
 
 int mdp_create_module(const char* image_path, HMODULE image_module, bool process_exports, uint8_t bit_flags, module_t* module)
 {
     int last_status = MSL_SUCCESS;
     module_t temp_module;
+    memset(&temp_module, 0, sizeof(temp_module));
 
     // Populate known fields first
     temp_module.flags.bitfield = bit_flags;
-    temp_module.image_path = (char*)image_path;
+
+    // The module keeps its own copy, it's freed when the module leaves the list
+    temp_module.image_path = strdup(image_path);
+    if (!temp_module.image_path) return MSL_ALLOCATION_ERROR;
 
     if (process_exports)
     {
-        CHECK_CALL(mdp_process_image_exports, image_path, image_module, &temp_module);
+        CHECK_CALL_GOTO_ERROR(mdp_process_image_exports, cleanup, image_path, image_module, &temp_module);
     }
 
-    CHECK_CALL(mdp_query_module_information, image_module, &temp_module.image_base.pointer, &temp_module.image_size, &temp_module.image_entrypoint.pointer);
+    CHECK_CALL_GOTO_ERROR(mdp_query_module_information, cleanup, image_module, &temp_module.image_base.pointer, &temp_module.image_size, &temp_module.image_entrypoint.pointer);
 
     *module = temp_module;
 
     return last_status;
+
+    cleanup:
+    free(temp_module.image_path);
+    return last_status;
 }
 
 int mdp_is_module_marked_for_purge(module_t* module, bool* flag)
@@ -53,129 +69,404 @@ int mdp_mark_module_for_purge(module_t* module)
     return last_status;
 }
 
-static int predicate_purge(module_t* module, void* context, bool* flag)
-{
-    UNREFERENCED_PARAMETER(context);
-    return mdp_is_module_marked_for_purge(module, flag);
-}
-
 int mdp_purge_marked_modules(void)
 {
     int last_status = MSL_SUCCESS;
     module_t* module = NULL;
     bool purge_flag = false;
-    // Loop through all the modules marked for purge
-    for(size_t i = 0; i < global_module_list.size; i++)
+    // Loop through all the modules marked for purge, backwards since removing
+    // a module moves the last one in its place
+    for (size_t i = global_module_table.count; i-- > 0; )
     {
-        module = &global_module_list.arr[i];
+        module = global_module_table.modules[i];
         CHECK_CALL(mdp_is_module_marked_for_purge, module, &purge_flag);
 
         if (purge_flag)
         {
-            // Unmap the module, but don't call the unload routine, and don't remove it from the list
+            // Unmap the module, but don't call the unload routine
             CHECK_CALL(mdp_unmap_image, module, false, false);
+            CHECK_CALL(mdp_remove_module_from_list, module);
         }
     }
 
-    // Remove the now unloaded modules from our list
-    // Note we can't do this in the for loop, since that'd invalidate the iterators
-    CHECK_CALL(REMOVE_VECTOR_IF(module_t), &global_module_list, predicate_purge, NULL, NULL);
     return last_status;
 }
 
 int mdp_map_image(const char* image_path, HMODULE* image_base)
 {
-    // If the file doesn't exist, we have nothing to map
-    if (access(image_path, F_OK)) return MSL_FILE_NOT_FOUND;
-
     int last_status = MSL_SUCCESS;
-    unsigned short target_arch = 0;
     unsigned short self_arch = 0;
-    
-    // Query the target image architecture
-    CHECK_CALL(pp_query_image_architecture, image_path, &target_arch);
+    module_candidate_t candidate;
 
     // Query the current architecture
     CHECK_CALL(pp_get_current_architecture, &self_arch);
 
-    // Don't try to load modules which are the wrong architecture
-    if (target_arch != self_arch) return MSL_INVALID_ARCH;
+    CHECK_CALL(mdp_validate_image, image_path, self_arch, &candidate);
+    CHECK_CALL(mdp_load_validated_image, &candidate, image_base, NULL);
+    return last_status;
+}
+
+// Reads the file once and checks everything that can be checked without loading it.
+// Only touches the file, so images can be validated from several threads at once.
+int mdp_validate_image(const char* image_path, unsigned short self_arch, module_candidate_t* candidate)
+{
+    int last_status = MSL_SUCCESS;
+    void* image = NULL;
+    size_t image_size = 0;
+
+    memset(candidate, 0, sizeof(*candidate));
+    candidate->image_path = image_path;
+
+    // If the file doesn't exist, we have nothing to map
+    if (access(image_path, F_OK))
+    {
+        last_status = MSL_FILE_NOT_FOUND;
+        goto ret;
+    }
+
+    last_status = ppi_map_file_to_memory_alloc(image_path, &image, &image_size);
+    if (last_status != MSL_SUCCESS) goto ret;
+
+    // Query the target image architecture
+    last_status = ppi_query_image_architecture(image, &candidate->architecture);
+    if (last_status != MSL_SUCCESS) goto ret;
 
-    // Make sure the image has the required exports
-    uintptr_t framework_init;
-    uintptr_t module_entry;
-    uintptr_t module_preinit;
+    // Don't try to load modules which are the wrong architecture
+    if (candidate->architecture != self_arch)
+    {
+        last_status = MSL_INVALID_ARCH;
+        goto ret;
+    }
 
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "__AurieFrameworkInit", &framework_init);
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "ModuleInitialize", &module_entry);
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "ModulePreinitialize", &module_preinit);
+    // Missing exports are expected, they are left at 0
+    ppi_get_export_offset(image, "__AurieFrameworkInit", &candidate->framework_initialize_offset);
+    ppi_get_export_offset(image, "ModuleInitialize", &candidate->module_initialize_offset);
+    ppi_get_export_offset(image, "ModulePreinitialize", &candidate->module_preinitialize_offset);
+    ppi_get_export_offset(image, "ModuleOperationCallback", &candidate->module_operation_callback_offset);
+    ppi_get_export_offset(image, "ModuleUnload", &candidate->module_unload_offset);
+    ppi_get_export_offset(image, "ModuleHotReload", &candidate->module_hot_reload_offset);
 
     // If the image doesn't have a framework init function, we can't load it.
-    if (framework_init) return MSL_INVALID_SIGNATURE;
+    // If we don't have a module entry OR a module preinitialize function, we can't load either.
+    bool has_either_entry = candidate->module_initialize_offset || candidate->module_preinitialize_offset;
+    if (!candidate->framework_initialize_offset || !has_either_entry)
+        last_status = MSL_INVALID_SIGNATURE;
 
-    // If we don't have a module entry OR a module preinitialize function, we can't load.
-    bool has_either_entry = module_entry || module_preinit;
-    if (!has_either_entry) return MSL_INVALID_SIGNATURE;
+    ret:
+    if (image) free(image);
+    candidate->status = last_status;
+    return last_status;
+}
+
+typedef struct validation_context_s
+{
+    module_candidate_t* candidates;
+    unsigned short self_arch;
+} validation_context_t;
+
+static void validate_candidate(void* context, size_t index)
+{
+    validation_context_t* validation_context = (validation_context_t*)context;
+    module_candidate_t* candidate = &validation_context->candidates[index];
+
+    // The outcome is kept in candidate->status
+    mdp_validate_image(candidate->image_path, validation_context->self_arch, candidate);
+}
+
+// Validates every candidate on the worker pool, image_path must be set on each of them.
+// Failed candidates are not an error, their status tells why.
+int mdp_validate_images(module_candidate_t* candidates, size_t count)
+{
+    int last_status = MSL_SUCCESS;
+    validation_context_t context;
+    context.candidates = candidates;
+
+    // Query the current architecture once, workers only read files
+    CHECK_CALL(pp_get_current_architecture, &context.self_arch);
+    CHECK_CALL(wp_run, count, 0, validate_candidate, &context);
+    return last_status;
+}
+
+// Windows keeps a loaded image locked, so a build couldn't replace a module that can be hot reloaded.
+// Those are loaded from a copy next to them instead, shadow_path receives it and is NULL otherwise.
+// Copies don't end in .dll, neither the hot reload watcher nor mdp_map_folder pick them up.
+static int mdp_load_image_file(const char* image_path, bool hot_reloadable, HMODULE* image_base, char** shadow_path)
+{
+    static uint32_t shadow_count = 0;
+    const char* load_path = image_path;
+    char* copy_path = NULL;
+
+    if (shadow_path) *shadow_path = NULL;
+
+    if (hot_reloadable && shadow_path)
+    {
+        // Numbered, the copy of the previous build may still be loaded
+        size_t capacity = strlen(image_path) + sizeof(MODULE_SHADOW_EXTENSION) + 12;
+        copy_path = (char*)malloc(capacity);
+        if (!copy_path) return MSL_ALLOCATION_ERROR;
+
+        snprintf(copy_path, capacity, "%s.%u" MODULE_SHADOW_EXTENSION, image_path, ++shadow_count);
+        if (!CopyFileA(image_path, copy_path, FALSE))
+        {
+            free(copy_path);
+            return MSL_EXTERNAL_ERROR;
+        }
+
+        load_path = copy_path;
+    }
+
+    HMODULE image_module = LoadLibraryA(load_path);
+    if (!image_module)
+    {
+        mdp_delete_shadow_copy(&copy_path);
+        return MSL_EXTERNAL_ERROR;
+    }
+
+    *image_base = image_module;
+    if (shadow_path) *shadow_path = copy_path;
+    return MSL_SUCCESS;
+}
+
+// Only once the image it holds is unloaded
+void mdp_delete_shadow_copy(char** shadow_path)
+{
+    if (!*shadow_path) return;
+
+    DeleteFileA(*shadow_path);
+    free(*shadow_path);
+    *shadow_path = NULL;
+}
+
+// The order-sensitive part of mapping, has to run on the loading thread.
+// shadow_path can be NULL to always load the image in place.
+int mdp_load_validated_image(const module_candidate_t* candidate, HMODULE* image_base, char** shadow_path)
+{
+    if (candidate->status != MSL_SUCCESS) return candidate->status;
 
     module_t* potential_loaded_copy = NULL;
-    CHECK_CALL(mdp_lookup_module_by_path, image_path, &potential_loaded_copy);
-    
+
     // If there's a module that's already loaded from the same path, deny loading it twice
-    if (last_status == MSL_SUCCESS) return MSL_OBJECT_ALREADY_EXISTS;
+    if (mdp_lookup_module_by_path(candidate->image_path, &potential_loaded_copy) == MSL_SUCCESS)
+        return MSL_OBJECT_ALREADY_EXISTS;
 
     // Load the image into memory and make sure we loaded it
-    HMODULE image_module = LoadLibraryW((LPCWSTR)image_path);
-    if (!image_module) return MSL_EXTERNAL_ERROR;
+    return mdp_load_image_file(candidate->image_path, candidate->module_hot_reload_offset != 0, image_base, shadow_path);
+}
 
-    *image_base = image_module;
+// length doesn't count the terminator
+int mdp_path_list_add(module_path_list_t* list, const char* path, size_t length)
+{
+    if (list->arena_size + length + 1 > list->arena_capacity)
+    {
+        size_t capacity = list->arena_capacity ? list->arena_capacity : MODULE_PATH_ARENA_CAPACITY;
+        while (list->arena_size + length + 1 > capacity) capacity *= 2;
+
+        char* arena = (char*)realloc(list->arena, capacity);
+        if (!arena) return MSL_ALLOCATION_ERROR;
+
+        list->arena = arena;
+        list->arena_capacity = capacity;
+    }
+
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : MODULE_PATH_LIST_CAPACITY;
+        size_t* offsets = (size_t*)realloc(list->offsets, capacity * sizeof(size_t));
+        if (!offsets) return MSL_ALLOCATION_ERROR;
+
+        list->offsets = offsets;
+        list->capacity = capacity;
+    }
+
+    memcpy(list->arena + list->arena_size, path, length);
+    list->arena[list->arena_size + length] = 0;
+    list->offsets[list->count++] = list->arena_size;
+    list->arena_size += length + 1;
+    return MSL_SUCCESS;
+}
+
+// The path stays valid until the next add or until the arena is freed
+int mdp_path_list_get(const module_path_list_t* list, size_t index, const char** path)
+{
+    if (index >= list->count) return MSL_INVALID_PARAMETER;
+
+    *path = list->arena + list->offsets[index];
     return MSL_SUCCESS;
 }
 
-int mdp_build_module_list(const char* base_folder, bool recursive, int(*predicate)(const char*, bool*), VECTOR(str)* files)
+int mdp_path_list_free(module_path_list_t* list)
+{
+    if (!list) return MSL_NULL_BUFFER;
+
+    free(list->arena);
+    free(list->offsets);
+    memset(list, 0, sizeof(*list));
+    return MSL_SUCCESS;
+}
+
+// Only files ending with extension are kept, the walker checks it without allocating
+int mdp_build_module_list(const char* base_folder, bool recursive, const char* extension, module_path_list_t* files)
 {
-    UNREFERENCED_PARAMETER(recursive);
     int last_status = MSL_SUCCESS;
-    files->size= 0;
-    char tmp_path[MAX_PATH];
-    tmp_path[0] = 0;
-    const char* pointer_tmp = &tmp_path[0];
+    memset(files, 0, sizeof(*files));
 
-    directory_iterator_t* iter = NULL;
-    CHECK_CALL(iterator_create_alloc, base_folder, "*", &iter);
+    directory_walker_t walker;
+    CHECK_CALL_GOTO_ERROR(walker_open, cleanup, base_folder, extension, recursive ? WALKER_MAX_DEPTH : 0, &walker);
 
-    bool flag;
-    do
+    bool found;
+    for (;;)
     {
-        strcpy(tmp_path, iter->current_path);
-        tmp_path[MAX_PATH-1] = 0;
-        strcat(tmp_path, iter->find_data.cFileName);
-        tmp_path[MAX_PATH-1] = 0;
-        CHECK_CALL(predicate, tmp_path, &flag);
+        CHECK_CALL_GOTO_ERROR(walker_next, cleanup, &walker, &found);
+        if (!found) break;
 
-        if (flag)
-        {
-            // cant call &tmp_path, since it will have the type char(*)[MAX_PATH], note the char** type
-            // remember arrays are not pointers
-            CHECK_CALL(ADD_VECTOR(str), files, &pointer_tmp);
-        }
+        CHECK_CALL_GOTO_ERROR(mdp_path_list_add, cleanup, files, walker.path, walker.path_length);
+    }
 
-        if (iter->find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) 
-        {
-            if (iterator_enter_directory_alloc(iter)) 
-            {
-                continue;  // Successfully entered directory
-            }
-        }
-    } while (iterator_next(iter));
+    walker_close(&walker);
+    return last_status;
+
+    cleanup:
+    walker_close(&walker);
+    mdp_path_list_free(files);
+    return last_status;
+}
+
+// stored receives the module kept in global_module_table, it doesn't move until it's removed.
+// module gets the handle too, so copies of it can still find the stored one.
+int mdp_add_module_to_list(module_t* module, module_t** stored)
+{
+    int last_status = MSL_SUCCESS;
+    module_t* table_module = NULL;
+    CHECK_CALL(mt_insert, &global_module_table, module, &table_module);
+    module->handle = table_module->handle;
+
+    if (stored)
+        *stored = table_module;
+
+    CHECK_CALL(mdp_index_add_module, table_module);
+    return last_status;
+}
+
+// module can be a copy, the stored module is the one removed
+int mdp_remove_module_from_list(module_t* module)
+{
+    int last_status = MSL_SUCCESS;
+    module_t* table_module = NULL;
+    if (mt_resolve(&global_module_table, module->handle, &table_module) != MSL_SUCCESS) return MSL_OBJECT_NOT_IN_LIST;
+
+    // Names a lazy module declared are freed with it
+    CHECK_CALL(obp_release_reserved_interfaces, table_module);
+
+    CHECK_CALL(mdp_index_remove_module, table_module);
+
+    char* image_path = table_module->image_path;
+    char* shadow_path = table_module->shadow_path;
+    CHECK_CALL(mt_remove, &global_module_table, table_module->handle);
+    free(image_path);
+    mdp_delete_shadow_copy(&shadow_path);
+    return last_status;
+}
+
+static int mdp_index_insert_keys(const module_index_keys_t* keys, int32_t slot)
+{
+    int last_status = MSL_SUCCESS;
+
+    if (keys->path)
+    {
+        CHECK_CALL(INSERT(str, int32_t), &global_module_index.by_path, keys->path, slot);
+    }
+
+    if (keys->has_identity)
+    {
+        CHECK_CALL(INSERT(file_identity_t, int32_t), &global_module_index.by_identity, keys->identity, slot);
+    }
+
+    return last_status;
+}
+
+static void mdp_index_erase_keys(module_index_keys_t* keys)
+{
+    if (keys->path)
+    {
+        REMOVE(str, int32_t)(&global_module_index.by_path, keys->path);
+        free(keys->path);
+        keys->path = NULL;
+    }
+
+    if (keys->has_identity)
+    {
+        REMOVE(file_identity_t, int32_t)(&global_module_index.by_identity, keys->identity);
+        keys->has_identity = false;
+    }
+}
+
+static int mdp_index_compute_keys(const module_t* module, module_index_keys_t* keys)
+{
+    char path[WALKER_PATH_CAPACITY];
+    size_t length = 0;
+
+    keys->path = NULL;
+    keys->has_identity = false;
+    if (!module->image_path) return MSL_SUCCESS;
+
+    if (canonical_path(module->image_path, path, sizeof(path), &length) == MSL_SUCCESS)
+    {
+        keys->path = (char*)malloc(length + 1);
+        if (!keys->path) return MSL_ALLOCATION_ERROR;
+
+        memcpy(keys->path, path, length + 1);
+    }
+
+    // The file can be gone already, the path is enough then
+    keys->has_identity = get_file_identity(module->image_path, &keys->identity) == MSL_SUCCESS;
+    return MSL_SUCCESS;
+}
+
+// The module has to be in global_module_table already, its slot keeps its keys
+int mdp_index_add_module(const module_t* module)
+{
+    int last_status = MSL_SUCCESS;
+    uint32_t slot = MODULE_HANDLE_SLOT(module->handle);
+    if (slot >= global_module_table.slot_count) return MSL_OBJECT_NOT_IN_LIST;
 
-    CHECK_CALL(iterator_destroy, iter);
+    // The table grows a chunk at a time, so does the index
+    if (global_module_table.slot_count > global_module_index.capacity)
+    {
+        size_t capacity = global_module_table.slot_count;
+        module_index_keys_t* keys = (module_index_keys_t*)realloc(global_module_index.keys, capacity * sizeof(module_index_keys_t));
+        if (!keys) return MSL_ALLOCATION_ERROR;
+
+        memset(keys + global_module_index.capacity, 0, (capacity - global_module_index.capacity) * sizeof(module_index_keys_t));
+        global_module_index.keys = keys;
+        global_module_index.capacity = capacity;
+    }
+
+    module_index_keys_t* keys = &global_module_index.keys[slot];
+    CHECK_CALL(mdp_index_compute_keys, module, keys);
+    CHECK_CALL(mdp_index_insert_keys, keys, (int32_t)slot);
     return last_status;
 }
 
-int mdp_add_module_to_list(module_t* module)
+int mdp_index_remove_module(const module_t* module)
+{
+    uint32_t slot = MODULE_HANDLE_SLOT(module->handle);
+    if (slot >= global_module_index.capacity) return MSL_OBJECT_NOT_IN_LIST;
+
+    mdp_index_erase_keys(&global_module_index.keys[slot]);
+    return MSL_SUCCESS;
+}
+
+// For a module whose image changed while staying in the same slot
+int mdp_index_update_module(const module_t* module)
 {
     int last_status = MSL_SUCCESS;
-    CHECK_CALL(ADD_VECTOR(module_t), &global_module_list, module);
+    uint32_t slot = MODULE_HANDLE_SLOT(module->handle);
+    if (slot >= global_module_index.capacity) return MSL_OBJECT_NOT_IN_LIST;
+
+    module_index_keys_t* keys = &global_module_index.keys[slot];
+    mdp_index_erase_keys(keys);
+    CHECK_CALL(mdp_index_compute_keys, module, keys);
+    CHECK_CALL(mdp_index_insert_keys, keys, (int32_t)slot);
     return last_status;
 }
 
@@ -225,17 +516,13 @@ int mdp_get_image_folder_alloc(module_t* module, char** path)
 
 int mdp_get_next_module(module_t* module, module_t** next_module)
 {
-    // Find the module in our list (gets an iterator)
-    for (size_t i = 0; i < global_module_list.size; i++)
-    {
-        if (&global_module_list.arr[i] == module)
-        {
-            *next_module = &global_module_list.arr[(i + 1) % global_module_list.size];    
-            return MSL_SUCCESS;
-        }
-    }
+    // The handle gives the position of the module in the table
+    module_t* table_module = NULL;
+    if (mt_resolve(&global_module_table, module->handle, &table_module) != MSL_SUCCESS) return MSL_INVALID_PARAMETER;
 
-    return MSL_INVALID_PARAMETER;
+    size_t position = global_module_table.dense_positions[MODULE_HANDLE_SLOT(module->handle)];
+    *next_module = global_module_table.modules[(position + 1) % global_module_table.count];
+    return MSL_SUCCESS;
 }
 
 int mdp_get_module_base_address(module_t* module, void** ptr)
@@ -245,19 +532,24 @@ int mdp_get_module_base_address(module_t* module, void** ptr)
     return last_status;
 }
 
+// Looked up by path first, then by file identity which opens the file once
 int mdp_lookup_module_by_path(const char* module_path, module_t** module)
 {
-    int last_status = MSL_SUCCESS;
-    int equivalent;
-    for (size_t i = 0; i < global_module_list.size; i++)
+    char path[WALKER_PATH_CAPACITY];
+    size_t length = 0;
+    int32_t slot = 0;
+    file_identity_t identity;
+
+    if (canonical_path(module_path, path, sizeof(path), &length) == MSL_SUCCESS &&
+        GET_VALUE(str, int32_t)(&global_module_index.by_path, path, &slot) == MSL_SUCCESS)
     {
-        CHECK_CALL(paths_are_equivalent, module_path, global_module_list.arr[i].image_path, &equivalent);
+        return mt_get_slot(&global_module_table, (uint32_t)slot, module);
+    }
 
-        if (equivalent)
-        {
-            *module = &global_module_list.arr[i];
-            return MSL_SUCCESS;
-        }
+    if (get_file_identity(module_path, &identity) == MSL_SUCCESS &&
+        GET_VALUE(file_identity_t, int32_t)(&global_module_index.by_identity, identity, &slot) == MSL_SUCCESS)
+    {
+        return mt_get_slot(&global_module_table, (uint32_t)slot, module);
     }
 
     return MSL_INVALID_PARAMETER;
@@ -265,66 +557,74 @@ int mdp_lookup_module_by_path(const char* module_path, module_t** module)
 
 int mdp_process_image_exports(const char* image_path, HMODULE image_base_address, module_t* module_image)
 {
-    // Find all the required functions
     int last_status = MSL_SUCCESS;
-    uintptr_t framework_init_offset;
-    uintptr_t module_init_offset;
-    uintptr_t module_preload_offset;
-    uintptr_t module_callback_offset;
-    uintptr_t module_unload_offset;
+    unsigned short self_arch = 0;
+    module_candidate_t candidate;
 
+    // Find all the required functions
+    CHECK_CALL(pp_get_current_architecture, &self_arch);
+    CHECK_CALL(mdp_validate_image, image_path, self_arch, &candidate);
+    CHECK_CALL(mdp_apply_image_exports, &candidate, image_base_address, module_image);
+    return last_status;
+}
+
+int mdp_apply_image_exports(const module_candidate_t* candidate, HMODULE image_base_address, module_t* module_image)
+{
     // We always need __AurieFrameworkInit to exist.
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "__AurieFrameworkInit", &framework_init_offset);
-    if (framework_init_offset) return MSL_FILE_PART_NOT_FOUND;
+    if (!candidate->framework_initialize_offset) return MSL_FILE_PART_NOT_FOUND;
 
     // We also need either a ModuleInitialize or a ModulePreinitialize function.
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "ModuleInitialize", &module_init_offset);
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "ModulePreinitialize", &module_preload_offset);
-    if (module_init_offset || module_preload_offset) return MSL_FILE_PART_NOT_FOUND;
-
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "ModuleOperationCallback", &module_callback_offset);
-    CHECK_CALL(pp_find_file_export_by_name, image_path, "ModuleUnload", &module_unload_offset);
+    if (!candidate->module_initialize_offset && !candidate->module_preinitialize_offset) return MSL_FILE_PART_NOT_FOUND;
 
     // Cast the problems away
     char* image_base = (char*)(image_base_address);
 
-    Entry module_init = (Entry)(image_base + module_init_offset);
-    Entry module_preload = (Entry)(image_base + module_preload_offset);
-    Entry module_unload = (Entry)(image_base + module_unload_offset);
-    LoaderEntry framework_init = (LoaderEntry)(image_base + framework_init_offset);
-    ModuleCallback module_callback = (ModuleCallback)(image_base + module_callback_offset);
+    Entry module_init = (Entry)(image_base + candidate->module_initialize_offset);
+    Entry module_preload = (Entry)(image_base + candidate->module_preinitialize_offset);
+    Entry module_unload = (Entry)(image_base + candidate->module_unload_offset);
+    LoaderEntry framework_init = (LoaderEntry)(image_base + candidate->framework_initialize_offset);
+    ModuleCallback module_callback = (ModuleCallback)(image_base + candidate->module_operation_callback_offset);
+    Entry module_hot_reload = (Entry)(image_base + candidate->module_hot_reload_offset);
 
     // If the offsets are zero, the function wasn't found, which means we shouldn't populate the field.
-    if (module_init_offset)
+    if (candidate->module_initialize_offset)
         module_image->module_initialize = module_init;
 
-    if (module_preload_offset)
+    if (candidate->module_preinitialize_offset)
         module_image->module_preinitialize = module_preload;
 
-    if (framework_init_offset)
+    if (candidate->framework_initialize_offset)
         module_image->framework_initialize = framework_init;
 
-    if (module_callback_offset)
+    if (candidate->module_operation_callback_offset)
         module_image->module_operation_callback = module_callback;
 
-    if (module_unload_offset)
+    if (candidate->module_unload_offset)
         module_image->module_unload = module_unload;
 
-    return last_status;
+    if (candidate->module_hot_reload_offset)
+        module_image->module_hot_reload = module_hot_reload;
+
+    return MSL_SUCCESS;
 }
 
 int mdp_unmap_image(module_t* module, bool remove_from_list, bool call_unload_routine)
 {
     int last_status = MSL_SUCCESS;
 
+    // Work on the stored module when given a copy of it
+    module_t* table_module = NULL;
+    if (mt_resolve(&global_module_table, module->handle, &table_module) == MSL_SUCCESS)
+        module = table_module;
+
     // We don't have to do anything else, since SafetyHook will handle everything for us.
     // Truly a GOATed library, thank you @localcc for telling me about it love ya
     // C note: inline_hook_t and mid_hooks_t need a custom destructor to call the destructor from SafetyHook
     CHECK_CALL(CLEAR_VECTOR(inline_hook_t), &module->inline_hooks, destructor_inline_hook_t);
     CHECK_CALL(CLEAR_VECTOR(mid_hook_t), &module->mid_hooks, destructor_mid_hook_t);
 
-    // Call the unload entry if needed
-    if (call_unload_routine)
+    // Call the unload entry if needed, a lazy module never ran
+    if (call_unload_routine && !module->flags.is_lazy)
     {
         CHECK_CALL(mdp_dispatch_entry, module, module->module_unload);
     }
@@ -332,9 +632,13 @@ int mdp_unmap_image(module_t* module, bool remove_from_list, bool call_unload_ro
     // Remove the module's operation callback
     module->module_operation_callback = NULL;
 
+    // Event callbacks point into the image too
+    CHECK_CALL(remove_module_callbacks, &global_module_interface, module);
+
     // Destory all interfaces created by the module
     for (size_t i = 0; i < module->interface_table.size; i++)
     {
+        obp_unregister_interface(module->interface_table.arr[i].interface_name);
         CHECK_CALL(module->interface_table.arr[i].intf->destroy);
     }
 
@@ -361,8 +665,7 @@ int mdp_unmap_image(module_t* module, bool remove_from_list, bool call_unload_ro
     // Remove the module from our list if needed
     if (remove_from_list)
     {   
-        // TODO check destructor
-        CHECK_CALL(REMOVE_VECTOR(module_t), &global_module_list, module, NULL);
+        CHECK_CALL(mdp_remove_module_from_list, module);
     }
 
     return last_status;
@@ -384,90 +687,86 @@ int mdp_dispatch_entry(module_t* module, Entry entry)
     return last_status;
 }
 
-static int predicate_build_module(const char* entry, bool* result)
+int mdp_map_folder(const char* folder, bool recursive, bool is_runtime_load, size_t* number_of_mapped_modules)
 {
     int last_status = MSL_SUCCESS;
-    bool flag;
+    module_path_list_t modules_to_map;
+    module_candidate_t* candidates = NULL;
+    const char** paths = NULL;
+    size_t* load_order = NULL;
+    // Stage two started, its batch and timer are still open
+    bool loading = false;
 
-    CHECK_CALL(is_regular_file, entry, &flag);
-    if (!flag) 
-    {
-        *result = false;
-        return last_status;
-    }
+    CHECK_CALL(mdp_build_module_list, folder, recursive, ".dll", &modules_to_map);
 
-    CHECK_CALL(has_filename, entry, &flag);
-    if (!flag)
+    size_t loaded_count = 0;
+    if (modules_to_map.count)
     {
-        *result = false;
-        return last_status;
+        candidates = (module_candidate_t*)calloc(modules_to_map.count, sizeof(module_candidate_t));
+        paths = (const char**)malloc(modules_to_map.count * sizeof(const char*));
+        load_order = (size_t*)malloc(modules_to_map.count * sizeof(size_t));
+        if (!candidates || !paths || !load_order)
+        {
+            last_status = MSL_ALLOCATION_ERROR;
+            goto cleanup;
+        }
     }
 
-    // if error, fname should be free before leaving
-    // thus goto to handle that case
-    char* fname;
-    CHECK_CALL_GOTO_ERROR(filename_alloc, cleanup, entry, &fname);
-    CHECK_CALL_GOTO_ERROR(has_extension, cleanup, fname, &flag);
-    if (!flag)
+    // Nothing is added to the arena anymore, the paths won't move
+    for (size_t i = 0; i < modules_to_map.count; i++)
     {
-        *result = false;
-        goto cleanup;
+        mdp_path_list_get(&modules_to_map, i, &paths[i]);
     }
 
-    char* ext_name;
-    CHECK_CALL_GOTO_ERROR(extension, cleanup, fname, &ext_name);
-    int cmp;
-    CHECK_CALL_GOTO_ERROR(compare, cleanup, ext_name, ".dll", &cmp);
-    if (cmp)
+    // Requirements first, then priority and name, see load_order.h
+    CHECK_CALL_GOTO_ERROR(lo_sort, cleanup, paths, modules_to_map.count, load_order);
+    for (size_t i = 0; i < modules_to_map.count; i++)
     {
-        *result = false;
-        goto cleanup;
+        candidates[i].image_path = paths[load_order[i]];
+        candidates[i].status = MSL_FAIL;
     }
 
-    *result = true;
-    ret:
-    return last_status;
+    // Stage one: read and check every file in parallel, nothing is loaded yet
+    timer_start(&global_startup_timings.validate);
+    last_status = mdp_validate_images(candidates, modules_to_map.count);
+    timer_stop(&global_startup_timings.validate);
+    if (last_status != MSL_SUCCESS) goto cleanup;
 
-    cleanup:
-    if (fname) free(fname);
-    goto ret;
-}
+    // Stage two: load in order on this thread, images that aren't modules are skipped.
+    // Thread safe operation callbacks are called on the worker pool meanwhile.
+    timer_start(&global_startup_timings.load);
+    obp_begin_operation_batch();
+    loading = true;
 
-static int str_comparator(const void* first, const void* second) 
-{
-    int first_hash = 0;
-    int second_hash = 0;
-    for (char* p = (char*)first;*p;p++)
-    {
-        first_hash += *p;
-    }
-    for (char* q = (char*)second;*q;q++)
-    {
-        first_hash += *q;
-    }
-    return first_hash  - second_hash;
-}
-
-int mdp_map_folder(const char* folder, bool recursive, bool is_runtime_load, size_t* number_of_mapped_modules)
-{
-    int last_status = MSL_SUCCESS;
-    VECTOR(str) modules_to_map;
-
-    CHECK_CALL(mdp_build_module_list, folder, recursive, predicate_build_module, &modules_to_map);
-    CHECK_CALL(SORT_VECTOR(str), &modules_to_map, str_comparator);
-
-    size_t loaded_count = 0;
     bool loaded;
-    module_t* loaded_module = NULL;
-    for (size_t i = 0; i < modules_to_map.size; i++)
+    module_t loaded_module;
+    for (size_t i = 0; i < modules_to_map.count; i++)
     {
-        CHECK_CALL(md_map_image_ex, modules_to_map.arr[i], is_runtime_load, loaded_module, &loaded);
+        if (candidates[i].status != MSL_SUCCESS) continue;
+
+        CHECK_CALL_GOTO_ERROR(md_map_validated_image_ex, cleanup, &candidates[i], is_runtime_load, &loaded_module, &loaded);
         if (loaded) loaded_count++;
     }
 
+    loading = false;
+    last_status = obp_end_operation_batch();
+    timer_stop(&global_startup_timings.load);
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
     if (number_of_mapped_modules)
         *number_of_mapped_modules = loaded_count;
 
+    cleanup:
+    if (loading)
+    {
+        obp_end_operation_batch();
+        timer_stop(&global_startup_timings.load);
+    }
+    // Mapped modules have their own copy of the path
+    mdp_path_list_free(&modules_to_map);
+    free(candidates);
+    free(paths);
+    free(load_order);
     return last_status;
 }
 
@@ -480,34 +779,61 @@ int md_map_image(const char* image_path, module_t* module)
 }
 
 int md_map_image_ex(const char* image_path, bool is_runtime_load, module_t* module, bool* loaded)
+{
+    int last_status = MSL_SUCCESS;
+    unsigned short self_arch = 0;
+    module_candidate_t candidate;
+    *loaded = false;
+
+    CHECK_CALL(pp_get_current_architecture, &self_arch);
+    CHECK_CALL(mdp_validate_image, image_path, self_arch, &candidate);
+    CHECK_CALL(md_map_validated_image_ex, &candidate, is_runtime_load, module, loaded);
+    return last_status;
+}
+
+int md_map_validated_image_ex(const module_candidate_t* candidate, bool is_runtime_load, module_t* module, bool* loaded)
 {
     int last_status = MSL_SUCCESS;
     *loaded = false;
     HMODULE image_base = NULL;
+    char* shadow_path = NULL;
 
     // Map the image
-    CHECK_CALL(mdp_map_image, image_path, &image_base);
+    CHECK_CALL(mdp_load_validated_image, candidate, &image_base, &shadow_path);
 
-    // Create the module object
+    // Create the module object, the exports were found while validating
     module_t module_object;
-    CHECK_CALL(mdp_create_module, image_path, image_base, true, 0, &module_object);
+    CHECK_CALL_GOTO_ERROR(mdp_create_module, unload, candidate->image_path, image_base, false, 0, &module_object);
+    module_object.shadow_path = shadow_path;
+    CHECK_CALL_GOTO_ERROR(mdp_apply_image_exports, discard, candidate, image_base, &module_object);
 
     // Verify image integrity
-    CHECK_CALL(mmp_verify_callback, module_object.image_base.hmodule, module_object.framework_initialize);
+    CHECK_CALL_GOTO_ERROR(mmp_verify_callback, discard, module_object.image_base.hmodule, module_object.framework_initialize);
 
     module_object.flags.is_runtime_loaded = is_runtime_load;
 
     // Add the module to the module list before running module code
-    // No longer safe to access module_object
-    CHECK_CALL(mdp_add_module_to_list, &module_object);
-    *module = module_object;
+    // No longer safe to access module_object, the stored module is the one modules see
+    module_t* stored = NULL;
+    CHECK_CALL_GOTO_ERROR(mdp_add_module_to_list, discard, &module_object, &stored);
+    *module = *stored;
 
     // If we're loaded at runtime, we have to call the module methods manually
     if (is_runtime_load)
     {
+        // Unless it waits for its first use, see md_set_lazy_initialization
+        bool deferred = false;
+        CHECK_CALL_GOTO_ERROR(mdp_defer_module_initialization, cleanup, stored, &deferred);
+        if (deferred)
+        {
+            *module = *stored;
+            *loaded = true;
+            return MSL_SUCCESS;
+        }
+
         // Dispatch Module Preinitialize to not break modules that depend on it (eg. YYTK)
-        CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, module, module->module_preinitialize);
-        module->flags.is_preloaded = true;
+        CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, stored, stored->module_preinitialize);
+        stored->flags.is_preloaded = true;
 
         // Check the environment we are in. This is to detect plugins loaded by other plugins
         // from their ModulePreinitialize routines. In such cases, we don't want
@@ -520,14 +846,16 @@ int md_map_image_ex(const char* image_path, bool is_runtime_load, module_t* modu
         // Instead, it will be called in ArProcessAttach when the module initializes.
         if (are_we_within_early_launch)
         {
+            *module = *stored;
             *loaded = true;
             return MSL_SUCCESS;
         }
 
         // Dispatch Module Initialize
-        CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, module, module->module_initialize);
+        CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, stored, stored->module_initialize);
+        stored->flags.is_initialized = true;
+        *module = *stored;
         CHECK_CALL(mdp_purge_marked_modules);
-        module->flags.is_initialized = true;
 
         // Module is now fully initialized
     }	
@@ -536,9 +864,18 @@ int md_map_image_ex(const char* image_path, bool is_runtime_load, module_t* modu
 
     cleanup:
     // Remove module if Preinitialize failed or Initialize failed
-    CHECK_CALL(mdp_mark_module_for_purge, module); 
+    CHECK_CALL(mdp_mark_module_for_purge, stored); 
     CHECK_CALL(mdp_purge_marked_modules);
     return last_status;
+
+    discard:
+    // Never made it into the list, its copy of the path is still ours
+    free(module_object.image_path);
+
+    unload:
+    FreeLibrary(image_base);
+    mdp_delete_shadow_copy(&shadow_path);
+    return last_status;
 }
 
 int md_is_image_runtime_loaded(module_t* module, bool* runtime_loaded)
@@ -592,4 +929,163 @@ int md_unmap_image(module_t* module)
 
     CHECK_CALL(mdp_unmap_image, module, true, true);
     return last_status;
+}
+
+// Swaps the image of a module that exports ModuleHotReload, the module_t stays where it is
+// so whatever was registered under it still refers to it. Code moves with every build,
+// ModuleHotReload is called instead of the initialize routines to register it again.
+int md_reload_image(module_t* module, const char* image_path)
+{
+    int last_status = MSL_SUCCESS;
+    unsigned short self_arch = 0;
+    module_candidate_t candidate;
+    HMODULE image_base = NULL;
+
+    if (module == global_initial_image) return MSL_ACCESS_DENIED;
+    if (!module->module_hot_reload) return MSL_INVALID_PARAMETER;
+
+    // Nothing is unloaded if the new file can't replace the old one
+    CHECK_CALL(pp_get_current_architecture, &self_arch);
+    CHECK_CALL(mdp_validate_image, image_path, self_arch, &candidate);
+    if (!candidate.module_hot_reload_offset) return MSL_INVALID_SIGNATURE;
+
+    // Also drops its callbacks, nothing points into the old image once it's unloaded
+    CHECK_CALL(mdp_unmap_image, module, false, true);
+    mdp_delete_shadow_copy(&module->shadow_path);
+
+    // The module is still in the list under the same path, so mdp_load_validated_image would refuse it.
+    // The new build is copied as well, image_path stays free for the next one.
+    char* shadow_path = NULL;
+    CHECK_CALL_GOTO_ERROR(mdp_load_image_file, remove, image_path, true, &image_base, &shadow_path);
+
+    module_t module_object;
+    CHECK_CALL_GOTO_ERROR(mdp_create_module, unload, image_path, image_base, false, module->flags.bitfield, &module_object);
+    CHECK_CALL_GOTO_ERROR(mdp_apply_image_exports, discard, &candidate, image_base, &module_object);
+    CHECK_CALL_GOTO_ERROR(mmp_verify_callback, discard, module_object.image_base.hmodule, module_object.framework_initialize);
+
+    // The tables were emptied by the unmap and are kept
+    module->image_base = module_object.image_base;
+    module->image_size = module_object.image_size;
+    free(module->image_path);
+    module->image_path = module_object.image_path;
+    module->shadow_path = shadow_path;
+    module->image_entrypoint = module_object.image_entrypoint;
+    module->module_initialize = module_object.module_initialize;
+    module->module_preinitialize = module_object.module_preinitialize;
+    module->module_unload = module_object.module_unload;
+    module->framework_initialize = module_object.framework_initialize;
+    module->module_operation_callback = module_object.module_operation_callback;
+    module->module_hot_reload = module_object.module_hot_reload;
+
+    // A rebuilt file is usually a new file under the same path
+    CHECK_CALL_GOTO_ERROR(mdp_index_update_module, cleanup, module);
+
+    // Still waiting for its first use, it will initialize with the new image
+    if (module->flags.is_lazy) return last_status;
+
+    CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, module, module->module_hot_reload);
+    return last_status;
+
+    cleanup:
+    // The new image is in place, a regular purge unloads it.
+    // The first failure is returned, so the module is never counted as reloaded.
+    if (LOG_ON_ERR(mdp_mark_module_for_purge, module) == MSL_SUCCESS)
+        LOG_ON_ERR(mdp_purge_marked_modules);
+    return last_status;
+
+    discard:
+    free(module_object.image_path);
+
+    unload:
+    FreeLibrary(image_base);
+    mdp_delete_shadow_copy(&shadow_path);
+
+    remove:
+    // The old image is gone and the new one never made it in, the unmap left nothing pointing into it
+    mdp_remove_module_from_list(module);
+    return last_status;
+}
+
+static int mdp_apply_lazy_declaration(const char* key, const char* value, void* context)
+{
+    int last_status = MSL_SUCCESS;
+    module_t* module = (module_t*)context;
+
+    if (!stricmp(key, "provides") && *value)
+    {
+        CHECK_CALL(obp_reserve_interface, module, value);
+        module->flags.is_lazy = true;
+    }
+
+    return last_status;
+}
+
+// With lazy initialization on, a module that declares what it provides in its manifest
+// (see load_order.h) is only initialized once one of its interfaces is looked up.
+int mdp_defer_module_initialization(module_t* module, bool* deferred)
+{
+    *deferred = false;
+    if (!global_lazy_initialization || !module->image_path) return MSL_SUCCESS;
+
+    // A name another module already has can't wait, the module is initialized right away
+    if (lo_read_manifest_entries(module->image_path, mdp_apply_lazy_declaration, module) != MSL_SUCCESS)
+    {
+        obp_release_reserved_interfaces(module);
+        module->flags.is_lazy = false;
+        return MSL_SUCCESS;
+    }
+
+    *deferred = module->flags.is_lazy;
+    return MSL_SUCCESS;
+}
+
+// Off by default, only modules mapped after it's turned on are affected
+int md_set_lazy_initialization(bool enabled)
+{
+    global_lazy_initialization = enabled;
+    return MSL_SUCCESS;
+}
+
+// Runs the routines md_map_validated_image_ex skipped, does nothing if the module isn't lazy
+int md_activate_module(module_t* module)
+{
+    int last_status = MSL_SUCCESS;
+    if (!module->flags.is_lazy) return MSL_SUCCESS;
+
+    // Cleared first, looking up its own interfaces while it initializes must not come back here
+    module->flags.is_lazy = false;
+
+    CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, module, module->module_preinitialize);
+    module->flags.is_preloaded = true;
+
+    // Same as md_map_validated_image_ex, ModuleInitialize waits for the process to start
+    bool are_we_within_early_launch = false;
+    CHECK_CALL(el_is_process_suspended, &are_we_within_early_launch);
+    if (are_we_within_early_launch) return MSL_SUCCESS;
+
+    CHECK_CALL_GOTO_ERROR(mdp_dispatch_entry, cleanup, module, module->module_initialize);
+    module->flags.is_initialized = true;
+
+    // Names it declared without creating them
+    CHECK_CALL(obp_release_reserved_interfaces, module);
+    CHECK_CALL(mdp_purge_marked_modules);
+    return last_status;
+
+    cleanup:
+    // The routine's failure is returned, the purge only logs its own
+    if (LOG_ON_ERR(mdp_mark_module_for_purge, module) == MSL_SUCCESS)
+        LOG_ON_ERR(mdp_purge_marked_modules);
+    return last_status;
+}
+
+int md_get_startup_timings(startup_timings_t* timings)
+{
+    *timings = global_startup_timings;
+    return MSL_SUCCESS;
+}
+
+int md_reset_startup_timings(void)
+{
+    memset(&global_startup_timings, 0, sizeof(global_startup_timings));
+    return MSL_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include "../include/module_table.h"
+#include "../include/error.h"
+
+static module_t* mt_slot_address(const module_table_t* table, uint32_t slot)
+{
+    return &table->chunks[slot / MODULE_TABLE_CHUNK_SIZE][slot % MODULE_TABLE_CHUNK_SIZE];
+}
+
+// Adds a chunk of free slots, the modules already in the table don't move
+static int mt_grow(module_table_t* table)
+{
+    size_t slot_count = table->slot_count + MODULE_TABLE_CHUNK_SIZE;
+    if (slot_count >= MODULE_TABLE_FREE_SLOT) return MSL_INSUFFICIENT_MEMORY;
+
+    module_t* chunk = (module_t*)calloc(MODULE_TABLE_CHUNK_SIZE, sizeof(module_t));
+    if (!chunk) return MSL_ALLOCATION_ERROR;
+
+    module_t** chunks = (module_t**)realloc(table->chunks, (table->chunk_count + 1) * sizeof(module_t*));
+    if (!chunks)
+    {
+        free(chunk);
+        return MSL_ALLOCATION_ERROR;
+    }
+    table->chunks = chunks;
+
+    // Each array is only replaced once its realloc worked, a failure leaves the table usable
+    uint32_t* generations = (uint32_t*)realloc(table->generations, slot_count * sizeof(uint32_t));
+    if (generations) table->generations = generations;
+    uint32_t* dense_positions = (uint32_t*)realloc(table->dense_positions, slot_count * sizeof(uint32_t));
+    if (dense_positions) table->dense_positions = dense_positions;
+    uint32_t* free_slots = (uint32_t*)realloc(table->free_slots, slot_count * sizeof(uint32_t));
+    if (free_slots) table->free_slots = free_slots;
+    module_t** modules = (module_t**)realloc(table->modules, slot_count * sizeof(module_t*));
+    if (modules) table->modules = modules;
+
+    if (!generations || !dense_positions || !free_slots || !modules)
+    {
+        free(chunk);
+        return MSL_ALLOCATION_ERROR;
+    }
+
+    table->chunks[table->chunk_count++] = chunk;
+
+    // Pushed backwards so the lowest slot is used first
+    for (size_t slot = slot_count; slot-- > table->slot_count; )
+    {
+        table->generations[slot] = 1;
+        table->dense_positions[slot] = MODULE_TABLE_FREE_SLOT;
+        table->free_slots[table->free_count++] = (uint32_t)slot;
+    }
+
+    table->slot_count = slot_count;
+    return MSL_SUCCESS;
+}
+
+// Copies module into a free slot, stored receives its address and has its handle set
+int mt_insert(module_table_t* table, const module_t* module, module_t** stored)
+{
+    int last_status = MSL_SUCCESS;
+
+    if (!table->free_count)
+    {
+        CHECK_CALL(mt_grow, table);
+    }
+
+    uint32_t slot = table->free_slots[--table->free_count];
+    module_t* slot_module = mt_slot_address(table, slot);
+
+    *slot_module = *module;
+    slot_module->handle = MODULE_HANDLE(slot, table->generations[slot]);
+
+    table->dense_positions[slot] = (uint32_t)table->count;
+    table->modules[table->count++] = slot_module;
+
+    if (stored)
+        *stored = slot_module;
+
+    return last_status;
+}
+
+int mt_remove(module_table_t* table, module_handle_t handle)
+{
+    int last_status = MSL_SUCCESS;
+    module_t* module = NULL;
+    CHECK_CALL(mt_resolve, table, handle, &module);
+
+    uint32_t slot = MODULE_HANDLE_SLOT(handle);
+    uint32_t position = table->dense_positions[slot];
+
+    module_t* last = table->modules[--table->count];
+    table->modules[position] = last;
+    table->dense_positions[MODULE_HANDLE_SLOT(last->handle)] = position;
+
+    // Every handle to the slot is now stale, 0 is never a valid generation
+    table->dense_positions[slot] = MODULE_TABLE_FREE_SLOT;
+    if (!++table->generations[slot]) table->generations[slot] = 1;
+    table->free_slots[table->free_count++] = slot;
+
+    memset(module, 0, sizeof(*module));
+    return last_status;
+}
+
+int mt_resolve(const module_table_t* table, module_handle_t handle, module_t** module)
+{
+    uint32_t slot = MODULE_HANDLE_SLOT(handle);
+    if (slot >= table->slot_count) return MSL_OBJECT_NOT_FOUND;
+    if (table->generations[slot] != MODULE_HANDLE_GENERATION(handle)) return MSL_OBJECT_NOT_FOUND;
+    if (table->dense_positions[slot] == MODULE_TABLE_FREE_SLOT) return MSL_OBJECT_NOT_FOUND;
+
+    *module = mt_slot_address(table, slot);
+    return MSL_SUCCESS;
+}
+
+int mt_get_slot(const module_table_t* table, uint32_t slot, module_t** module)
+{
+    if (slot >= table->slot_count) return MSL_OBJECT_NOT_FOUND;
+    if (table->dense_positions[slot] == MODULE_TABLE_FREE_SLOT) return MSL_OBJECT_NOT_FOUND;
+
+    *module = mt_slot_address(table, slot);
+    return MSL_SUCCESS;
+}
+
+int mt_destroy(module_table_t* table)
+{
+    if (!table) return MSL_NULL_BUFFER;
+
+    for (size_t i = 0; i < table->chunk_count; i++)
+    {
+        free(table->chunks[i]);
+    }
+
+    free(table->chunks);
+    free(table->generations);
+    free(table->dense_positions);
+    free(table->free_slots);
+    free(table->modules);
+    memset(table, 0, sizeof(*table));
+    return MSL_SUCCESS;
+}
@@ -2,17 +2,54 @@
 // See LICENSE file for extended copyright information.
 // This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
 
+#include <ctype.h>
 #include "../include/error.h"
 #include "../include/object.h"
 #include "../include/interface.h"
 #include "../include/module.h"
+#include "../include/worker_pool.h"
 
-VECTOR(module_t) global_module_list;
+static interface_registry_t global_interface_registry;
+static module_operation_batch_t global_operation_batch;
+
+// folded has room for INTERFACE_NAME_CAPACITY chars
+static int obp_fold_interface_name(const char* interface_name, char* folded)
+{
+    size_t length = strlen(interface_name);
+    if (length >= INTERFACE_NAME_CAPACITY) return MSL_INVALID_PARAMETER;
+
+    for (size_t i = 0; i <= length; i++)
+    {
+        folded[i] = (char)tolower((unsigned char)interface_name[i]);
+    }
+
+    return MSL_SUCCESS;
+}
+
+// A miss is expected here, nothing is logged
+static int obp_find_registry_entry(const char* interface_name, interface_registry_entry_t** registry_entry)
+{
+    char folded[INTERFACE_NAME_CAPACITY];
+    int32_t position = 0;
+
+    if (obp_fold_interface_name(interface_name, folded) != MSL_SUCCESS) return MSL_OBJECT_NOT_FOUND;
+    if (GET_VALUE(str, int32_t)(&global_interface_registry.by_name, folded, &position) != MSL_SUCCESS) return MSL_OBJECT_NOT_FOUND;
+
+    *registry_entry = &global_interface_registry.entries[position];
+    return MSL_SUCCESS;
+}
 
 int ob_create_interface(module_t* module, interface_base_t* interface_base, const char* interface_name)
 {
     int last_status = MSL_SUCCESS;
-    CHECK_CALL_CUSTOM_ERROR(ob_interface_exists, MSL_OBJECT_ALREADY_EXISTS, interface_name);
+    interface_registry_entry_t* registry_entry = NULL;
+    char folded[INTERFACE_NAME_CAPACITY];
+
+    // A lazy module creates the interfaces it reserved while initializing
+    if (obp_find_registry_entry(interface_name, &registry_entry) == MSL_SUCCESS &&
+        (registry_entry->intf || registry_entry->owner_module != module))
+        return MSL_OBJECT_ALREADY_EXISTS;
+    CHECK_CALL(obp_fold_interface_name, interface_name, folded);
 
     interface_table_entry_t table_entry = {
         .intf = interface_base,
@@ -27,6 +64,19 @@ int ob_create_interface(module_t* module, interface_base_t* interface_base, cons
     CHECK_CALL(interface_base->create);
 
     CHECK_CALL(obp_add_interface_to_table, module, &table_entry);
+
+    // create can register other interfaces, the reservation is looked up again
+    if (obp_find_registry_entry(interface_name, &registry_entry) == MSL_SUCCESS)
+    {
+        registry_entry->intf = interface_base;
+        return last_status;
+    }
+
+    CHECK_CALL_GOTO_ERROR(obp_register_interface, remove, module, interface_base, interface_name);
+    return last_status;
+
+    remove:
+    obp_destroy_interface(module, interface_base, false, true);
     return last_status;
 }
 
@@ -91,6 +141,80 @@ int obp_set_module_operation_callback(module_t* module, ModuleCallback callback_
     return last_status;
 }
 
+static int obp_queue_operation(module_t* affected_module, MODULE_OPERATION_TYPE operation_type, const operation_info_t* operation_information)
+{
+    module_operation_batch_t* batch = &global_operation_batch;
+    if (batch->count == batch->capacity)
+    {
+        size_t capacity = batch->capacity ? batch->capacity * 2 : DEFAULT_CAPACITY;
+        module_operation_t* operations = (module_operation_t*)realloc(batch->operations, capacity * sizeof(module_operation_t));
+        if (!operations) return MSL_ALLOCATION_ERROR;
+
+        batch->operations = operations;
+        batch->capacity = capacity;
+    }
+
+    module_operation_t* operation = &batch->operations[batch->count++];
+    operation->affected_module = affected_module;
+    operation->type = operation_type;
+    operation->information = *operation_information;
+    return MSL_SUCCESS;
+}
+
+// Runs on the worker pool, one observer goes through the whole batch in order
+static void obp_deliver_operations(void* context, size_t index)
+{
+    module_operation_delivery_t* delivery = (module_operation_delivery_t*)context;
+    module_t* observer = delivery->observers[index];
+
+    for (size_t i = 0; i < delivery->batch->count; i++)
+    {
+        const module_operation_t* operation = &delivery->batch->operations[i];
+        operation_info_t operation_information = operation->information;
+        int status = observer->module_operation_callback(operation->affected_module, operation->type, &operation_information);
+        if (status != MSL_SUCCESS) InterlockedCompareExchange(&delivery->status, status, MSL_SUCCESS);
+    }
+}
+
+// The observers are the thread safe ones loaded now, the batch is emptied even on failure
+static int obp_flush_operation_batch(void)
+{
+    int last_status = MSL_SUCCESS;
+    module_operation_batch_t* batch = &global_operation_batch;
+    module_operation_delivery_t delivery;
+    memset(&delivery, 0, sizeof(delivery));
+
+    if (!batch->count) return MSL_SUCCESS;
+
+    timer_start(&global_startup_timings.operation_callbacks);
+
+    delivery.batch = batch;
+    delivery.observers = (module_t**)malloc(global_module_table.count * sizeof(module_t*));
+    if (!delivery.observers)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    size_t observer_count = 0;
+    for (size_t i = 0; i < global_module_table.count; i++)
+    {
+        module_t* loaded_module = global_module_table.modules[i];
+        if (!loaded_module->module_operation_callback || !loaded_module->flags.has_pooled_operation_callback) continue;
+
+        delivery.observers[observer_count++] = loaded_module;
+    }
+
+    CHECK_CALL_GOTO_ERROR(wp_run, cleanup, observer_count, 0, obp_deliver_operations, &delivery);
+    last_status = (int)delivery.status;
+
+    cleanup:
+    batch->count = 0;
+    free(delivery.observers);
+    timer_stop(&global_startup_timings.operation_callbacks);
+    return last_status;
+}
+
 int obp_dispatch_module_operation_callbacks(module_t* affected_module, Entry routine, bool is_future_call)
 {
     // Determine the operation type
@@ -105,21 +229,72 @@ int obp_dispatch_module_operation_callbacks(module_t* affected_module, Entry rou
         current_operation_type = OPERATION_INITIALIZE;
     else if (routine == affected_module->module_unload)
         current_operation_type = OPERATION_UNLOAD;
+    else if (routine == affected_module->module_hot_reload)
+        current_operation_type = OPERATION_RELOAD;
     
     operation_info_t operation_information;
     CHECK_CALL(obp_create_operation_info, affected_module, is_future_call, &operation_information);
 
+    timer_start(&global_startup_timings.operation_callbacks);
+
+    // Outside of a batch everyone is called on this thread, no pool is started for a single module
+    bool is_batched = global_operation_batch.depth != 0;
+    bool has_pooled_observers = false;
     module_t* loaded_module;
-    for (size_t i = 0; i < global_module_list.size; i++)
+    for (size_t i = 0; i < global_module_table.count; i++)
     {
-        loaded_module = &global_module_list.arr[i];
+        loaded_module = global_module_table.modules[i];
         if (!loaded_module->module_operation_callback) continue;
 
-        CHECK_CALL(loaded_module->module_operation_callback, affected_module, current_operation_type, &operation_information);
+        if (is_batched && loaded_module->flags.has_pooled_operation_callback)
+        {
+            has_pooled_observers = true;
+            continue;
+        }
+
+        CHECK_CALL_GOTO_ERROR(loaded_module->module_operation_callback, cleanup, affected_module, current_operation_type, &operation_information);
+    }
+
+    // Delivered before returning, a notification with is_future_call set arrives before the routine runs
+    if (has_pooled_observers)
+    {
+        CHECK_CALL_GOTO_ERROR(obp_queue_operation, cleanup, affected_module, current_operation_type, &operation_information);
+        CHECK_CALL_GOTO_ERROR(obp_flush_operation_batch, cleanup);
     }
+
+    cleanup:
+    timer_stop(&global_startup_timings.operation_callbacks);
     return last_status;
 }
 
+// While a batch is open, thread safe callbacks are called on the worker pool
+int obp_begin_operation_batch(void)
+{
+    global_operation_batch.depth++;
+    return MSL_SUCCESS;
+}
+
+// Every notification was delivered by the dispatch that made it, nothing is left to flush
+int obp_end_operation_batch(void)
+{
+    if (!global_operation_batch.depth) return MSL_INVALID_PARAMETER;
+
+    global_operation_batch.depth--;
+    return MSL_SUCCESS;
+}
+
+// A thread safe callback can be called from any thread and at the same time as other callbacks,
+// never for the same module twice at once. It must not map nor unmap modules.
+// While a batch is open (mdp_map_folder opens one) it is called on the worker pool,
+// otherwise on the loading thread like the others. Either way its notifications come in order,
+// and each one arrives before mdp_dispatch_entry moves on: before the routine it announces runs,
+// or before the dispatch returns once the routine ran.
+int ob_set_operation_callback_thread_safe(module_t* module, bool thread_safe)
+{
+    module->flags.has_pooled_operation_callback = thread_safe;
+    return MSL_SUCCESS;
+}
+
 int obp_add_interface_to_table(module_t* module, interface_table_entry_t* entry)
 {
     int last_status = MSL_SUCCESS;
@@ -153,6 +328,15 @@ int obp_destroy_interface(module_t* module, interface_base_t* interface_base, bo
 
     if (remove_from_list)
     {
+        for (size_t i = 0; i < module->interface_table.size; i++)
+        {
+            if (module->interface_table.arr[i].intf != interface_base) continue;
+
+            // Only registered once everything else worked, see ob_create_interface
+            obp_unregister_interface(module->interface_table.arr[i].interface_name);
+            break;
+        }
+
         // No need for a specific destructor here
         CHECK_CALL(REMOVE_VECTOR_IF(interface_table_entry_t), &module->interface_table, predicate_destroy_interface, interface_base, NULL);
     }
@@ -162,35 +346,124 @@ int obp_destroy_interface(module_t* module, interface_base_t* interface_base, bo
 
 int obp_lookup_interface_owner(const char* interface_name, bool case_insensitive, module_t** module, interface_table_entry_t** table_entry)
 {
-    module_t* loaded_module = NULL;
-    // Loop every single module
-    for (size_t i = 0; i < global_module_list.size; i++)
+    int last_status = MSL_SUCCESS;
+    interface_registry_entry_t* registry_entry = NULL;
+    if (obp_find_registry_entry(interface_name, &registry_entry) != MSL_SUCCESS) return MSL_OBJECT_NOT_FOUND;
+
+    // First use of an interface of a lazy module, the module creates it while initializing
+    module_t* owner_module = registry_entry->owner_module;
+    if (!registry_entry->intf)
     {
-        loaded_module = &global_module_list.arr[i];
+        if (!owner_module->flags.is_lazy) return MSL_OBJECT_NOT_FOUND;
 
-        if (case_insensitive)
-        {
-            if(!stricmp(loaded_module->interface_table.arr->interface_name, interface_name))
-            {
-                *module = loaded_module;
-                *table_entry = loaded_module->interface_table.arr;
-                return MSL_SUCCESS;
-            }
-        }
-        else
-        {
-            if(!strcmp(loaded_module->interface_table.arr->interface_name, interface_name))
-            {
-                *module = loaded_module;
-                *table_entry = loaded_module->interface_table.arr;
-                return MSL_SUCCESS;
-            }
-        }
+        CHECK_CALL(md_activate_module, owner_module);
+        if (obp_find_registry_entry(interface_name, &registry_entry) != MSL_SUCCESS) return MSL_OBJECT_NOT_FOUND;
+        if (!registry_entry->intf) return MSL_OBJECT_NOT_FOUND;
+
+        owner_module = registry_entry->owner_module;
     }
+
+    // The registry knows the owner, its own table is only a few entries long
+    for (size_t i = 0; i < owner_module->interface_table.size; i++)
+    {
+        interface_table_entry_t* entry = &owner_module->interface_table.arr[i];
+        if (entry->intf != registry_entry->intf) continue;
+
+        if (!case_insensitive && strcmp(entry->interface_name, interface_name)) return MSL_OBJECT_NOT_FOUND;
+
+        *module = owner_module;
+        *table_entry = entry;
+        return MSL_SUCCESS;
+    }
+
     // We didn't find any interface with that name.
     return MSL_OBJECT_NOT_FOUND;
 }
 
+int obp_register_interface(module_t* module, interface_base_t* interface_base, const char* interface_name)
+{
+    int last_status = MSL_SUCCESS;
+    interface_registry_t* registry = &global_interface_registry;
+    char folded[INTERFACE_NAME_CAPACITY];
+    CHECK_CALL(obp_fold_interface_name, interface_name, folded);
+
+    if (registry->count == registry->capacity)
+    {
+        size_t capacity = registry->capacity ? registry->capacity * 2 : DEFAULT_CAPACITY;
+        interface_registry_entry_t* entries = (interface_registry_entry_t*)realloc(registry->entries, capacity * sizeof(interface_registry_entry_t));
+        if (!entries) return MSL_ALLOCATION_ERROR;
+
+        registry->entries = entries;
+        registry->capacity = capacity;
+    }
+
+    interface_registry_entry_t* registry_entry = &registry->entries[registry->count];
+    registry_entry->folded_name = strdup(folded);
+    if (!registry_entry->folded_name) return MSL_ALLOCATION_ERROR;
+
+    registry_entry->intf = interface_base;
+    registry_entry->owner_module = module;
+
+    CHECK_CALL_GOTO_ERROR(INSERT(str, int32_t), cleanup, &registry->by_name, registry_entry->folded_name, (int32_t)registry->count);
+    registry->count++;
+    return last_status;
+
+    cleanup:
+    free(registry_entry->folded_name);
+    return last_status;
+}
+
+// The name is taken by module until it creates the interface, lookups initialize it first
+int obp_reserve_interface(module_t* module, const char* interface_name)
+{
+    int last_status = MSL_SUCCESS;
+    interface_registry_entry_t* registry_entry = NULL;
+    if (obp_find_registry_entry(interface_name, &registry_entry) == MSL_SUCCESS) return MSL_OBJECT_ALREADY_EXISTS;
+
+    CHECK_CALL(obp_register_interface, module, NULL, interface_name);
+    return last_status;
+}
+
+// Drops the names module reserved but never created, only done once per module
+int obp_release_reserved_interfaces(module_t* module)
+{
+    int last_status = MSL_SUCCESS;
+    interface_registry_t* registry = &global_interface_registry;
+
+    // Backwards since removing an entry moves the last one in its place
+    for (size_t i = registry->count; i-- > 0; )
+    {
+        interface_registry_entry_t* registry_entry = &registry->entries[i];
+        if (registry_entry->intf || registry_entry->owner_module != module) continue;
+
+        CHECK_CALL(obp_unregister_interface, registry_entry->folded_name);
+    }
+
+    return last_status;
+}
+
+int obp_unregister_interface(const char* interface_name)
+{
+    int last_status = MSL_SUCCESS;
+    interface_registry_t* registry = &global_interface_registry;
+    interface_registry_entry_t* registry_entry = NULL;
+    if (obp_find_registry_entry(interface_name, &registry_entry) != MSL_SUCCESS) return MSL_OBJECT_NOT_FOUND;
+
+    size_t position = (size_t)(registry_entry - registry->entries);
+    REMOVE(str, int32_t)(&registry->by_name, registry_entry->folded_name);
+    free(registry_entry->folded_name);
+
+    // The last entry takes the free place, its key keeps the same string
+    size_t last = --registry->count;
+    if (position != last)
+    {
+        registry->entries[position] = registry->entries[last];
+        CHECK_CALL(INSERT(str, int32_t), &registry->by_name, registry->entries[position].folded_name, (int32_t)position);
+    }
+
+    return last_status;
+}
+
 int ob_get_interface(const char* interface_name, interface_base_t** interface_base)
 {
     int last_status = MSL_SUCCESS;
@@ -0,0 +1,227 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stddef.h>
+#include <xmmintrin.h>
+#include "../include/room.h"
+#include "../include/error.h"
+
+// The runner lists point at the start of the object, which is a YYObjectBase.
+// instance_t only describes what comes after it.
+#define INSTANCE_MEMBERS_OFFSET(L) (sizeof(yyobject_base_t) + offsetof(instance_t, L.members))
+
+// One set of accessors per layout, the offset is a constant in each of them
+#define DEF_INSTANCE_ACCESSORS(L)                                                                           \
+static instance_internal_t* rm_get_members_##L(instance_t* instance)                                        \
+{                                                                                                           \
+    return (instance_internal_t*)((char*)(instance) + INSTANCE_MEMBERS_OFFSET(L));                          \
+}                                                                                                           \
+static int32_t rm_get_id_##L(instance_t* instance) { return rm_get_members_##L(instance)->id; }             \
+static int32_t rm_get_object_index_##L(instance_t* instance) { return rm_get_members_##L(instance)->object_index; } \
+static float rm_get_x_##L(instance_t* instance) { return rm_get_members_##L(instance)->x; }                 \
+static float rm_get_y_##L(instance_t* instance) { return rm_get_members_##L(instance)->y; }                 \
+static instance_t* rm_get_flink_##L(instance_t* instance) { return rm_get_members_##L(instance)->flink; }
+
+#define INSTANCE_ACCESSORS(LAYOUT, L)   \
+    {                                   \
+        LAYOUT,                         \
+        INSTANCE_MEMBERS_OFFSET(L),     \
+        rm_get_members_##L,             \
+        rm_get_id_##L,                  \
+        rm_get_object_index_##L,        \
+        rm_get_x_##L,                   \
+        rm_get_y_##L,                   \
+        rm_get_flink_##L,               \
+    }
+
+DEF_INSTANCE_ACCESSORS(members_only)
+DEF_INSTANCE_ACCESSORS(sequence_instance_only)
+DEF_INSTANCE_ACCESSORS(with_skeleton_mask)
+
+// Indexed by INSTANCE_LAYOUT
+static const instance_accessors_t instance_accessors[INSTANCE_LAYOUT_COUNT] =
+{
+    INSTANCE_ACCESSORS(INSTANCE_LAYOUT_MEMBERS_ONLY, members_only),
+    INSTANCE_ACCESSORS(INSTANCE_LAYOUT_SEQUENCE_INSTANCE_ONLY, sequence_instance_only),
+    INSTANCE_ACCESSORS(INSTANCE_LAYOUT_WITH_SKELETON_MASK, with_skeleton_mask),
+};
+
+static instance_internal_t* rm_members_at(instance_t* instance, size_t members_offset)
+{
+    return (instance_internal_t*)((char*)(instance) + members_offset);
+}
+
+int rm_get_active_instances(room_t* room, OLINKEDLIST(instance_t)** active_instances)
+{
+    if (!room) return MSL_NULL_BUFFER;
+
+    *active_instances = &room->with_backgrounds.internals.active_instances;
+    return MSL_SUCCESS;
+}
+
+int rm_get_instance_accessors(INSTANCE_LAYOUT layout, const instance_accessors_t** accessors)
+{
+    if (layout < 0 || layout >= INSTANCE_LAYOUT_COUNT) return MSL_INVALID_PARAMETER;
+
+    *accessors = &instance_accessors[layout];
+    return MSL_SUCCESS;
+}
+
+// The id read through the right layout matches the one the runner returns for the "id" builtin.
+// Only one layout must match, a zeroed field could match the id by chance otherwise.
+int rm_detect_layout_by_id(instance_t* instance, int32_t instance_id, INSTANCE_LAYOUT* layout)
+{
+    if (!instance) return MSL_NULL_BUFFER;
+
+    int32_t matches = 0;
+    for (int32_t l = 0; l < INSTANCE_LAYOUT_COUNT; l++)
+    {
+        if (instance_accessors[l].get_id(instance) != instance_id) continue;
+
+        *layout = (INSTANCE_LAYOUT)l;
+        matches++;
+    }
+
+    return matches == 1 ? MSL_SUCCESS : MSL_OBJECT_NOT_FOUND;
+}
+
+// The id read through the right layout names, in the room instance element map, an element
+// pointing back at the instance. Only pointers stored by the runner in its map are followed,
+// so a wrong layout can't lead to reading through a garbage pointer.
+int rm_detect_layout_by_elements(room_t* room, instance_t* instance, INSTANCE_LAYOUT* layout)
+{
+    if (!room || !instance) return MSL_NULL_BUFFER;
+
+    int32_t matches = 0;
+    for (int32_t l = 0; l < INSTANCE_LAYOUT_COUNT; l++)
+    {
+        layer_instance_element_t* element = NULL;
+        if (rm_find_instance_element(room, instance_accessors[l].get_id(instance), &element) != MSL_SUCCESS) continue;
+        if (!element || element->instance != instance) continue;
+
+        *layout = (INSTANCE_LAYOUT)l;
+        matches++;
+    }
+
+    return matches == 1 ? MSL_SUCCESS : MSL_OBJECT_NOT_FOUND;
+}
+
+int rm_get_instance_members(instance_t* instance, size_t members_offset, instance_internal_t** members)
+{
+    if (!instance) return MSL_NULL_BUFFER;
+
+    *members = rm_members_at(instance, members_offset);
+    return MSL_SUCCESS;
+}
+
+int rm_iterator_init(OLINKEDLIST(instance_t)* active_instances, int32_t object_index, size_t members_offset, instance_iterator_t* iterator)
+{
+    if (!active_instances) return MSL_NULL_BUFFER;
+
+    iterator->next = active_instances->first;
+    iterator->remaining = active_instances->count;
+    iterator->object_index = object_index;
+    iterator->members_offset = members_offset;
+    return MSL_SUCCESS;
+}
+
+// Yields the instance alone, or nothing if NULL, without ever reading its members.
+// Used while the layout is unknown, when the room holds a single instance.
+int rm_iterator_init_single(instance_t* instance, instance_iterator_t* iterator)
+{
+    iterator->next = instance;
+    iterator->remaining = instance ? 1 : 0;
+    iterator->object_index = INSTANCE_ITERATOR_ALL_OBJECTS;
+    iterator->members_offset = INSTANCE_MEMBERS_OFFSET_UNKNOWN;
+    return MSL_SUCCESS;
+}
+
+// Fills the buffer with up to capacity instances, count is 0 once the list is exhausted.
+// The instance after the current one is prefetched, so the flink chain doesn't stall the walk.
+int rm_iterator_next_batch(instance_iterator_t* iterator, instance_t** buffer, size_t capacity, size_t* count)
+{
+    *count = 0;
+    if (!buffer) return MSL_NULL_BUFFER;
+
+    instance_t* current = iterator->next;
+    while (current && iterator->remaining > 0 && *count < capacity)
+    {
+        // Nothing follows the last instance, its members are only needed to filter it
+        if (iterator->remaining == 1 && iterator->object_index == INSTANCE_ITERATOR_ALL_OBJECTS)
+        {
+            buffer[(*count)++] = current;
+            iterator->remaining--;
+            current = NULL;
+            break;
+        }
+
+        instance_internal_t* members = rm_members_at(current, iterator->members_offset);
+        instance_t* next = members->flink;
+        if (next)
+        {
+            instance_internal_t* next_members = rm_members_at(next, iterator->members_offset);
+            _mm_prefetch((const char*)(&next_members->object_index), _MM_HINT_T0);
+            _mm_prefetch((const char*)(&next_members->flink), _MM_HINT_T0);
+        }
+
+        if (iterator->object_index == INSTANCE_ITERATOR_ALL_OBJECTS || members->object_index == iterator->object_index)
+            buffer[(*count)++] = current;
+
+        iterator->remaining--;
+        current = next;
+    }
+
+    iterator->next = iterator->remaining > 0 ? current : NULL;
+    return MSL_SUCCESS;
+}
+
+// The lookups below only read the runner maps, they never insert nor reorder anything
+
+int rm_find_layer_by_id(room_t* room, int32_t layer_id, layer_t** layer)
+{
+    if (!room) return MSL_NULL_BUFFER;
+
+    return GET_VALUE(int32_t, p_layer_t)(&room->with_backgrounds.internals.layer_lookup, layer_id, layer);
+}
+
+int rm_find_layer_element_by_id(room_t* room, int32_t element_id, layer_element_base_t** element)
+{
+    if (!room) return MSL_NULL_BUFFER;
+
+    // The runner keeps the last element it looked up, scripts often ask for the same one again
+    layer_element_base_t* last_element = room->with_backgrounds.internals.last_element_looked_up;
+    if (last_element && last_element->id == element_id)
+    {
+        *element = last_element;
+        return MSL_SUCCESS;
+    }
+
+    return GET_VALUE(int32_t, p_layer_element_base_t)(&room->with_backgrounds.internals.layer_element_lookup, element_id, element);
+}
+
+int rm_find_instance_element(room_t* room, int32_t instance_id, layer_instance_element_t** element)
+{
+    if (!room) return MSL_NULL_BUFFER;
+
+    return GET_VALUE(int32_t, p_layer_instance_element_t)(&room->with_backgrounds.internals.instance_element_lookup, instance_id, element);
+}
+
+// Writes up to capacity elements of the layer, in list order.
+// MSL_INSUFFICIENT_MEMORY tells the caller the layer holds more.
+int rm_get_layer_elements(layer_t* layer, layer_element_base_t** elements, size_t capacity, size_t* count)
+{
+    *count = 0;
+    if (!layer) return MSL_NULL_BUFFER;
+
+    layer_element_base_t* current = layer->elements.first;
+    for (int32_t i = 0; current && i < layer->elements.count; i++)
+    {
+        if (*count == capacity) return MSL_INSUFFICIENT_MEMORY;
+
+        elements[(*count)++] = current;
+        current = current->flink;
+    }
+
+    return MSL_SUCCESS;
+}
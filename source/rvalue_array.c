@@ -0,0 +1,135 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <string.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RVALUE_ARRAY_HAS_SSE2 1
+#endif
+#include "../include/rvalue_array.h"
+#include "../include/error.h"
+
+static int ra_is_plain(const rvalue_t* value)
+{
+    uint32_t kind = (uint32_t)value->kind & RVALUE_KIND_MASK;
+    return kind < 32 && (RVALUE_ARRAY_PLAIN_KINDS & (1u << kind));
+}
+
+#ifdef RVALUE_ARRAY_HAS_SSE2
+// An rvalue is 16 bytes: the value, then flags, then kind.
+// Gathers the kinds of 4 rvalues, masked, into one register.
+static __m128i ra_gather_kinds(__m128i first, __m128i second, __m128i third, __m128i fourth)
+{
+    __m128i kinds = _mm_unpackhi_epi64(_mm_unpackhi_epi32(first, second), _mm_unpackhi_epi32(third, fourth));
+    return _mm_and_si128(kinds, _mm_set1_epi32(RVALUE_KIND_MASK));
+}
+#endif // RVALUE_ARRAY_HAS_SSE2
+
+// The array storage of a VALUE_ARRAY rvalue, offset is interface rvalue_array_offset
+int ra_get_data(const rvalue_t* array, int64_t array_offset, rvalue_t** data)
+{
+    if (!array || !array->pointer) return MSL_NULL_BUFFER;
+    if ((array->kind & RVALUE_KIND_MASK) != VALUE_ARRAY) return MSL_INVALID_PARAMETER;
+    if (array_offset <= 0) return MSL_MODULE_INTERNAL_ERROR;
+
+    *data = *(rvalue_t**)((char*)array->pointer + array_offset);
+    if (!*data) return MSL_NULL_BUFFER;
+
+    return MSL_SUCCESS;
+}
+
+// Raw copy, references are not taken: the copies are only valid while the array holds them
+int ra_copy_out(const rvalue_t* data, size_t count, rvalue_t* values)
+{
+    if (!data || !values) return MSL_NULL_BUFFER;
+
+    memcpy(values, data, count * sizeof(rvalue_t));
+    return MSL_SUCCESS;
+}
+
+// Only plain values can be written without the runner knowing,
+// nothing is written unless every old and new value is plain.
+int ra_copy_in(rvalue_t* data, size_t count, const rvalue_t* values)
+{
+    if (!data || !values) return MSL_NULL_BUFFER;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!ra_is_plain(&data[i]) || !ra_is_plain(&values[i])) return MSL_INVALID_PARAMETER;
+    }
+
+    memcpy(data, values, count * sizeof(rvalue_t));
+    return MSL_SUCCESS;
+}
+
+// Fails on the first non real element, values is then partially written
+int ra_read_reals(const rvalue_t* data, size_t count, double* values)
+{
+    if (!data || !values) return MSL_NULL_BUFFER;
+
+    size_t i = 0;
+#ifdef RVALUE_ARRAY_HAS_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i first = _mm_loadu_si128((const __m128i*)&data[i]);
+        __m128i second = _mm_loadu_si128((const __m128i*)&data[i + 1]);
+        __m128i third = _mm_loadu_si128((const __m128i*)&data[i + 2]);
+        __m128i fourth = _mm_loadu_si128((const __m128i*)&data[i + 3]);
+
+        // VALUE_REAL is 0
+        __m128i kinds = ra_gather_kinds(first, second, third, fourth);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(kinds, _mm_setzero_si128())) != 0xFFFF) return MSL_INVALID_PARAMETER;
+
+        _mm_storeu_si128((__m128i*)&values[i], _mm_unpacklo_epi64(first, second));
+        _mm_storeu_si128((__m128i*)&values[i + 2], _mm_unpacklo_epi64(third, fourth));
+    }
+#endif // RVALUE_ARRAY_HAS_SSE2
+
+    for (; i < count; i++)
+    {
+        if ((data[i].kind & RVALUE_KIND_MASK) != VALUE_REAL) return MSL_INVALID_PARAMETER;
+        values[i] = data[i].real;
+    }
+
+    return MSL_SUCCESS;
+}
+
+// Overwrites plain elements with reals, nothing is written if one of them holds a reference
+int ra_write_reals(rvalue_t* data, size_t count, const double* values)
+{
+    if (!data || !values) return MSL_NULL_BUFFER;
+
+    size_t i = 0;
+#ifdef RVALUE_ARRAY_HAS_SSE2
+    // Arrays already holding reals are the common case, check them 4 at a time
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i kinds = ra_gather_kinds(
+            _mm_loadu_si128((const __m128i*)&data[i]),
+            _mm_loadu_si128((const __m128i*)&data[i + 1]),
+            _mm_loadu_si128((const __m128i*)&data[i + 2]),
+            _mm_loadu_si128((const __m128i*)&data[i + 3]));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(kinds, _mm_setzero_si128())) == 0xFFFF) continue;
+
+        for (size_t j = i; j < i + 4; j++)
+        {
+            if (!ra_is_plain(&data[j])) return MSL_INVALID_PARAMETER;
+        }
+    }
+#endif // RVALUE_ARRAY_HAS_SSE2
+
+    for (; i < count; i++)
+    {
+        if (!ra_is_plain(&data[i])) return MSL_INVALID_PARAMETER;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        data[i].real = values[i];
+        data[i].flags = 0;
+        data[i].kind = VALUE_REAL;
+    }
+
+    return MSL_SUCCESS;
+}
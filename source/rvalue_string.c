@@ -0,0 +1,141 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "../include/rvalue_string.h"
+#include "../include/error.h"
+
+// Doubles up to 2^53 are exact integers, the runner prints them without decimals
+#define RVALUE_STRING_EXACT_INTEGER_LIMIT 9007199254740992.0
+
+// Significant digits of the reals past that limit, as many as a double holds
+#define RVALUE_STRING_LARGE_REAL_DIGITS 15
+
+// Copies text into the caller buffer, length is what a large enough buffer would need
+static int rs_copy_to_buffer(const char* text, size_t text_length, char* buffer, size_t capacity, size_t* length)
+{
+    *length = text_length;
+    if (!buffer || capacity <= text_length) return MSL_INSUFFICIENT_MEMORY;
+
+    memcpy(buffer, text, text_length);
+    buffer[text_length] = '\0';
+    return MSL_SUCCESS;
+}
+
+// Same output as string() on a real: integers without decimals, anything else with two (1.5 is "1.50").
+// Past 2^53 every double is an integer, but "%.0f" would print up to 309 digits, an exponent is used there.
+static size_t rs_format_real(double value, char* scratch)
+{
+    int written = 0;
+
+    if (isnan(value))
+        written = snprintf(scratch, RVALUE_STRING_SCRATCH_SIZE, "NaN");
+    else if (isinf(value))
+        written = snprintf(scratch, RVALUE_STRING_SCRATCH_SIZE, value < 0 ? "-inf" : "inf");
+    else if (fabs(value) >= RVALUE_STRING_EXACT_INTEGER_LIMIT)
+        written = snprintf(scratch, RVALUE_STRING_SCRATCH_SIZE, "%.*g", RVALUE_STRING_LARGE_REAL_DIGITS, value);
+    else if (value == floor(value))
+        written = snprintf(scratch, RVALUE_STRING_SCRATCH_SIZE, "%.0f", value);
+    else
+        written = snprintf(scratch, RVALUE_STRING_SCRATCH_SIZE, "%.2f", value);
+
+    // -0.001 rounds to -0.00, the runner prints 0.00
+    if (!strcmp(scratch, "-0.00"))
+        written = snprintf(scratch, RVALUE_STRING_SCRATCH_SIZE, "0.00");
+
+    // Never more than what is in scratch, whatever snprintf would have needed
+    if (written < 0) written = 0;
+    if ((size_t)written >= RVALUE_STRING_SCRATCH_SIZE) written = RVALUE_STRING_SCRATCH_SIZE - 1;
+    return (size_t)written;
+}
+
+// The view stays valid as long as the runner holds a reference on the string,
+// copy it before yielding back to the game if it must outlive the current event.
+int rs_get_view(const rvalue_t* value, string_view_t* view)
+{
+    view->data = NULL;
+    view->length = 0;
+
+    if (!value) return MSL_NULL_BUFFER;
+    if ((value->kind & RVALUE_KIND_MASK) != VALUE_STRING) return MSL_INVALID_PARAMETER;
+
+    const ref_string_t* ref_string = (const ref_string_t*)value->pointer;
+    if (!ref_string || !ref_string->thing) return MSL_NULL_BUFFER;
+
+    view->data = ref_string->thing;
+    // Some runners leave size at 0 for literals
+    view->length = ref_string->size > 0 ? (size_t)ref_string->size : strlen(ref_string->thing);
+    return MSL_SUCCESS;
+}
+
+// Formats the scalar kinds without going through the runner.
+// MSL_INVALID_PARAMETER means the kind needs the runner, use rvalue_to_string for those.
+int rs_to_buffer(const rvalue_t* value, char* buffer, size_t capacity, size_t* length)
+{
+    *length = 0;
+    if (!value) return MSL_NULL_BUFFER;
+
+    char scratch[RVALUE_STRING_SCRATCH_SIZE];
+    size_t scratch_length = 0;
+
+    switch (value->kind & RVALUE_KIND_MASK)
+    {
+    case VALUE_STRING:
+    {
+        string_view_t view;
+        int last_status = rs_get_view(value, &view);
+        if (last_status != MSL_SUCCESS) return last_status;
+        return rs_copy_to_buffer(view.data, view.length, buffer, capacity, length);
+    }
+    case VALUE_REAL:
+        scratch_length = rs_format_real(value->real, scratch);
+        break;
+    case VALUE_INT32:
+        scratch_length = (size_t)snprintf(scratch, sizeof(scratch), "%d", value->i32);
+        break;
+    case VALUE_INT64:
+        scratch_length = (size_t)snprintf(scratch, sizeof(scratch), "%lld", (long long)value->i64);
+        break;
+    case VALUE_BOOL:
+        // Bools are stored as reals by the runner
+        scratch_length = (size_t)snprintf(scratch, sizeof(scratch), "%s", value->real != 0.0 ? "true" : "false");
+        break;
+    case VALUE_PTR:
+        scratch_length = (size_t)snprintf(scratch, sizeof(scratch), "%p", value->pointer);
+        break;
+    case VALUE_UNDEFINED:
+    case VALUE_UNSET:
+        scratch_length = (size_t)snprintf(scratch, sizeof(scratch), "undefined");
+        break;
+    case VALUE_NULL:
+        scratch_length = (size_t)snprintf(scratch, sizeof(scratch), "null");
+        break;
+    default:
+        return MSL_INVALID_PARAMETER;
+    }
+
+    return rs_copy_to_buffer(scratch, scratch_length, buffer, capacity, length);
+}
+
+// Builds a VALUE_STRING rvalue over a caller owned ref string, nothing is allocated.
+// Only hand it to callees that don't keep the value, like asset lookups:
+// storage and text must outlive every use the runner makes of it.
+int rs_init_borrowed(ref_string_t* storage, const char* text, rvalue_t* value)
+{
+    if (!storage || !text) return MSL_NULL_BUFFER;
+
+    size_t length = strlen(text);
+    if (length > INT32_MAX) return MSL_INVALID_PARAMETER;
+
+    storage->thing = text;
+    storage->ref_count = RVALUE_STRING_PINNED_REF_COUNT;
+    storage->size = (int32_t)length;
+
+    value->pointer = storage;
+    value->flags = 0;
+    value->kind = VALUE_STRING;
+    return MSL_SUCCESS;
+}
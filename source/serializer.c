@@ -0,0 +1,571 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/serializer.h"
+#include "../include/rvalue_string.h"
+#include "../include/rvalue_array.h"
+#include "../include/error.h"
+
+static int sr_write_value(serializer_t*, rvalue_t*);
+static int sr_read_value(serializer_t*, rvalue_t*);
+
+static void sr_set_undefined(rvalue_t* value)
+{
+    value->real = 0;
+    value->flags = 0;
+    value->kind = VALUE_UNDEFINED;
+}
+
+// Kinds holding no reference can be stored in an array slot as is
+static int sr_is_plain(const rvalue_t* value)
+{
+    uint32_t kind = (uint32_t)value->kind & RVALUE_KIND_MASK;
+    return kind < 32 && (RVALUE_ARRAY_PLAIN_KINDS & (1u << kind));
+}
+
+static int sr_flush(serializer_t* serializer)
+{
+    if (serializer->buffer_used == 0) return MSL_SUCCESS;
+
+    size_t written = fwrite(serializer->buffer, 1, serializer->buffer_used, serializer->file);
+    if (written != serializer->buffer_used) return MSL_ACCESS_DENIED;
+
+    serializer->buffer_used = 0;
+    return MSL_SUCCESS;
+}
+
+static int sr_write(serializer_t* serializer, const void* data, size_t size)
+{
+    if (size > SERIALIZER_BUFFER_SIZE - serializer->buffer_used)
+    {
+        int last_status = sr_flush(serializer);
+        if (last_status != MSL_SUCCESS) return last_status;
+
+        // Too large to be worth buffering
+        if (size >= SERIALIZER_BUFFER_SIZE)
+            return fwrite(data, 1, size, serializer->file) == size ? MSL_SUCCESS : MSL_ACCESS_DENIED;
+    }
+
+    memcpy(serializer->buffer + serializer->buffer_used, data, size);
+    serializer->buffer_used += size;
+    return MSL_SUCCESS;
+}
+
+static int sr_write_header(serializer_t* serializer, uint8_t tag, uint32_t count)
+{
+    int last_status = sr_write(serializer, &tag, sizeof(tag));
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    return sr_write(serializer, &count, sizeof(count));
+}
+
+// The first occurrence of a text is written out, the next ones only refer to it
+static int sr_write_string(serializer_t* serializer, const char* text, size_t length)
+{
+    int last_status = MSL_SUCCESS;
+
+    int32_t index = -1;
+    if (GET_VALUE(str, int32_t)(&serializer->string_indices, text, &index) == MSL_SUCCESS)
+        return sr_write_header(serializer, SERIALIZER_TAG_STRING_REF, (uint32_t)index);
+
+    if (length > UINT32_MAX || serializer->string_count >= INT32_MAX) return MSL_INVALID_PARAMETER;
+
+    last_status = sr_write_header(serializer, SERIALIZER_TAG_STRING, (uint32_t)length);
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    last_status = sr_write(serializer, text, length);
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    return INSERT(str, int32_t)(&serializer->string_indices, text, (int32_t)(serializer->string_count++));
+}
+
+static int sr_write_array(serializer_t* serializer, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+
+    if (!serializer->runner->YYArrayGetLength) return MSL_EXTERNAL_ERROR;
+
+    int length = serializer->runner->YYArrayGetLength(value);
+    if (length < 0) return MSL_EXTERNAL_ERROR;
+
+    rvalue_t* data = NULL;
+    if (length > 0)
+    {
+        last_status = ra_get_data(value, serializer->rvalue_array_offset, &data);
+        if (last_status != MSL_SUCCESS) return last_status;
+    }
+
+    last_status = sr_write_header(serializer, SERIALIZER_TAG_ARRAY, (uint32_t)length);
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    for (int i = 0; i < length && last_status == MSL_SUCCESS; i++)
+    {
+        last_status = sr_write_value(serializer, &data[i]);
+    }
+
+    return last_status;
+}
+
+static int sr_reserve_keys(serializer_t* serializer, size_t count)
+{
+    if (serializer->key_count + count <= serializer->key_capacity) return MSL_SUCCESS;
+
+    size_t capacity = serializer->key_capacity ? serializer->key_capacity : 64;
+    while (capacity < serializer->key_count + count) capacity *= 2;
+
+    const char** keys = (const char**)realloc((void*)serializer->keys, capacity * sizeof(const char*));
+    if (!keys) return MSL_ALLOCATION_ERROR;
+
+    serializer->keys = keys;
+    serializer->key_capacity = capacity;
+    return MSL_SUCCESS;
+}
+
+// The struct is marked through visited while its members are written,
+// meeting the mark again means the graph loops back on itself.
+// Structs shared without a cycle are written once per reference.
+//
+// Members are read through StructGetKeys and StructGetMember, not yyvars_map:
+// the map is keyed by slot and only the runner knows the name of a slot,
+// while the file needs names so the reader can rebuild the struct with StructAdd*.
+static int sr_write_struct(serializer_t* serializer, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+
+    yyobject_base_t* object = (yyobject_base_t*)(value->object);
+    if (!object) return MSL_NULL_BUFFER;
+
+    // Instances, methods and the like can't be rebuilt from their members
+    if (object->object_kind != OBJECT_KIND_YYOBJECTBASE) return MSL_INVALID_PARAMETER;
+    if (object->visited == SERIALIZER_VISITED_MARK) return MSL_INVALID_PARAMETER;
+
+    const yyrunner_interface_t* runner = serializer->runner;
+    if (!runner->StructGetKeys || !runner->StructGetMember) return MSL_EXTERNAL_ERROR;
+
+    int count = runner->StructGetKeys(value, NULL, NULL);
+    if (count < 0) return MSL_EXTERNAL_ERROR;
+
+    last_status = sr_reserve_keys(serializer, (size_t)count);
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    // Nested structs may move the stack, keys are read back through their index
+    size_t first_key = serializer->key_count;
+    runner->StructGetKeys(value, serializer->keys + first_key, &count);
+    serializer->key_count += (size_t)count;
+
+    uint32_t visited = object->visited;
+    object->visited = SERIALIZER_VISITED_MARK;
+
+    last_status = sr_write_header(serializer, SERIALIZER_TAG_STRUCT, (uint32_t)count);
+
+    for (int i = 0; i < count && last_status == MSL_SUCCESS; i++)
+    {
+        const char* name = serializer->keys[first_key + i];
+        rvalue_t* member = runner->StructGetMember(value, name);
+        if (!member)
+        {
+            last_status = MSL_OBJECT_NOT_FOUND;
+            break;
+        }
+
+        last_status = sr_write_string(serializer, name, strlen(name));
+        if (last_status != MSL_SUCCESS) break;
+
+        last_status = sr_write_value(serializer, member);
+    }
+
+    object->visited = visited;
+    serializer->key_count = first_key;
+    return last_status;
+}
+
+static int sr_write_value(serializer_t* serializer, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+    uint8_t tag = SERIALIZER_TAG_UNDEFINED;
+
+    switch (value->kind & RVALUE_KIND_MASK)
+    {
+    case VALUE_REAL:
+        tag = SERIALIZER_TAG_REAL;
+        last_status = sr_write(serializer, &tag, sizeof(tag));
+        if (last_status != MSL_SUCCESS) return last_status;
+        return sr_write(serializer, &value->real, sizeof(value->real));
+    case VALUE_INT32:
+        tag = SERIALIZER_TAG_INT32;
+        last_status = sr_write(serializer, &tag, sizeof(tag));
+        if (last_status != MSL_SUCCESS) return last_status;
+        return sr_write(serializer, &value->i32, sizeof(value->i32));
+    case VALUE_INT64:
+        tag = SERIALIZER_TAG_INT64;
+        last_status = sr_write(serializer, &tag, sizeof(tag));
+        if (last_status != MSL_SUCCESS) return last_status;
+        return sr_write(serializer, &value->i64, sizeof(value->i64));
+    case VALUE_BOOL:
+    {
+        uint8_t payload[2] = { SERIALIZER_TAG_BOOL, value->real != 0.0 };
+        return sr_write(serializer, payload, sizeof(payload));
+    }
+    case VALUE_UNDEFINED:
+    case VALUE_UNSET:
+        tag = SERIALIZER_TAG_UNDEFINED;
+        return sr_write(serializer, &tag, sizeof(tag));
+    case VALUE_NULL:
+        tag = SERIALIZER_TAG_NULL;
+        return sr_write(serializer, &tag, sizeof(tag));
+    case VALUE_STRING:
+    {
+        string_view_t view;
+        last_status = rs_get_view(value, &view);
+        if (last_status != MSL_SUCCESS) return last_status;
+        return sr_write_string(serializer, view.data, view.length);
+    }
+    case VALUE_ARRAY:
+    case VALUE_OBJECT:
+        break;
+    default:
+        return MSL_INVALID_PARAMETER;
+    }
+
+    if (serializer->depth >= SERIALIZER_MAX_DEPTH) return MSL_INVALID_PARAMETER;
+
+    serializer->depth++;
+    if ((value->kind & RVALUE_KIND_MASK) == VALUE_ARRAY)
+        last_status = sr_write_array(serializer, value);
+    else
+        last_status = sr_write_struct(serializer, value);
+    serializer->depth--;
+
+    return last_status;
+}
+
+static int sr_read(serializer_t* serializer, void* data, size_t size)
+{
+    uint8_t* destination = (uint8_t*)data;
+
+    while (size > 0)
+    {
+        if (serializer->buffer_read == serializer->buffer_used)
+        {
+            serializer->buffer_used = fread(serializer->buffer, 1, SERIALIZER_BUFFER_SIZE, serializer->file);
+            serializer->buffer_read = 0;
+            if (serializer->buffer_used == 0) return MSL_UNREADABLE_FILE;
+        }
+
+        size_t available = serializer->buffer_used - serializer->buffer_read;
+        size_t chunk = size < available ? size : available;
+        memcpy(destination, serializer->buffer + serializer->buffer_read, chunk);
+
+        serializer->buffer_read += chunk;
+        destination += chunk;
+        size -= chunk;
+    }
+
+    return MSL_SUCCESS;
+}
+
+// Reads what follows a string tag, the text stays owned by the table
+static int sr_read_string(serializer_t* serializer, uint8_t tag, const char** text)
+{
+    int last_status = MSL_SUCCESS;
+
+    uint32_t value = 0;
+    last_status = sr_read(serializer, &value, sizeof(value));
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    if (tag == SERIALIZER_TAG_STRING_REF)
+    {
+        if (value >= serializer->string_count) return MSL_UNREADABLE_FILE;
+
+        *text = serializer->strings[value];
+        return MSL_SUCCESS;
+    }
+
+    if (serializer->string_count == serializer->string_capacity)
+    {
+        uint32_t capacity = serializer->string_capacity ? serializer->string_capacity * 2 : 64;
+        char** strings = (char**)realloc(serializer->strings, capacity * sizeof(char*));
+        if (!strings) return MSL_ALLOCATION_ERROR;
+
+        serializer->strings = strings;
+        serializer->string_capacity = capacity;
+    }
+
+    char* string = (char*)malloc((size_t)value + 1);
+    if (!string) return MSL_ALLOCATION_ERROR;
+
+    last_status = sr_read(serializer, string, value);
+    if (last_status != MSL_SUCCESS)
+    {
+        free(string);
+        return last_status;
+    }
+    string[value] = '\0';
+
+    serializer->strings[serializer->string_count++] = string;
+    *text = string;
+    return MSL_SUCCESS;
+}
+
+static int sr_read_name(serializer_t* serializer, const char** name)
+{
+    uint8_t tag = 0;
+    int last_status = sr_read(serializer, &tag, sizeof(tag));
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    if (tag != SERIALIZER_TAG_STRING && tag != SERIALIZER_TAG_STRING_REF) return MSL_UNREADABLE_FILE;
+
+    return sr_read_string(serializer, tag, name);
+}
+
+// Elements are built one by one then moved into the array the runner created
+static int sr_read_array(serializer_t* serializer, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+    const yyrunner_interface_t* runner = serializer->runner;
+
+    if (!runner->YYCreateArray || !runner->COPY_rvalue_t || !runner->FREE_rvalue_t) return MSL_EXTERNAL_ERROR;
+
+    uint32_t count = 0;
+    last_status = sr_read(serializer, &count, sizeof(count));
+    if (last_status != MSL_SUCCESS) return last_status;
+    if (count > INT32_MAX) return MSL_UNREADABLE_FILE;
+
+    // The runner wants initial values, zeros are overwritten below
+    double* zeros = (double*)calloc(count ? count : 1, sizeof(double));
+    if (!zeros) return MSL_ALLOCATION_ERROR;
+
+    runner->YYCreateArray(value, (int)count, zeros);
+    free(zeros);
+
+    rvalue_t* data = NULL;
+    if (count > 0)
+    {
+        last_status = ra_get_data(value, serializer->rvalue_array_offset, &data);
+        if (last_status != MSL_SUCCESS) goto error;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        rvalue_t element;
+        last_status = sr_read_value(serializer, &element);
+        if (last_status != MSL_SUCCESS) goto error;
+
+        if (sr_is_plain(&element))
+        {
+            data[i] = element;
+            continue;
+        }
+
+        runner->COPY_rvalue_t(&data[i], &element);
+        runner->FREE_rvalue_t(&element);
+    }
+
+    return MSL_SUCCESS;
+
+error:
+    runner->FREE_rvalue_t(value);
+    sr_set_undefined(value);
+    return last_status;
+}
+
+static int sr_read_struct(serializer_t* serializer, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+    const yyrunner_interface_t* runner = serializer->runner;
+
+    if (!runner->StructCreate || !runner->StructAddrvalue_t || !runner->FREE_rvalue_t) return MSL_EXTERNAL_ERROR;
+
+    uint32_t count = 0;
+    last_status = sr_read(serializer, &count, sizeof(count));
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    runner->StructCreate(value);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const char* name = NULL;
+        last_status = sr_read_name(serializer, &name);
+        if (last_status != MSL_SUCCESS) goto error;
+
+        rvalue_t member;
+        last_status = sr_read_value(serializer, &member);
+        if (last_status != MSL_SUCCESS) goto error;
+
+        // The struct takes its own reference
+        runner->StructAddrvalue_t(value, name, &member);
+        runner->FREE_rvalue_t(&member);
+    }
+
+    return MSL_SUCCESS;
+
+error:
+    runner->FREE_rvalue_t(value);
+    sr_set_undefined(value);
+    return last_status;
+}
+
+static int sr_read_value(serializer_t* serializer, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+    sr_set_undefined(value);
+
+    uint8_t tag = 0;
+    last_status = sr_read(serializer, &tag, sizeof(tag));
+    if (last_status != MSL_SUCCESS) return last_status;
+
+    switch (tag)
+    {
+    case SERIALIZER_TAG_REAL:
+        value->kind = VALUE_REAL;
+        return sr_read(serializer, &value->real, sizeof(value->real));
+    case SERIALIZER_TAG_INT32:
+        value->kind = VALUE_INT32;
+        return sr_read(serializer, &value->i32, sizeof(value->i32));
+    case SERIALIZER_TAG_INT64:
+        value->kind = VALUE_INT64;
+        return sr_read(serializer, &value->i64, sizeof(value->i64));
+    case SERIALIZER_TAG_BOOL:
+    {
+        uint8_t boolean = 0;
+        last_status = sr_read(serializer, &boolean, sizeof(boolean));
+        value->real = boolean ? 1.0 : 0.0;
+        value->kind = VALUE_BOOL;
+        return last_status;
+    }
+    case SERIALIZER_TAG_UNDEFINED:
+        return MSL_SUCCESS;
+    case SERIALIZER_TAG_NULL:
+        value->kind = VALUE_NULL;
+        return MSL_SUCCESS;
+    case SERIALIZER_TAG_STRING:
+    case SERIALIZER_TAG_STRING_REF:
+    {
+        if (!serializer->runner->YYCreateString) return MSL_EXTERNAL_ERROR;
+
+        const char* text = NULL;
+        last_status = sr_read_string(serializer, tag, &text);
+        if (last_status != MSL_SUCCESS) return last_status;
+
+        serializer->runner->YYCreateString(value, text);
+        return MSL_SUCCESS;
+    }
+    case SERIALIZER_TAG_ARRAY:
+    case SERIALIZER_TAG_STRUCT:
+        break;
+    default:
+        return MSL_UNREADABLE_FILE;
+    }
+
+    if (serializer->depth >= SERIALIZER_MAX_DEPTH) return MSL_UNREADABLE_FILE;
+
+    serializer->depth++;
+    if (tag == SERIALIZER_TAG_ARRAY)
+        last_status = sr_read_array(serializer, value);
+    else
+        last_status = sr_read_struct(serializer, value);
+    serializer->depth--;
+
+    return last_status;
+}
+
+static int sr_init(serializer_t* serializer, const yyrunner_interface_t* runner, int64_t rvalue_array_offset)
+{
+    memset(serializer, 0, sizeof(*serializer));
+    if (!runner) return MSL_NULL_BUFFER;
+
+    serializer->runner = runner;
+    serializer->rvalue_array_offset = rvalue_array_offset;
+
+    serializer->buffer = (uint8_t*)malloc(SERIALIZER_BUFFER_SIZE);
+    if (!serializer->buffer) return MSL_ALLOCATION_ERROR;
+
+    return MSL_SUCCESS;
+}
+
+static void sr_destroy(serializer_t* serializer)
+{
+    if (serializer->file) fclose(serializer->file);
+
+    for (uint32_t i = 0; i < serializer->string_count && serializer->strings; i++)
+    {
+        free(serializer->strings[i]);
+    }
+
+    free(serializer->strings);
+    free((void*)serializer->keys);
+    free(serializer->buffer);
+    DESTROY_HASHMAP(str, int32_t)(&serializer->string_indices);
+    memset(serializer, 0, sizeof(*serializer));
+}
+
+// Writes the value and everything it holds to path, replacing the file
+int sr_save(const yyrunner_interface_t* runner, int64_t rvalue_array_offset, rvalue_t* value, const char* path)
+{
+    int last_status = MSL_SUCCESS;
+
+    serializer_t serializer;
+    last_status = sr_init(&serializer, runner, rvalue_array_offset);
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
+    serializer.file = fopen(path, "wb");
+    if (!serializer.file)
+    {
+        last_status = MSL_ACCESS_DENIED;
+        goto cleanup;
+    }
+
+    uint32_t header[2] = { SERIALIZER_MAGIC, SERIALIZER_VERSION };
+    last_status = sr_write(&serializer, header, sizeof(header));
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
+    last_status = sr_write_value(&serializer, value);
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
+    last_status = sr_flush(&serializer);
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
+    if (fclose(serializer.file) != 0) last_status = MSL_ACCESS_DENIED;
+    serializer.file = NULL;
+
+cleanup:
+    sr_destroy(&serializer);
+    return last_status;
+}
+
+// Rebuilds a value saved by sr_save, the caller owns it and frees it with FREE_rvalue_t
+int sr_load(const yyrunner_interface_t* runner, int64_t rvalue_array_offset, const char* path, rvalue_t* value)
+{
+    int last_status = MSL_SUCCESS;
+    sr_set_undefined(value);
+
+    serializer_t serializer;
+    last_status = sr_init(&serializer, runner, rvalue_array_offset);
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
+    serializer.file = fopen(path, "rb");
+    if (!serializer.file)
+    {
+        last_status = MSL_ACCESS_DENIED;
+        goto cleanup;
+    }
+
+    uint32_t header[2] = { 0, 0 };
+    last_status = sr_read(&serializer, header, sizeof(header));
+    if (last_status != MSL_SUCCESS) goto cleanup;
+
+    if (header[0] != SERIALIZER_MAGIC || header[1] != SERIALIZER_VERSION)
+    {
+        last_status = MSL_INVALID_SIGNATURE;
+        goto cleanup;
+    }
+
+    last_status = sr_read_value(&serializer, value);
+
+cleanup:
+    sr_destroy(&serializer);
+    return last_status;
+}
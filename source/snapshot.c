@@ -0,0 +1,317 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stddef.h>
+#include <xmmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif // __AVX2__
+#include "../include/snapshot.h"
+#include "../include/error.h"
+
+// Floats between two field arrays, one cache line
+#define SNAPSHOT_ARRAY_PADDING 16
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SNAPSHOT_HAS_SSE 1
+#endif
+
+// Where each field lives in instance_internal_t, in SNAPSHOT_FIELD order
+static const size_t snapshot_member_offsets[SNAPSHOT_FIELD_COUNT] =
+{
+    offsetof(instance_internal_t, x),
+    offsetof(instance_internal_t, y),
+    offsetof(instance_internal_t, speed),
+    offsetof(instance_internal_t, direction),
+    offsetof(instance_internal_t, horizontal_speed),
+    offsetof(instance_internal_t, vertical_speed),
+    offsetof(instance_internal_t, image_index),
+    offsetof(instance_internal_t, image_speed),
+    offsetof(instance_internal_t, image_scale_x),
+    offsetof(instance_internal_t, image_scale_y),
+    offsetof(instance_internal_t, image_angle),
+    offsetof(instance_internal_t, image_alpha),
+    offsetof(instance_internal_t, bounding_box.left),
+    offsetof(instance_internal_t, bounding_box.top),
+    offsetof(instance_internal_t, bounding_box.right),
+    offsetof(instance_internal_t, bounding_box.bottom),
+};
+
+// Where each field array lives in instance_snapshot_t, in SNAPSHOT_FIELD order
+static const size_t snapshot_array_offsets[SNAPSHOT_FIELD_COUNT] =
+{
+    offsetof(instance_snapshot_t, x),
+    offsetof(instance_snapshot_t, y),
+    offsetof(instance_snapshot_t, speed),
+    offsetof(instance_snapshot_t, direction),
+    offsetof(instance_snapshot_t, horizontal_speed),
+    offsetof(instance_snapshot_t, vertical_speed),
+    offsetof(instance_snapshot_t, image_index),
+    offsetof(instance_snapshot_t, image_speed),
+    offsetof(instance_snapshot_t, image_scale_x),
+    offsetof(instance_snapshot_t, image_scale_y),
+    offsetof(instance_snapshot_t, image_angle),
+    offsetof(instance_snapshot_t, image_alpha),
+    offsetof(instance_snapshot_t, bbox_left),
+    offsetof(instance_snapshot_t, bbox_top),
+    offsetof(instance_snapshot_t, bbox_right),
+    offsetof(instance_snapshot_t, bbox_bottom),
+};
+
+static float** sn_field_array(const instance_snapshot_t* snapshot, size_t field)
+{
+    return (float**)((char*)(snapshot) + snapshot_array_offsets[field]);
+}
+
+static float* sn_field_member(instance_t* instance, size_t members_offset, size_t field)
+{
+    return (float*)((char*)(instance) + members_offset + snapshot_member_offsets[field]);
+}
+
+// Grows every array, keeping the instances captured so far
+static int sn_reserve(instance_snapshot_t* snapshot, size_t capacity)
+{
+    if (capacity <= snapshot->capacity) return MSL_SUCCESS;
+
+    size_t new_capacity = snapshot->capacity ? snapshot->capacity : SNAPSHOT_BATCH_SIZE;
+    while (new_capacity < capacity) new_capacity *= 2;
+
+    instance_t** instances = (instance_t**)realloc(snapshot->instances, sizeof(instance_t*) * new_capacity);
+    if (!instances) return MSL_ALLOCATION_ERROR;
+    snapshot->instances = instances;
+
+    // Arrays a power of two apart share their cache sets, writing all of them at once thrashes L1
+    size_t stride = new_capacity + SNAPSHOT_ARRAY_PADDING;
+    float* arena = (float*)malloc(sizeof(float) * SNAPSHOT_FIELD_COUNT * stride);
+    if (!arena) return MSL_ALLOCATION_ERROR;
+
+    for (size_t field = 0; field < SNAPSHOT_FIELD_COUNT; field++)
+    {
+        float** values = sn_field_array(snapshot, field);
+        if (snapshot->count) memcpy(&arena[field * stride], *values, sizeof(float) * snapshot->count);
+        *values = &arena[field * stride];
+    }
+
+    free(snapshot->arena);
+    snapshot->arena = arena;
+    snapshot->capacity = new_capacity;
+    return MSL_SUCCESS;
+}
+
+static void sn_gather(instance_snapshot_t* snapshot, size_t index)
+{
+    const instance_internal_t* members = (const instance_internal_t*)((char*)(snapshot->instances[index]) + snapshot->members_offset);
+    snapshot->x[index] = members->x;
+    snapshot->y[index] = members->y;
+    snapshot->speed[index] = members->speed;
+    snapshot->direction[index] = members->direction;
+    snapshot->horizontal_speed[index] = members->horizontal_speed;
+    snapshot->vertical_speed[index] = members->vertical_speed;
+    snapshot->image_index[index] = members->image_index;
+    snapshot->image_speed[index] = members->image_speed;
+    snapshot->image_scale_x[index] = members->image_scale_x;
+    snapshot->image_scale_y[index] = members->image_scale_y;
+    snapshot->image_angle[index] = members->image_angle;
+    snapshot->image_alpha[index] = members->image_alpha;
+    snapshot->bbox_left[index] = members->bounding_box.left;
+    snapshot->bbox_top[index] = members->bounding_box.top;
+    snapshot->bbox_right[index] = members->bounding_box.right;
+    snapshot->bbox_bottom[index] = members->bounding_box.bottom;
+}
+
+// Gathers every instance left in the iterator. The snapshot can be zeroed
+// before the first capture, then reused frame after frame without reallocating.
+int sn_capture(instance_iterator_t* iterator, instance_snapshot_t* snapshot)
+{
+    int last_status = MSL_SUCCESS;
+    size_t batch_count = 0;
+
+    // Fields are read through the members offset, the layout must be known
+    if (iterator->members_offset == INSTANCE_MEMBERS_OFFSET_UNKNOWN) return MSL_INVALID_PARAMETER;
+
+    snapshot->count = 0;
+    snapshot->members_offset = iterator->members_offset;
+
+    do
+    {
+        CHECK_CALL(sn_reserve, snapshot, snapshot->count + SNAPSHOT_BATCH_SIZE);
+        CHECK_CALL(rm_iterator_next_batch, iterator, &snapshot->instances[snapshot->count], SNAPSHOT_BATCH_SIZE, &batch_count);
+
+        // The batch was just walked, its records are still in cache.
+        // Fields are copied by name rather than through the offset tables, it's the hot loop.
+        for (size_t i = snapshot->count; i < snapshot->count + batch_count; i++)
+            sn_gather(snapshot, i);
+
+        snapshot->count += batch_count;
+    } while (batch_count);
+
+    return last_status;
+}
+
+// Writes the fields of the mask back into the instances. Unchanged values
+// are skipped, so untouched instances don't get their cache lines dirtied.
+int sn_apply(const instance_snapshot_t* snapshot, uint32_t fields)
+{
+    if (snapshot->members_offset == INSTANCE_MEMBERS_OFFSET_UNKNOWN) return MSL_INVALID_PARAMETER;
+
+    for (size_t field = 0; field < SNAPSHOT_FIELD_COUNT; field++)
+    {
+        if (!(fields & (1u << field))) continue;
+
+        const float* values = *sn_field_array(snapshot, field);
+        for (size_t i = 0; i < snapshot->count; i++)
+        {
+            float* member = sn_field_member(snapshot->instances[i], snapshot->members_offset, field);
+            if (*member != values[i]) *member = values[i];
+        }
+    }
+
+    return MSL_SUCCESS;
+}
+
+int sn_destroy(instance_snapshot_t* snapshot)
+{
+    if (!snapshot) return MSL_NULL_BUFFER;
+
+    free(snapshot->instances);
+    free(snapshot->arena);
+    memset(snapshot, 0, sizeof(instance_snapshot_t));
+    return MSL_SUCCESS;
+}
+
+static void sn_distance_squared_scalar(const instance_snapshot_t* snapshot, size_t start, float x, float y, float* distances)
+{
+    for (size_t i = start; i < snapshot->count; i++)
+    {
+        float dx = snapshot->x[i] - x;
+        float dy = snapshot->y[i] - y;
+        distances[i] = dx * dx + dy * dy;
+    }
+}
+
+static void sn_integrate_speed_scalar(instance_snapshot_t* snapshot, size_t start, float delta)
+{
+    for (size_t i = start; i < snapshot->count; i++)
+    {
+        snapshot->x[i] += snapshot->horizontal_speed[i] * delta;
+        snapshot->y[i] += snapshot->vertical_speed[i] * delta;
+    }
+}
+
+int sn_distance_squared_sse(const instance_snapshot_t* snapshot, float x, float y, float* distances)
+{
+#ifdef SNAPSHOT_HAS_SSE
+    __m128 point_x = _mm_set1_ps(x);
+    __m128 point_y = _mm_set1_ps(y);
+
+    size_t i = 0;
+    for (; i + 4 <= snapshot->count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&snapshot->x[i]), point_x);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&snapshot->y[i]), point_y);
+        _mm_storeu_ps(&distances[i], _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+    }
+
+    sn_distance_squared_scalar(snapshot, i, x, y, distances);
+    return MSL_SUCCESS;
+#else
+    (void)snapshot;
+    (void)x;
+    (void)y;
+    (void)distances;
+    return MSL_INVALID_ARCH;
+#endif // SNAPSHOT_HAS_SSE
+}
+
+int sn_distance_squared_avx2(const instance_snapshot_t* snapshot, float x, float y, float* distances)
+{
+#ifdef __AVX2__
+    __m256 point_x = _mm256_set1_ps(x);
+    __m256 point_y = _mm256_set1_ps(y);
+
+    size_t i = 0;
+    for (; i + 8 <= snapshot->count; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&snapshot->x[i]), point_x);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&snapshot->y[i]), point_y);
+        _mm256_storeu_ps(&distances[i], _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+    }
+
+    sn_distance_squared_scalar(snapshot, i, x, y, distances);
+    return MSL_SUCCESS;
+#else
+    (void)snapshot;
+    (void)x;
+    (void)y;
+    (void)distances;
+    return MSL_INVALID_ARCH;
+#endif // __AVX2__
+}
+
+// Squared distance of every instance to a point, picks the widest kernel available
+int sn_distance_squared(const instance_snapshot_t* snapshot, float x, float y, float* distances)
+{
+    if (sn_distance_squared_avx2(snapshot, x, y, distances) == MSL_SUCCESS) return MSL_SUCCESS;
+    if (sn_distance_squared_sse(snapshot, x, y, distances) == MSL_SUCCESS) return MSL_SUCCESS;
+
+    sn_distance_squared_scalar(snapshot, 0, x, y, distances);
+    return MSL_SUCCESS;
+}
+
+int sn_integrate_speed_sse(instance_snapshot_t* snapshot, float delta)
+{
+#ifdef SNAPSHOT_HAS_SSE
+    __m128 step = _mm_set1_ps(delta);
+
+    size_t i = 0;
+    for (; i + 4 <= snapshot->count; i += 4)
+    {
+        __m128 x = _mm_add_ps(_mm_loadu_ps(&snapshot->x[i]), _mm_mul_ps(_mm_loadu_ps(&snapshot->horizontal_speed[i]), step));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(&snapshot->y[i]), _mm_mul_ps(_mm_loadu_ps(&snapshot->vertical_speed[i]), step));
+        _mm_storeu_ps(&snapshot->x[i], x);
+        _mm_storeu_ps(&snapshot->y[i], y);
+    }
+
+    sn_integrate_speed_scalar(snapshot, i, delta);
+    return MSL_SUCCESS;
+#else
+    (void)snapshot;
+    (void)delta;
+    return MSL_INVALID_ARCH;
+#endif // SNAPSHOT_HAS_SSE
+}
+
+int sn_integrate_speed_avx2(instance_snapshot_t* snapshot, float delta)
+{
+#ifdef __AVX2__
+    __m256 step = _mm256_set1_ps(delta);
+
+    size_t i = 0;
+    for (; i + 8 <= snapshot->count; i += 8)
+    {
+        // No fused multiply-add, AVX2 doesn't imply FMA and the results stay the same as the other kernels
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(&snapshot->x[i]), _mm256_mul_ps(_mm256_loadu_ps(&snapshot->horizontal_speed[i]), step));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(&snapshot->y[i]), _mm256_mul_ps(_mm256_loadu_ps(&snapshot->vertical_speed[i]), step));
+        _mm256_storeu_ps(&snapshot->x[i], x);
+        _mm256_storeu_ps(&snapshot->y[i], y);
+    }
+
+    sn_integrate_speed_scalar(snapshot, i, delta);
+    return MSL_SUCCESS;
+#else
+    (void)snapshot;
+    (void)delta;
+    return MSL_INVALID_ARCH;
+#endif // __AVX2__
+}
+
+// Moves every instance by its horizontal and vertical speed, scaled by delta
+int sn_integrate_speed(instance_snapshot_t* snapshot, float delta)
+{
+    if (sn_integrate_speed_avx2(snapshot, delta) == MSL_SUCCESS) return MSL_SUCCESS;
+    if (sn_integrate_speed_sse(snapshot, delta) == MSL_SUCCESS) return MSL_SUCCESS;
+
+    sn_integrate_speed_scalar(snapshot, 0, delta);
+    return MSL_SUCCESS;
+}
@@ -0,0 +1,384 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <math.h>
+#include "../include/spatial.h"
+#include "../include/error.h"
+
+FUNC_HASH(p_instance_t, int32_t)
+
+// Buckets the grid starts with, grown to stay above the number of entries
+#define SPATIAL_MIN_BUCKET_COUNT 64
+
+static uint64_t sg_pack_cell(int32_t cell_x, int32_t cell_y)
+{
+    return ((uint64_t)(uint32_t)(cell_x) << 32) | (uint32_t)(cell_y);
+}
+
+static int32_t sg_cell_x(uint64_t cell)
+{
+    return (int32_t)(uint32_t)(cell >> 32);
+}
+
+static int32_t sg_cell_y(uint64_t cell)
+{
+    return (int32_t)(uint32_t)(cell);
+}
+
+static int32_t sg_cell_coordinate(const spatial_grid_t* grid, float position)
+{
+    return (int32_t)(floorf(position * grid->inverse_cell_size));
+}
+
+static uint32_t sg_bucket_of(const spatial_grid_t* grid, uint64_t cell)
+{
+    return (uint32_t)((cell * 0x9E3779B97F4A7C15ull) >> 32) & (grid->bucket_count - 1);
+}
+
+static void sg_link(spatial_grid_t* grid, int32_t index)
+{
+    spatial_entry_t* entry = &grid->entries[index];
+    uint32_t bucket = sg_bucket_of(grid, entry->cell);
+
+    entry->previous = SPATIAL_NO_ENTRY;
+    entry->next = grid->buckets[bucket];
+    if (entry->next != SPATIAL_NO_ENTRY) grid->entries[entry->next].previous = index;
+    grid->buckets[bucket] = index;
+}
+
+static void sg_unlink(spatial_grid_t* grid, int32_t index)
+{
+    spatial_entry_t* entry = &grid->entries[index];
+
+    if (entry->previous != SPATIAL_NO_ENTRY) grid->entries[entry->previous].next = entry->next;
+    else grid->buckets[sg_bucket_of(grid, entry->cell)] = entry->next;
+
+    if (entry->next != SPATIAL_NO_ENTRY) grid->entries[entry->next].previous = entry->previous;
+}
+
+// Buckets are rebuilt from the live entries, the cells don't change
+static int sg_resize_buckets(spatial_grid_t* grid, uint32_t bucket_count)
+{
+    int32_t* buckets = (int32_t*)malloc(sizeof(int32_t) * bucket_count);
+    if (!buckets) return MSL_ALLOCATION_ERROR;
+
+    free(grid->buckets);
+    grid->buckets = buckets;
+    grid->bucket_count = bucket_count;
+    for (uint32_t b = 0; b < bucket_count; b++)
+        grid->buckets[b] = SPATIAL_NO_ENTRY;
+
+    for (int32_t i = 0; i < grid->entry_count; i++)
+    {
+        if (grid->entries[i].instance) sg_link(grid, i);
+    }
+
+    return MSL_SUCCESS;
+}
+
+static int sg_allocate_entry(spatial_grid_t* grid, int32_t* index)
+{
+    if (grid->free_entry != SPATIAL_NO_ENTRY)
+    {
+        *index = grid->free_entry;
+        grid->free_entry = grid->entries[*index].next;
+        return MSL_SUCCESS;
+    }
+
+    if (grid->entry_count == grid->entry_capacity)
+    {
+        int32_t capacity = grid->entry_capacity ? grid->entry_capacity * 2 : SPATIAL_MIN_BUCKET_COUNT;
+        spatial_entry_t* entries = (spatial_entry_t*)realloc(grid->entries, sizeof(spatial_entry_t) * capacity);
+        if (!entries) return MSL_ALLOCATION_ERROR;
+
+        grid->entries = entries;
+        grid->entry_capacity = capacity;
+    }
+
+    *index = grid->entry_count++;
+    return MSL_SUCCESS;
+}
+
+static bool sg_rect_overlaps(const yyrect_t* first, const yyrect_t* second)
+{
+    return first->left <= second->right && first->right >= second->left &&
+        first->top <= second->bottom && first->bottom >= second->top;
+}
+
+// Squared distance from a point to the closest point of a box, 0 inside it
+static float sg_distance_squared(const yyrect_t* box, float x, float y)
+{
+    float dx = fmaxf(fmaxf(box->left - x, x - box->right), 0.0f);
+    float dy = fmaxf(fmaxf(box->top - y, y - box->bottom), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+// Drops every entry, the allocations are kept for the next update
+static void sg_clear(spatial_grid_t* grid)
+{
+    for (uint32_t b = 0; b < grid->bucket_count; b++)
+        grid->buckets[b] = SPATIAL_NO_ENTRY;
+
+    CLEAR_HASHMAP(p_instance_t, int32_t)(&grid->entry_lookup);
+    grid->entry_count = 0;
+    grid->free_entry = SPATIAL_NO_ENTRY;
+    grid->live_count = 0;
+    grid->max_half_width = 0.0f;
+    grid->max_half_height = 0.0f;
+    grid->min_cell_x = INT32_MAX;
+    grid->min_cell_y = INT32_MAX;
+    grid->max_cell_x = INT32_MIN;
+    grid->max_cell_y = INT32_MIN;
+}
+
+int sg_create(float cell_size, spatial_grid_t* grid)
+{
+    memset(grid, 0, sizeof(spatial_grid_t));
+
+    grid->cell_size = cell_size > 0.0f ? cell_size : SPATIAL_DEFAULT_CELL_SIZE;
+    grid->inverse_cell_size = 1.0f / grid->cell_size;
+    grid->free_entry = SPATIAL_NO_ENTRY;
+    return sg_resize_buckets(grid, SPATIAL_MIN_BUCKET_COUNT);
+}
+
+// Brings the grid in line with a snapshot of the room. Entries only move between
+// buckets when their center changes cell, instances missing from the snapshot are dropped.
+// If an allocation fails midway the grid is left empty, the next update fills it again.
+int sg_update(spatial_grid_t* grid, const instance_snapshot_t* snapshot)
+{
+    int last_status = MSL_SUCCESS;
+
+    if (snapshot->count > grid->bucket_count)
+    {
+        uint32_t bucket_count = grid->bucket_count;
+        while (bucket_count < snapshot->count) bucket_count *= 2;
+        CHECK_CALL(sg_resize_buckets, grid, bucket_count);
+    }
+
+    grid->generation++;
+    grid->max_half_width = 0.0f;
+    grid->max_half_height = 0.0f;
+    grid->min_cell_x = INT32_MAX;
+    grid->min_cell_y = INT32_MAX;
+    grid->max_cell_x = INT32_MIN;
+    grid->max_cell_y = INT32_MIN;
+
+    for (size_t i = 0; i < snapshot->count; i++)
+    {
+        yyrect_t box = { snapshot->bbox_left[i], snapshot->bbox_top[i], snapshot->bbox_right[i], snapshot->bbox_bottom[i] };
+        int32_t cell_x = sg_cell_coordinate(grid, (box.left + box.right) * 0.5f);
+        int32_t cell_y = sg_cell_coordinate(grid, (box.top + box.bottom) * 0.5f);
+        uint64_t cell = sg_pack_cell(cell_x, cell_y);
+
+        int32_t index = SPATIAL_NO_ENTRY;
+        if (GET_VALUE(p_instance_t, int32_t)(&grid->entry_lookup, snapshot->instances[i], &index) == MSL_SUCCESS)
+        {
+            if (grid->entries[index].cell != cell)
+            {
+                sg_unlink(grid, index);
+                grid->entries[index].cell = cell;
+                sg_link(grid, index);
+            }
+        }
+        else
+        {
+            CHECK_CALL_GOTO_ERROR(sg_allocate_entry, cleanup, grid, &index);
+            grid->entries[index].instance = snapshot->instances[i];
+            grid->entries[index].cell = cell;
+            sg_link(grid, index);
+            grid->live_count++;
+            CHECK_CALL_GOTO_ERROR(INSERT(p_instance_t, int32_t), cleanup, &grid->entry_lookup, snapshot->instances[i], index);
+        }
+
+        grid->entries[index].bounding_box = box;
+        grid->entries[index].generation = grid->generation;
+
+        grid->max_half_width = fmaxf(grid->max_half_width, (box.right - box.left) * 0.5f);
+        grid->max_half_height = fmaxf(grid->max_half_height, (box.bottom - box.top) * 0.5f);
+        if (cell_x < grid->min_cell_x) grid->min_cell_x = cell_x;
+        if (cell_y < grid->min_cell_y) grid->min_cell_y = cell_y;
+        if (cell_x > grid->max_cell_x) grid->max_cell_x = cell_x;
+        if (cell_y > grid->max_cell_y) grid->max_cell_y = cell_y;
+    }
+
+    // Whatever wasn't in the snapshot got destroyed or deactivated
+    for (int32_t index = 0; index < grid->entry_count; index++)
+    {
+        spatial_entry_t* entry = &grid->entries[index];
+        if (!entry->instance || entry->generation == grid->generation) continue;
+
+        sg_unlink(grid, index);
+        REMOVE(p_instance_t, int32_t)(&grid->entry_lookup, entry->instance);
+        entry->instance = NULL;
+        entry->next = grid->free_entry;
+        grid->free_entry = index;
+        grid->live_count--;
+    }
+
+    return last_status;
+
+    cleanup:
+    // Part of the entries belong to this update and part to the previous one, keep neither
+    sg_clear(grid);
+    return last_status;
+}
+
+// Calls visit on every entry filed in the cells covering the rectangle,
+// the rectangle is widened so boxes centered outside of it are still seen.
+// A range covering more cells than there are buckets walks the buckets instead.
+#define SG_FOR_EACH_ENTRY_IN(grid, rect, index, visit)                                              \
+    do {                                                                                            \
+        int32_t first_x_ = sg_cell_coordinate(grid, (rect).left - (grid)->max_half_width);          \
+        int32_t first_y_ = sg_cell_coordinate(grid, (rect).top - (grid)->max_half_height);          \
+        int32_t last_x_ = sg_cell_coordinate(grid, (rect).right + (grid)->max_half_width);          \
+        int32_t last_y_ = sg_cell_coordinate(grid, (rect).bottom + (grid)->max_half_height);        \
+        if (first_x_ < (grid)->min_cell_x) first_x_ = (grid)->min_cell_x;                           \
+        if (first_y_ < (grid)->min_cell_y) first_y_ = (grid)->min_cell_y;                           \
+        if (last_x_ > (grid)->max_cell_x) last_x_ = (grid)->max_cell_x;                             \
+        if (last_y_ > (grid)->max_cell_y) last_y_ = (grid)->max_cell_y;                             \
+        if (first_x_ > last_x_ || first_y_ > last_y_) break;                                        \
+        uint64_t cell_count_ = (uint64_t)((int64_t)last_x_ - first_x_ + 1) *                        \
+            (uint64_t)((int64_t)last_y_ - first_y_ + 1);                                            \
+        if (cell_count_ > (grid)->bucket_count)                                                     \
+        {                                                                                           \
+            for (uint32_t bucket_ = 0; bucket_ < (grid)->bucket_count; bucket_++)                   \
+            for (int32_t index = (grid)->buckets[bucket_];                                          \
+                index != SPATIAL_NO_ENTRY; index = (grid)->entries[index].next)                     \
+            {                                                                                       \
+                int32_t entry_x_ = sg_cell_x((grid)->entries[index].cell);                          \
+                int32_t entry_y_ = sg_cell_y((grid)->entries[index].cell);                          \
+                if (entry_x_ < first_x_ || entry_x_ > last_x_) continue;                            \
+                if (entry_y_ < first_y_ || entry_y_ > last_y_) continue;                            \
+                visit;                                                                              \
+            }                                                                                       \
+            break;                                                                                  \
+        }                                                                                           \
+        for (int32_t cell_x_ = first_x_; cell_x_ <= last_x_; cell_x_++)                             \
+        for (int32_t cell_y_ = first_y_; cell_y_ <= last_y_; cell_y_++)                             \
+        {                                                                                           \
+            uint64_t cell_ = sg_pack_cell(cell_x_, cell_y_);                                        \
+            for (int32_t index = (grid)->buckets[sg_bucket_of(grid, cell_)];                        \
+                index != SPATIAL_NO_ENTRY; index = (grid)->entries[index].next)                     \
+            {                                                                                       \
+                if ((grid)->entries[index].cell != cell_) continue;                                 \
+                visit;                                                                              \
+            }                                                                                       \
+        }                                                                                           \
+    } while (0)
+
+// Instances whose bounding box overlaps the rectangle. Up to capacity instances
+// are written, MSL_INSUFFICIENT_MEMORY tells the caller some were left out.
+int sg_query_rect(const spatial_grid_t* grid, yyrect_t rect, instance_t** instances, size_t capacity, size_t* count)
+{
+    bool truncated = false;
+    *count = 0;
+
+    SG_FOR_EACH_ENTRY_IN(grid, rect, index,
+        if (!sg_rect_overlaps(&grid->entries[index].bounding_box, &rect)) continue;
+        if (*count == capacity) { truncated = true; continue; }
+        instances[(*count)++] = grid->entries[index].instance;
+    );
+
+    return truncated ? MSL_INSUFFICIENT_MEMORY : MSL_SUCCESS;
+}
+
+// Instances whose bounding box is within radius of the point, same contract as sg_query_rect
+int sg_query_radius(const spatial_grid_t* grid, float x, float y, float radius, instance_t** instances, size_t capacity, size_t* count)
+{
+    bool truncated = false;
+    float radius_squared = radius * radius;
+    yyrect_t rect = { x - radius, y - radius, x + radius, y + radius };
+    *count = 0;
+
+    SG_FOR_EACH_ENTRY_IN(grid, rect, index,
+        if (sg_distance_squared(&grid->entries[index].bounding_box, x, y) > radius_squared) continue;
+        if (*count == capacity) { truncated = true; continue; }
+        instances[(*count)++] = grid->entries[index].instance;
+    );
+
+    return truncated ? MSL_INSUFFICIENT_MEMORY : MSL_SUCCESS;
+}
+
+// The k instances closest to the point, sorted by distance to their bounding box.
+// Cells are visited in rings around the point, until no unvisited ring can hold anything closer.
+int sg_query_nearest(const spatial_grid_t* grid, float x, float y, size_t k, instance_t** instances, float* distances, size_t* count)
+{
+    *count = 0;
+    if (!instances || !distances) return MSL_NULL_BUFFER;
+    if (!k || !grid->live_count) return MSL_SUCCESS;
+
+    int32_t center_x = sg_cell_coordinate(grid, x);
+    int32_t center_y = sg_cell_coordinate(grid, y);
+    float max_half_extent = fmaxf(grid->max_half_width, grid->max_half_height);
+
+    // Rings closer than the occupied cells are empty
+    int32_t ring = 0;
+    if (grid->min_cell_x - center_x > ring) ring = grid->min_cell_x - center_x;
+    if (center_x - grid->max_cell_x > ring) ring = center_x - grid->max_cell_x;
+    if (grid->min_cell_y - center_y > ring) ring = grid->min_cell_y - center_y;
+    if (center_y - grid->max_cell_y > ring) ring = center_y - grid->max_cell_y;
+
+    for (;; ring++)
+    {
+        for (int32_t cell_x = center_x - ring; cell_x <= center_x + ring; cell_x++)
+        {
+            if (cell_x < grid->min_cell_x || cell_x > grid->max_cell_x) continue;
+
+            // Inner columns only have their top and bottom cells on the ring
+            bool edge_column = cell_x == center_x - ring || cell_x == center_x + ring;
+            int32_t step = edge_column || !ring ? 1 : ring * 2;
+
+            for (int32_t cell_y = center_y - ring; cell_y <= center_y + ring; cell_y += step)
+            {
+                if (cell_y < grid->min_cell_y || cell_y > grid->max_cell_y) continue;
+
+                uint64_t cell = sg_pack_cell(cell_x, cell_y);
+                for (int32_t index = grid->buckets[sg_bucket_of(grid, cell)]; index != SPATIAL_NO_ENTRY; index = grid->entries[index].next)
+                {
+                    if (grid->entries[index].cell != cell) continue;
+
+                    float distance = sg_distance_squared(&grid->entries[index].bounding_box, x, y);
+                    if (*count == k && distance >= distances[k - 1]) continue;
+
+                    // Insertion into the sorted results, k is expected to be small
+                    size_t position = *count < k ? (*count)++ : k - 1;
+                    while (position > 0 && distances[position - 1] > distance)
+                    {
+                        distances[position] = distances[position - 1];
+                        instances[position] = instances[position - 1];
+                        position--;
+                    }
+                    distances[position] = distance;
+                    instances[position] = grid->entries[index].instance;
+                }
+            }
+        }
+
+        // Every occupied cell was visited
+        if (center_x - ring <= grid->min_cell_x && center_x + ring >= grid->max_cell_x &&
+            center_y - ring <= grid->min_cell_y && center_y + ring >= grid->max_cell_y)
+            break;
+
+        // Boxes filed in the next rings are at least this far
+        float bound = ring * grid->cell_size - max_half_extent;
+        if (*count == k && bound > 0.0f && distances[k - 1] <= bound * bound)
+            break;
+    }
+
+    for (size_t i = 0; i < *count; i++)
+        distances[i] = sqrtf(distances[i]);
+
+    return MSL_SUCCESS;
+}
+
+int sg_destroy(spatial_grid_t* grid)
+{
+    if (!grid) return MSL_NULL_BUFFER;
+
+    DESTROY_HASHMAP(p_instance_t, int32_t)(&grid->entry_lookup);
+    free(grid->buckets);
+    free(grid->entries);
+    memset(grid, 0, sizeof(spatial_grid_t));
+    return MSL_SUCCESS;
+}
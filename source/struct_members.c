@@ -0,0 +1,71 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include "../include/struct_members.h"
+#include "../include/error.h"
+
+// Upper bound of the members, exact for hashmap backed objects.
+// Use it to size the buffer given to sm_get_members.
+int sm_count_members(const yyobject_base_t* object, size_t* count)
+{
+    *count = 0;
+    if (!object) return MSL_NULL_BUFFER;
+
+    if (object->yyvars_map)
+    {
+        *count = (size_t)object->yyvars_map->used_count;
+        return MSL_SUCCESS;
+    }
+
+    // Array backed objects are indexed by slot, unset slots are skipped when walking
+    if (object->instance_base.yyvars)
+        *count = (size_t)object->capacity;
+
+    return MSL_SUCCESS;
+}
+
+// Walks the variables in storage order, hash order for a hashmap, slot order for an array.
+// Entries point into the object, they are only valid until it gains or loses a variable.
+// When the buffer is too small it is filled up and MSL_INSUFFICIENT_MEMORY is returned.
+int sm_get_members(const yyobject_base_t* object, member_entry_t* members, size_t capacity, size_t* count)
+{
+    *count = 0;
+    if (!object) return MSL_NULL_BUFFER;
+
+    const HASHMAP(int32_t, p_rvalue_t)* yyvars_map = object->yyvars_map;
+    if (yyvars_map)
+    {
+        if (!yyvars_map->elements) return MSL_SUCCESS;
+
+        for (int32_t i = 0; i < yyvars_map->current_size; i++)
+        {
+            const HASHMAP_ELMT(int32_t, p_rvalue_t)* element = &yyvars_map->elements[i];
+            if (element->hash == 0 || !element->value) continue;
+
+            if (*count == capacity) return MSL_INSUFFICIENT_MEMORY;
+
+            members[*count].slot = element->key;
+            members[*count].value = element->value;
+            (*count)++;
+        }
+
+        return MSL_SUCCESS;
+    }
+
+    rvalue_t* yyvars = object->instance_base.yyvars;
+    if (!yyvars) return MSL_SUCCESS;
+
+    for (uint32_t slot = 0; slot < object->capacity; slot++)
+    {
+        if ((yyvars[slot].kind & RVALUE_KIND_MASK) == VALUE_UNSET) continue;
+
+        if (*count == capacity) return MSL_INSUFFICIENT_MEMORY;
+
+        members[*count].slot = (int32_t)slot;
+        members[*count].value = &yyvars[slot];
+        (*count)++;
+    }
+
+    return MSL_SUCCESS;
+}
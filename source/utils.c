@@ -6,168 +6,211 @@
 #include "../include/error.h"
 #include "../include/gml_structs.h"
 
-int iterator_create_alloc(const char* path, const char* pattern, directory_iterator_t** directory_iterator) 
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+FUNC_HASH(str, int32_t)
+
+#ifdef _WIN32
+#define WALKER_SEPARATOR '\\'
+#else
+#define WALKER_SEPARATOR '/'
+#endif
+
+static bool walker_matches_extension(const directory_walker_t* walker, const char* name, size_t name_length)
 {
-    int last_status = MSL_SUCCESS;
-    directory_iterator_t* iter = NULL;
-    if (*directory_iterator) 
-    {
-        last_status = MSL_POINTER_NON_NULL;
-        goto cleanup;
-    }
+    if (!walker->extension) return true;
+    if (name_length < walker->extension_length) return false;
 
-    iter = (directory_iterator_t*)malloc(sizeof(directory_iterator_t));
-    if (!iter) 
+    const char* suffix = name + name_length - walker->extension_length;
+    for (size_t i = 0; i < walker->extension_length; i++)
     {
-        last_status = MSL_ALLOCATION_ERROR;
-        goto cleanup;
+        char first = suffix[i];
+        char second = walker->extension[i];
+        if (first >= 'A' && first <= 'Z') first += 'a' - 'A';
+        if (second >= 'A' && second <= 'Z') second += 'a' - 'A';
+        if (first != second) return false;
     }
-    iter->pattern = NULL;
-    iter->current_path = NULL;
 
-    size_t path_len = strlen(path);
-    iter->current_path = (char*)malloc(MAX_PATH);
-    if (!iter->current_path) 
+    return true;
+}
+
+// Opens the folder whose path is in walker->path, folder_length long with its separator
+static int walker_push_folder(directory_walker_t* walker, size_t folder_length)
+{
+    if (walker->open_count > WALKER_MAX_DEPTH) return MSL_INVALID_PARAMETER;
+
+#ifdef _WIN32
+    // Room for the * pattern
+    if (folder_length + 2 > WALKER_PATH_CAPACITY) return MSL_INVALID_PARAMETER;
+
+    walker->path[folder_length] = '*';
+    walker->path[folder_length + 1] = 0;
+    HANDLE handle = FindFirstFileA(walker->path, &walker->find_data);
+    walker->path[folder_length] = 0;
+    if (handle == INVALID_HANDLE_VALUE) return MSL_EXTERNAL_ERROR;
+
+    walker->has_pending_entry = true;
+#else
+    walker->path[folder_length] = 0;
+    DIR* handle = opendir(walker->path);
+    if (!handle) return MSL_EXTERNAL_ERROR;
+#endif
+
+    walker->handles[walker->open_count] = handle;
+    walker->folder_lengths[walker->open_count] = folder_length;
+    walker->open_count++;
+    return MSL_SUCCESS;
+}
+
+static void walker_pop_folder(directory_walker_t* walker)
+{
+    walker->open_count--;
+#ifdef _WIN32
+    FindClose(walker->handles[walker->open_count]);
+    walker->has_pending_entry = false;
+#else
+    closedir(walker->handles[walker->open_count]);
+#endif
+}
+
+// Reads the next entry of the last open folder, is_file and is_folder are both false
+// for anything else (devices, links, ...) which is never followed.
+static bool walker_read_entry(directory_walker_t* walker, const char** name, bool* is_file, bool* is_folder)
+{
+#ifdef _WIN32
+    if (walker->has_pending_entry)
     {
-        last_status = MSL_ALLOCATION_ERROR;
-        goto cleanup;
+        walker->has_pending_entry = false;
     }
-
-    strcpy(iter->current_path, path);
-    if (path[path_len - 1] != '\\') 
+    else if (!FindNextFileA(walker->handles[walker->open_count - 1], &walker->find_data))
     {
-        strcat(iter->current_path, "\\");
+        return false;
     }
 
-    iter->pattern = strdup(pattern ? pattern : "*");
-    iter->stack = NULL;
+    unsigned long attributes = walker->find_data.dwFileAttributes;
+    *name = walker->find_data.cFileName;
+    *is_folder = (attributes & FILE_ATTRIBUTE_DIRECTORY) && !(attributes & FILE_ATTRIBUTE_REPARSE_POINT);
+    *is_file = !(attributes & FILE_ATTRIBUTE_DIRECTORY) && !(attributes & FILE_ATTRIBUTE_DEVICE);
+    return true;
+#else
+    struct dirent* entry = readdir(walker->handles[walker->open_count - 1]);
+    if (!entry) return false;
 
-    // Create the initial search pattern
-    char search_path[MAX_PATH];
-    strcpy(search_path, iter->current_path);
-    search_path[MAX_PATH-1] = 0;
-    strcat(search_path, iter->pattern);
-    search_path[MAX_PATH-1] = 0;
-    
-    iter->find_handle = FindFirstFile(search_path, &iter->find_data);
-    if (iter->find_handle == INVALID_HANDLE_VALUE)
+    *name = entry->d_name;
+    unsigned char type = entry->d_type;
+
+    // Some file systems don't fill d_type, ask for it then
+    if (type == DT_UNKNOWN)
     {
-        
-        last_status = MSL_EXTERNAL_ERROR;
-        goto cleanup;
-    }
+        size_t folder_length = walker->folder_lengths[walker->open_count - 1];
+        size_t name_length = strlen(entry->d_name);
+        struct stat file_status;
 
-    ret:
-    *directory_iterator = iter;
-    return last_status;
+        if (folder_length + name_length + 1 <= WALKER_PATH_CAPACITY)
+        {
+            memcpy(walker->path + folder_length, entry->d_name, name_length + 1);
+            if (!lstat(walker->path, &file_status))
+            {
+                if (S_ISDIR(file_status.st_mode)) type = DT_DIR;
+                else if (S_ISREG(file_status.st_mode)) type = DT_REG;
+            }
+        }
+    }
 
-    cleanup:
-    if(iter && iter->pattern) free(iter->pattern);
-    if(iter && iter->current_path) free(iter->current_path);
-    if(iter) free(iter);
-    goto ret;
+    *is_folder = type == DT_DIR;
+    *is_file = type == DT_REG;
+    return true;
+#endif
 }
 
-int iterator_next(directory_iterator_t* iter) 
+// extension can be NULL to get every file, max_depth 0 only lists the root folder.
+// Always close the walker, even when walker_next stopped on its own.
+int walker_open(const char* root, const char* extension, uint32_t max_depth, directory_walker_t* walker)
 {
-    while (1) 
+    walker->open_count = 0;
+    walker->path_length = 0;
+    walker->name = walker->path;
+    walker->extension = extension;
+    walker->extension_length = extension ? strlen(extension) : 0;
+    walker->max_depth = max_depth > WALKER_MAX_DEPTH ? WALKER_MAX_DEPTH : max_depth;
+#ifdef _WIN32
+    walker->has_pending_entry = false;
+#endif
+
+    if (!root || !*root) return MSL_INVALID_PARAMETER;
+
+    size_t root_length = strlen(root);
+    if (root_length + 2 > WALKER_PATH_CAPACITY) return MSL_INVALID_PARAMETER;
+
+    memcpy(walker->path, root, root_length);
+    if (root[root_length - 1] != '\\' && root[root_length - 1] != '/')
     {
-        // Try to get next file in current directory
-        if (FindNextFile(iter->find_handle, &iter->find_data)) 
-        {
-            return 1;
-        }
+        walker->path[root_length++] = WALKER_SEPARATOR;
+    }
 
-        // If no more files in current directory
-        FindClose(iter->find_handle);
+    return walker_push_folder(walker, root_length);
+}
+
+// found is false once every file has been seen.
+// Folders that can't be opened or paths that don't fit are skipped.
+int walker_next(directory_walker_t* walker, bool* found)
+{
+    const char* name;
+    bool is_file;
+    bool is_folder;
+    *found = false;
 
-        // If we have directories in stack, pop and continue
-        if (iter->stack) 
+    while (walker->open_count)
+    {
+        if (!walker_read_entry(walker, &name, &is_file, &is_folder))
         {
-            directory_stack_node_t* top = iter->stack;
-            iter->stack = top->next;
-            
-            strcpy(iter->current_path, top->path);
-            iter->find_handle = top->find_handle;
-            
-            free(top->path);
-            free(top);
+            walker_pop_folder(walker);
             continue;
         }
 
-        return 0;  // No more files
-    }
-}
-
-int iterator_enter_directory_alloc(directory_iterator_t* iter) 
-{
-    if (!(iter->find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ||
-        strcmp(iter->find_data.cFileName, ".") == 0 ||
-        strcmp(iter->find_data.cFileName, "..") == 0) {
-        return 0;
-    }
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) continue;
 
-    // Push current state to stack
-    directory_stack_node_t* node = (directory_stack_node_t*)malloc(sizeof(directory_stack_node_t));
-    if (!node) return 0;
+        size_t folder_length = walker->folder_lengths[walker->open_count - 1];
+        size_t name_length = strlen(name);
 
-    node->path = strdup(iter->current_path);
-    node->find_handle = iter->find_handle;
-    node->next = iter->stack;
-    iter->stack = node;
+        if (is_folder)
+        {
+            // The folder being read is at depth open_count - 1
+            if (walker->open_count > walker->max_depth) continue;
+            if (folder_length + name_length + 2 > WALKER_PATH_CAPACITY) continue;
 
-    // Update current path
-    char newPath[MAX_PATH];
-    strcpy(newPath, iter->current_path);
-    newPath[MAX_PATH-1] = 0;
-    strcat(newPath, iter->find_data.cFileName);
-    newPath[MAX_PATH-1] = 0;
-    strcat(newPath, "\\");
-    newPath[MAX_PATH-1] = 0;
+            memcpy(walker->path + folder_length, name, name_length);
+            walker->path[folder_length + name_length] = WALKER_SEPARATOR;
+            walker_push_folder(walker, folder_length + name_length + 1);
+            continue;
+        }
 
-    strcpy(iter->current_path, newPath);
+        if (!is_file || !walker_matches_extension(walker, name, name_length)) continue;
+        if (folder_length + name_length + 1 > WALKER_PATH_CAPACITY) continue;
 
-    // Start new directory search
-    char search_path[MAX_PATH];
-    strcpy(search_path, iter->current_path);
-    search_path[MAX_PATH-1] = 0;
-    strcat(search_path, iter->pattern);
-    search_path[MAX_PATH-1] = 0;
-    
-    iter->find_handle = FindFirstFile(search_path, &iter->find_data);
-    if (iter->find_handle == INVALID_HANDLE_VALUE) 
-    {
-        return iterator_next(iter);  // Skip empty directories
+        memcpy(walker->path + folder_length, name, name_length + 1);
+        walker->path_length = folder_length + name_length;
+        walker->name = walker->path + folder_length;
+        *found = true;
+        return MSL_SUCCESS;
     }
 
-    return 1;
+    return MSL_SUCCESS;
 }
 
-int iterator_destroy(directory_iterator_t* iter) 
+int walker_close(directory_walker_t* walker)
 {
-    int last_status = MSL_SUCCESS;
-    if (!iter) return MSL_POINTER_NON_NULL;
-
-    // Close current find handle
-    if (iter->find_handle != INVALID_HANDLE_VALUE) {
-        FindClose(iter->find_handle);
-    }
+    if (!walker) return MSL_NULL_BUFFER;
 
-    directory_stack_node_t* top = NULL;
-    // Clean up stack
-    while (iter->stack) 
+    while (walker->open_count)
     {
-        top = iter->stack;
-        iter->stack = top->next;
-        FindClose(top->find_handle);
-        free(top->path);
-        free(top);
+        walker_pop_folder(walker);
     }
 
-    free(iter->current_path);
-    free(iter->pattern);
-    free(iter);
-    return last_status;
+    return MSL_SUCCESS;
 }
 
 // Returns 1 if the path has a parent path component
@@ -317,6 +360,7 @@ int parent_path_alloc(const char* path, char** parent)
     goto ret;
 }
 
+#ifdef _WIN32
 int is_regular_file(const char* path, bool* regular_file) 
 {
     if (!path || !*path)
@@ -338,6 +382,7 @@ int is_regular_file(const char* path, bool* regular_file)
     
     return MSL_SUCCESS;
 }
+#endif
 
 int has_filename(const char* path, bool* filename) 
 {
@@ -497,6 +542,7 @@ int extension(const char* path, char** ext_name)
     return last_status;
 }
 
+#ifdef _WIN32
 int compare(const char* path1, const char* path2, int* cmp) 
 {
     if (!path1 || !path2) 
@@ -619,9 +665,49 @@ int paths_are_equivalent(const char* path1, const char* path2, int* equivalent)
     return MSL_SUCCESS;
 }
 
+// Full path, backslashes only and lower case, so two spellings of a path give the same key.
+// Falls back to the path as given when it can't be resolved.
+int canonical_path(const char* path, char* buffer, size_t buffer_size, size_t* length)
+{
+    if (!path || !*path || !buffer_size) return MSL_INVALID_PARAMETER;
+
+    size_t full_length = (size_t)GetFullPathNameA(path, (DWORD)buffer_size, buffer, NULL);
+    if (!full_length || full_length >= buffer_size)
+    {
+        full_length = strlen(path);
+        if (full_length >= buffer_size) return MSL_INVALID_PARAMETER;
+
+        memcpy(buffer, path, full_length + 1);
+    }
+
+    for (size_t i = 0; i < full_length; i++)
+    {
+        if (buffer[i] == '/') buffer[i] = '\\';
+        else if (buffer[i] >= 'A' && buffer[i] <= 'Z') buffer[i] += 'a' - 'A';
+    }
+
+    *length = full_length;
+    return MSL_SUCCESS;
+}
+
+// Opens the file once, hard links and other spellings of the path give the same identity
+int get_file_identity(const char* path, file_identity_t* identity)
+{
+    int last_status = MSL_SUCCESS;
+    BY_HANDLE_FILE_INFORMATION information;
+
+    CHECK_CALL(get_file_info, path, &information);
+
+    identity->volume_serial = information.dwVolumeSerialNumber;
+    identity->file_index = ((uint64_t)information.nFileIndexHigh << 32) | information.nFileIndexLow;
+    return last_status;
+}
+#endif
+
+// Same hash as the runner CHashMap, done unsigned so the multiplication wraps like it does in the runner
 hash_t hash_key_int(int key)
 {
-    return (key * -0x61c8864f + 1) & INT_MAX;
+    return ((uint32_t)(key) * 0x9E3779B1u + 1) & INT_MAX;
 }
 
 hash_t hash_key_yyobject_base_t(yyobject_base_t* key)
@@ -634,7 +720,21 @@ hash_t hash_key_ptr(void* key)
     return (((unsigned long long)((uintptr_t)(key)) >> 8) + 1) & INT_MAX;
 };
 
+hash_t hash_key_file_identity(file_identity_t key)
+{
+    uint64_t mixed = key.file_index ^ ((uint64_t)key.volume_serial * 0x9E3779B97F4A7C15ull);
+    mixed ^= mixed >> 33;
+    mixed *= 0xFF51AFD7ED558CCDull;
+    mixed ^= mixed >> 33;
+    return (hash_t)mixed & INT_MAX;
+}
+
 hash_t hash_key_str(const char* key)
+{
+    return hash_key_str_seed(key, 0);
+}
+
+hash_t hash_key_str_seed(const char* key, uint32_t seed)
 {
     // https://github.com/jwerle/murmurhash.c - Licensed under MIT
     size_t len = strlen(key);
@@ -644,7 +744,7 @@ hash_t hash_key_str(const char* key)
     uint32_t r2 = 13;
     uint32_t m = 5;
     uint32_t n = 0xe6546b64;
-    uint32_t h = 0;
+    uint32_t h = seed;
     uint32_t k = 0;
     uint8_t* d = (uint8_t*)key; // 32 bit extract from 'key'
     const uint32_t* chunks = NULL;
@@ -697,4 +797,229 @@ hash_t hash_key_str(const char* key)
     h ^= (h >> 16);
 
     return h;
+}
+
+// Average number of keys per bucket, a good compromise between
+// the size of the displacement array and the time spent finding seeds.
+#define PERFECT_HASH_KEYS_PER_BUCKET 4
+#define PERFECT_HASH_MAX_SEED 0x100000
+
+typedef struct perfect_hash_bucket_s {
+    uint32_t bucket;
+    uint32_t size;
+} perfect_hash_bucket_t;
+
+static int perfect_hash_bucket_comparator(const void* first, const void* second)
+{
+    const perfect_hash_bucket_t* first_bucket = (const perfect_hash_bucket_t*)first;
+    const perfect_hash_bucket_t* second_bucket = (const perfect_hash_bucket_t*)second;
+
+    // Biggest buckets first, they are the hardest to place
+    if (first_bucket->size != second_bucket->size)
+        return first_bucket->size < second_bucket->size ? 1 : -1;
+
+    // Keep the order deterministic for buckets of the same size
+    return first_bucket->bucket < second_bucket->bucket ? -1 : (first_bucket->bucket > second_bucket->bucket);
+}
+
+// slots must hold key_count entries, slots[i] receives the slot of keys[i].
+// Duplicated keys share the slot of their first occurrence, so slot_count
+// is the number of distinct keys.
+int perfect_hash_build_alloc(const char** keys, uint32_t key_count, perfect_hash_t* perfect_hash, uint32_t* slots)
+{
+    int last_status = MSL_SUCCESS;
+    hash_t* key_hashes = NULL;
+    uint32_t* bucket_starts = NULL;
+    uint32_t* bucket_sizes = NULL;
+    uint32_t* bucket_keys = NULL;
+    uint32_t* duplicate_of = NULL;
+    uint32_t* candidates = NULL;
+    uint8_t* taken = NULL;
+    perfect_hash_bucket_t* order = NULL;
+
+    perfect_hash->displacements = NULL;
+    perfect_hash->bucket_count = 0;
+    perfect_hash->slot_count = 0;
+
+    // Nothing to index, every lookup will miss
+    if (!key_count) return MSL_SUCCESS;
+
+    uint32_t bucket_count = key_count / PERFECT_HASH_KEYS_PER_BUCKET + 1;
+
+    key_hashes = (hash_t*)malloc(sizeof(hash_t) * key_count);
+    bucket_starts = (uint32_t*)calloc(bucket_count + 1, sizeof(uint32_t));
+    bucket_sizes = (uint32_t*)calloc(bucket_count, sizeof(uint32_t));
+    bucket_keys = (uint32_t*)malloc(sizeof(uint32_t) * key_count);
+    duplicate_of = (uint32_t*)malloc(sizeof(uint32_t) * key_count);
+    order = (perfect_hash_bucket_t*)malloc(sizeof(perfect_hash_bucket_t) * bucket_count);
+    perfect_hash->displacements = (uint32_t*)calloc(bucket_count, sizeof(uint32_t));
+    if (!key_hashes || !bucket_starts || !bucket_sizes || !bucket_keys || !duplicate_of || !order || !perfect_hash->displacements)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    // Spread the keys into buckets, a counting sort keeps keys in their original order
+    for (uint32_t i = 0; i < key_count; i++)
+    {
+        key_hashes[i] = hash_key_str(keys[i]);
+        bucket_starts[key_hashes[i] % bucket_count + 1]++;
+        duplicate_of[i] = UINT32_MAX;
+    }
+    for (uint32_t b = 0; b < bucket_count; b++)
+    {
+        bucket_starts[b + 1] += bucket_starts[b];
+    }
+
+    uint32_t unique_count = 0;
+    uint32_t largest_bucket = 0;
+    for (uint32_t i = 0; i < key_count; i++)
+    {
+        uint32_t bucket = key_hashes[i] % bucket_count;
+        uint32_t* keys_in_bucket = &bucket_keys[bucket_starts[bucket]];
+
+        // Identical keys always land in the same bucket, only keep the first one
+        for (uint32_t j = 0; j < bucket_sizes[bucket]; j++)
+        {
+            if (key_hashes[keys_in_bucket[j]] == key_hashes[i] && !strcmp(keys[keys_in_bucket[j]], keys[i]))
+            {
+                duplicate_of[i] = keys_in_bucket[j];
+                break;
+            }
+        }
+        if (duplicate_of[i] != UINT32_MAX) continue;
+
+        keys_in_bucket[bucket_sizes[bucket]++] = i;
+        if (bucket_sizes[bucket] > largest_bucket) largest_bucket = bucket_sizes[bucket];
+        unique_count++;
+    }
+
+    taken = (uint8_t*)calloc(unique_count, sizeof(uint8_t));
+    candidates = (uint32_t*)malloc(sizeof(uint32_t) * largest_bucket);
+    if (!taken || !candidates)
+    {
+        last_status = MSL_ALLOCATION_ERROR;
+        goto cleanup;
+    }
+
+    for (uint32_t b = 0; b < bucket_count; b++)
+    {
+        order[b].bucket = b;
+        order[b].size = bucket_sizes[b];
+    }
+    qsort(order, bucket_count, sizeof(perfect_hash_bucket_t), perfect_hash_bucket_comparator);
+
+    for (uint32_t b = 0; b < bucket_count && order[b].size; b++)
+    {
+        uint32_t bucket = order[b].bucket;
+        uint32_t* keys_in_bucket = &bucket_keys[bucket_starts[bucket]];
+        uint32_t seed = 1;
+
+        // Try seeds until every key of the bucket lands in a free and distinct slot
+        for (; seed < PERFECT_HASH_MAX_SEED; seed++)
+        {
+            uint32_t placed = 0;
+            for (; placed < order[b].size; placed++)
+            {
+                uint32_t slot = hash_key_str_seed(keys[keys_in_bucket[placed]], seed) % unique_count;
+                if (taken[slot]) break;
+
+                uint32_t j = 0;
+                while (j < placed && candidates[j] != slot) j++;
+                if (j < placed) break;
+
+                candidates[placed] = slot;
+            }
+            if (placed == order[b].size) break;
+        }
+
+        if (seed == PERFECT_HASH_MAX_SEED)
+        {
+            last_status = MSL_FAIL;
+            goto cleanup;
+        }
+
+        perfect_hash->displacements[bucket] = seed;
+        for (uint32_t j = 0; j < order[b].size; j++)
+        {
+            taken[candidates[j]] = 1;
+            slots[keys_in_bucket[j]] = candidates[j];
+        }
+    }
+
+    for (uint32_t i = 0; i < key_count; i++)
+    {
+        if (duplicate_of[i] != UINT32_MAX) slots[i] = slots[duplicate_of[i]];
+    }
+
+    perfect_hash->bucket_count = bucket_count;
+    perfect_hash->slot_count = unique_count;
+
+    ret:
+    free(key_hashes);
+    free(bucket_starts);
+    free(bucket_sizes);
+    free(bucket_keys);
+    free(duplicate_of);
+    free(candidates);
+    free(taken);
+    free(order);
+    return last_status;
+
+    cleanup:
+    free(perfect_hash->displacements);
+    perfect_hash->displacements = NULL;
+    goto ret;
+}
+
+int perfect_hash_lookup(const perfect_hash_t* perfect_hash, const char* key, uint32_t* slot)
+{
+    if (!perfect_hash->slot_count) return MSL_OBJECT_NOT_IN_LIST;
+
+    uint32_t seed = perfect_hash->displacements[hash_key_str(key) % perfect_hash->bucket_count];
+
+    // Buckets without any key never got a seed
+    if (!seed) return MSL_OBJECT_NOT_IN_LIST;
+
+    *slot = hash_key_str_seed(key, seed) % perfect_hash->slot_count;
+    return MSL_SUCCESS;
+}
+
+int perfect_hash_destroy(perfect_hash_t* perfect_hash)
+{
+    if (!perfect_hash) return MSL_NULL_BUFFER;
+
+    free(perfect_hash->displacements);
+    perfect_hash->displacements = NULL;
+    perfect_hash->bucket_count = 0;
+    perfect_hash->slot_count = 0;
+    return MSL_SUCCESS;
+}
+
+uint64_t time_now_us(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 + (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#endif
+}
+
+void timer_start(phase_timer_t* timer)
+{
+    if (timer->depth++) return;
+    timer->started_us = time_now_us();
+}
+
+void timer_stop(phase_timer_t* timer)
+{
+    if (!timer->depth || --timer->depth) return;
+    timer->total_us += time_now_us() - timer->started_us;
+    timer->runs++;
 }
\ No newline at end of file
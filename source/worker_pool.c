@@ -0,0 +1,95 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <limits.h>
+#include "../include/worker_pool.h"
+#include "../include/error.h"
+
+static void wp_work(worker_pool_job_t* job)
+{
+    for (;;)
+    {
+#ifdef _WIN32
+        long index = InterlockedIncrement(&job->next) - 1;
+#else
+        long index = job->next++;
+#endif
+        if ((size_t)index >= job->count) return;
+
+        job->task(job->context, (size_t)index);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI wp_worker(LPVOID parameter)
+{
+    wp_work((worker_pool_job_t*)parameter);
+    return 0;
+}
+#endif
+
+// One thread per processor, never more than there are items
+int wp_get_thread_count(size_t count, uint32_t* thread_count)
+{
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    uint32_t threads = system_info.dwNumberOfProcessors ? (uint32_t)system_info.dwNumberOfProcessors : 1;
+#else
+    uint32_t threads = 1;
+#endif
+    if (threads > WORKER_POOL_MAX_THREADS) threads = WORKER_POOL_MAX_THREADS;
+    if (threads > count) threads = count ? (uint32_t)count : 1;
+
+    *thread_count = threads;
+    return MSL_SUCCESS;
+}
+
+// Calls task once for every index in [0, count[ and returns once all of them are done.
+// The calling thread takes part, a max_threads of 0 picks one thread per processor.
+// Threads that can't be created are not an error, the others take their share.
+int wp_run(size_t count, uint32_t max_threads, void(*task)(void*, size_t), void* context)
+{
+    if (!task) return MSL_NULL_BUFFER;
+    if (count == 0) return MSL_SUCCESS;
+    if (count > LONG_MAX) return MSL_INVALID_PARAMETER;
+
+    uint32_t thread_count = 1;
+    wp_get_thread_count(count, &thread_count);
+    if (max_threads && thread_count > max_threads) thread_count = max_threads;
+
+    worker_pool_job_t job;
+    job.task = task;
+    job.context = context;
+    job.count = count;
+    job.next = 0;
+
+#ifdef _WIN32
+    HANDLE threads[WORKER_POOL_MAX_THREADS];
+    DWORD started = 0;
+    for (uint32_t i = 1; i < thread_count; i++)
+    {
+        HANDLE thread = CreateThread(NULL, 0, wp_worker, &job, 0, NULL);
+        if (!thread) break;
+
+        threads[started++] = thread;
+    }
+
+    wp_work(&job);
+
+    if (started)
+    {
+        WaitForMultipleObjects(started, threads, TRUE, INFINITE);
+        for (DWORD i = 0; i < started; i++)
+        {
+            CloseHandle(threads[i]);
+        }
+    }
+#else
+    wp_work(&job);
+#endif
+
+    return MSL_SUCCESS;
+}
@@ -0,0 +1,141 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+// Times the directory walker over a large tree, not run by ctest.
+// Usage: msl_bench [root] [runs]. Without a root, a tree of BENCH_FOLDERS folders
+// holding BENCH_FILES_PER_FOLDER files each is made in the current folder then removed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/utils.h"
+#include "../include/error.h"
+
+#define BENCH_TEMPLATE "bench_walker_XXXXXX"
+#define BENCH_FOLDERS 128
+#define BENCH_FILES_PER_FOLDER 96
+#define BENCH_DEFAULT_RUNS 10
+
+static char bench_root[sizeof(BENCH_TEMPLATE)];
+
+// Folder i is nested below folder i / 4, so the tree is a few levels deep
+static void bench_folder_path(size_t folder, char* path, size_t size)
+{
+    if (!folder)
+    {
+        snprintf(path, size, "%s", bench_root);
+        return;
+    }
+
+    bench_folder_path((folder - 1) / 4, path, size);
+    size_t length = strlen(path);
+    snprintf(path + length, size - length, "/folder_%zu", folder);
+}
+
+static void bench_file_path(size_t folder, size_t file, char* path, size_t size)
+{
+    bench_folder_path(folder, path, size);
+    size_t length = strlen(path);
+    snprintf(path + length, size - length, "/file_%zu.%s", file, file % 3 ? "txt" : "dll");
+}
+
+static int bench_create_tree(void)
+{
+    char path[WALKER_PATH_CAPACITY];
+
+    memcpy(bench_root, BENCH_TEMPLATE, sizeof(BENCH_TEMPLATE));
+    if (!mkdtemp(bench_root)) return MSL_ACCESS_DENIED;
+
+    for (size_t folder = 0; folder < BENCH_FOLDERS; folder++)
+    {
+        bench_folder_path(folder, path, sizeof(path));
+        if (folder && mkdir(path, 0700)) return MSL_ACCESS_DENIED;
+
+        for (size_t file = 0; file < BENCH_FILES_PER_FOLDER; file++)
+        {
+            bench_file_path(folder, file, path, sizeof(path));
+            FILE* handle = fopen(path, "wb");
+            if (!handle) return MSL_ACCESS_DENIED;
+            fclose(handle);
+        }
+    }
+
+    return MSL_SUCCESS;
+}
+
+static void bench_remove_tree(void)
+{
+    char path[WALKER_PATH_CAPACITY];
+
+    for (size_t folder = BENCH_FOLDERS; folder > 0; folder--)
+    {
+        for (size_t file = 0; file < BENCH_FILES_PER_FOLDER; file++)
+        {
+            bench_file_path(folder - 1, file, path, sizeof(path));
+            unlink(path);
+        }
+
+        bench_folder_path(folder - 1, path, sizeof(path));
+        rmdir(path);
+    }
+}
+
+static int bench_walk(const char* root, const char* extension, size_t runs)
+{
+    directory_walker_t* walker = (directory_walker_t*)malloc(sizeof(directory_walker_t));
+    if (!walker) return MSL_ALLOCATION_ERROR;
+
+    phase_timer_t timer = { 0 };
+    size_t count = 0;
+    bool found = false;
+
+    for (size_t run = 0; run < runs; run++)
+    {
+        count = 0;
+        timer_start(&timer);
+        int status = walker_open(root, extension, WALKER_MAX_DEPTH, walker);
+        while (status == MSL_SUCCESS && walker_next(walker, &found) == MSL_SUCCESS && found) count++;
+        walker_close(walker);
+        timer_stop(&timer);
+    }
+
+    double average_us = timer.runs ? (double)timer.total_us / (double)timer.runs : 0.0;
+    printf("%-6s %8zu files %10.0f us/walk %12.0f files/s\n",
+        extension ? extension : "*", count, average_us,
+        average_us > 0.0 ? (double)count * 1e6 / average_us : 0.0);
+
+    free(walker);
+    return MSL_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    int last_status = MSL_SUCCESS;
+    const char* root = argc > 1 ? argv[1] : NULL;
+    long runs = argc > 2 ? strtol(argv[2], NULL, 10) : BENCH_DEFAULT_RUNS;
+    if (runs <= 0) runs = BENCH_DEFAULT_RUNS;
+
+    if (!root)
+    {
+        last_status = bench_create_tree();
+        if (last_status != MSL_SUCCESS)
+        {
+            fprintf(stderr, "can't create the tree in the current folder\n");
+            bench_remove_tree();
+            return 1;
+        }
+        root = bench_root;
+        printf("%d files in %d folders\n", BENCH_FOLDERS * BENCH_FILES_PER_FOLDER, BENCH_FOLDERS);
+    }
+
+    // The first walk warms the file system cache
+    bench_walk(root, NULL, 1);
+    bench_walk(root, NULL, (size_t)runs);
+    bench_walk(root, ".dll", (size_t)runs);
+
+    if (root == bench_root) bench_remove_tree();
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+// Stands in for the Windows headers when the tests are built elsewhere.
+// Only the types interface.h needs to parse, and the few functions the tested sources call.
+
+#ifndef COMPAT_WINDOWS_H_
+#define COMPAT_WINDOWS_H_
+
+#include <stdint.h>
+
+typedef long LONG;
+typedef unsigned long ULONG;
+typedef unsigned long DWORD;
+typedef uintptr_t ULONG_PTR;
+typedef LONG KPRIORITY;
+typedef void* HANDLE;
+typedef void* HMODULE;
+typedef void* HWND;
+
+typedef union
+{
+    struct
+    {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    long long QuadPart;
+} LARGE_INTEGER;
+
+typedef struct
+{
+    HANDLE UniqueProcess;
+    HANDLE UniqueThread;
+} CLIENT_ID;
+
+typedef struct ID3D11Device ID3D11Device;
+typedef struct IDXGISwapChain IDXGISwapChain;
+
+// No module is ever mapped by the tests
+static inline void* GetProcAddress(HMODULE module, const char* name)
+{
+    (void)module;
+    (void)name;
+    return NULL;
+}
+
+static inline LONG InterlockedCompareExchange(volatile LONG* destination, LONG exchange, LONG comparand)
+{
+    return __sync_val_compare_and_swap(destination, comparand, exchange);
+}
+
+#endif  /* !COMPAT_WINDOWS_H_ */
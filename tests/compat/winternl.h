@@ -0,0 +1,12 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+// Stands in for the Windows header when the tests are built elsewhere, see compat/Windows.h
+
+#ifndef COMPAT_WINTERNL_H_
+#define COMPAT_WINTERNL_H_
+
+#include "Windows.h"
+
+#endif  /* !COMPAT_WINTERNL_H_ */
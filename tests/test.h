@@ -0,0 +1,54 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../include/error.h"
+
+typedef struct test_suite_s test_suite_t;
+
+struct test_suite_s
+{
+    const char* name;
+    int(*run)(void);
+};
+
+// Failed checks of the running suite
+extern int test_failures;
+
+// A failed check is reported and the suite keeps going, it fails once it returns
+#define TEST_CHECK(condition)                                                           \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++;                                                            \
+        }                                                                               \
+    } while (0)
+
+#define TEST_CHECK_STATUS(call, status) TEST_CHECK((call) == (status))
+
+// Same sequence on every run, failures can be replayed
+static inline uint32_t test_random(uint64_t* state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(*state >> 33);
+}
+
+int test_builtin_table(void);
+int test_ds_builder(void);
+int test_module_table(void);
+int test_object(void);
+int test_room(void);
+int test_rvalue_array(void);
+int test_rvalue_string(void);
+int test_serializer(void);
+int test_snapshot(void);
+int test_spatial(void);
+int test_walker(void);
+
+#endif  /* !TEST_H_ */
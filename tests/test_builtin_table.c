@@ -0,0 +1,194 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/builtin_table.h"
+
+#define TEST_FUNCTION_COUNT 600
+
+// The inline name of the 80-byte layout, plus a terminator
+#define TEST_NAME_SIZE 65
+
+static void test_routine(rvalue_t* result, instance_t* self, instance_t* other, int argument_count, rvalue_t* arguments)
+{
+    (void)result;
+    (void)self;
+    (void)other;
+    (void)argument_count;
+    (void)arguments;
+}
+
+static void test_other_routine(rvalue_t* result, instance_t* self, instance_t* other, int argument_count, rvalue_t* arguments)
+{
+    test_routine(result, self, other, argument_count, arguments);
+}
+
+static TRoutine test_routine_of(size_t index)
+{
+    return index % 2 ? test_other_routine : test_routine;
+}
+
+// Entry 1 uses all 64 chars of the inline name, the last entry repeats the first name
+static void test_function_name(char name[TEST_NAME_SIZE], size_t index)
+{
+    if (index == 1)
+    {
+        memset(name, 'n', 64);
+        name[64] = '\0';
+    }
+    else
+    {
+        snprintf(name, TEST_NAME_SIZE, "builtin_%zu", index == TEST_FUNCTION_COUNT - 1 ? 0 : index);
+    }
+}
+
+// Builds a table out of the array, then finds every name back
+static void test_check_function_table(rfunction_t* functions, size_t entry_size, char names[][TEST_NAME_SIZE])
+{
+    builtin_function_table_t table = { 0 };
+    size_t count = 0;
+
+    TEST_CHECK_STATUS(bt_count_function_entries(functions, entry_size, &count), MSL_SUCCESS);
+    TEST_CHECK(count == TEST_FUNCTION_COUNT);
+    TEST_CHECK_STATUS(bt_build_function_table_alloc(functions, entry_size, count, &table), MSL_SUCCESS);
+
+    for (size_t i = 0; i < TEST_FUNCTION_COUNT; i++)
+    {
+        int32_t function_id = -1;
+        builtin_function_entry_t* entry = NULL;
+        TEST_CHECK_STATUS(bt_lookup_function(&table, names[i], &function_id), MSL_SUCCESS);
+        TEST_CHECK_STATUS(bt_get_function_entry(&table, function_id, &entry), MSL_SUCCESS);
+        if (!entry) continue;
+
+        // Duplicated names keep the first index
+        size_t expected = i == TEST_FUNCTION_COUNT - 1 ? 0 : i;
+        TEST_CHECK(entry->index == (int32_t)expected);
+        TEST_CHECK(entry->routine == test_routine_of(expected));
+        TEST_CHECK(entry->argument_count == (int32_t)(expected % 7));
+        TEST_CHECK(!strcmp(entry->name, names[i]));
+    }
+
+    int32_t function_id = -1;
+    TEST_CHECK_STATUS(bt_lookup_function(&table, "not_a_builtin", &function_id), MSL_OBJECT_NOT_IN_LIST);
+    TEST_CHECK_STATUS(bt_lookup_function(&table, "builtin_10x", &function_id), MSL_OBJECT_NOT_IN_LIST);
+
+    builtin_function_entry_t* entry = NULL;
+    TEST_CHECK_STATUS(bt_get_function_entry(&table, -1, &entry), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(bt_get_function_entry(&table, (int32_t)table.entry_count, &entry), MSL_INVALID_PARAMETER);
+
+    TEST_CHECK_STATUS(bt_destroy_function_table(&table), MSL_SUCCESS);
+    TEST_CHECK(!table.entries && !table.name_arena && !table.entry_count);
+}
+
+// Runners since 2023.8, 24-byte entries pointing at the name
+static int test_reference_entries(void)
+{
+    static char names[TEST_FUNCTION_COUNT][TEST_NAME_SIZE];
+    rfunction_string_ref_t* functions = (rfunction_string_ref_t*)calloc(TEST_FUNCTION_COUNT + 1, sizeof(rfunction_string_ref_t));
+    if (!functions) return MSL_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < TEST_FUNCTION_COUNT; i++)
+    {
+        test_function_name(names[i], i);
+        functions[i].name = names[i];
+        functions[i].routine = test_routine_of(i);
+        functions[i].argument_count = (int32_t)(i % 7);
+    }
+
+    TEST_CHECK(sizeof(rfunction_string_ref_t) == 24);
+    test_check_function_table((rfunction_t*)functions, sizeof(rfunction_string_ref_t), names);
+
+    free(functions);
+    return MSL_SUCCESS;
+}
+
+// Older runners, 80-byte entries with the name inline
+static int test_full_entries(void)
+{
+    static char names[TEST_FUNCTION_COUNT][TEST_NAME_SIZE];
+    rfunction_string_full_t* functions = (rfunction_string_full_t*)calloc(TEST_FUNCTION_COUNT + 1, sizeof(rfunction_string_full_t));
+    if (!functions) return MSL_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < TEST_FUNCTION_COUNT; i++)
+    {
+        test_function_name(names[i], i);
+        memcpy(functions[i].name, names[i], strnlen(names[i], sizeof(functions[i].name)));
+        functions[i].routine = test_routine_of(i);
+        functions[i].argument_count = (int32_t)(i % 7);
+    }
+
+    TEST_CHECK(sizeof(rfunction_string_full_t) == 80);
+    test_check_function_table((rfunction_t*)functions, sizeof(rfunction_string_full_t), names);
+
+    free(functions);
+    return MSL_SUCCESS;
+}
+
+static int test_function_array_end(void)
+{
+    rfunction_string_ref_t functions[3] = { 0 };
+    size_t count = 0;
+
+    // The array ends on the first entry without a routine, even if it has a name
+    functions[0].name = "first";
+    functions[0].routine = test_routine;
+    functions[1].name = "second";
+    TEST_CHECK_STATUS(bt_count_function_entries((rfunction_t*)functions, sizeof(functions[0]), &count), MSL_SUCCESS);
+    TEST_CHECK(count == 1);
+
+    TEST_CHECK_STATUS(bt_count_function_entries(NULL, sizeof(functions[0]), &count), MSL_NULL_BUFFER);
+    TEST_CHECK_STATUS(bt_count_function_entries((rfunction_t*)functions, 32, &count), MSL_INVALID_PARAMETER);
+    return MSL_SUCCESS;
+}
+
+static int test_variable_table(void)
+{
+    static char names[TEST_FUNCTION_COUNT][TEST_NAME_SIZE];
+    rvariable_routine_t variables[TEST_FUNCTION_COUNT] = { 0 };
+    builtin_variable_table_t table = { 0 };
+
+    for (size_t i = 0; i < TEST_FUNCTION_COUNT; i++)
+    {
+        test_function_name(names[i], i);
+        variables[i].name = names[i];
+    }
+
+    TEST_CHECK_STATUS(bt_build_variable_table_alloc(variables, TEST_FUNCTION_COUNT, &table), MSL_SUCCESS);
+
+    for (size_t i = 0; i < TEST_FUNCTION_COUNT; i++)
+    {
+        int32_t variable_index = -1;
+        rvariable_routine_t* entry = NULL;
+        TEST_CHECK_STATUS(bt_lookup_variable(&table, names[i], &variable_index), MSL_SUCCESS);
+        TEST_CHECK(variable_index == (i == TEST_FUNCTION_COUNT - 1 ? 0 : (int32_t)i));
+        TEST_CHECK_STATUS(bt_get_variable_entry(&table, variable_index, &entry), MSL_SUCCESS);
+        TEST_CHECK(entry == &variables[variable_index]);
+    }
+
+    int32_t variable_index = -1;
+    rvariable_routine_t* entry = NULL;
+    TEST_CHECK_STATUS(bt_lookup_variable(&table, "not_a_builtin", &variable_index), MSL_OBJECT_NOT_IN_LIST);
+    TEST_CHECK_STATUS(bt_get_variable_entry(&table, TEST_FUNCTION_COUNT, &entry), MSL_INVALID_PARAMETER);
+
+    TEST_CHECK_STATUS(bt_destroy_variable_table(&table), MSL_SUCCESS);
+    TEST_CHECK(!table.slot_indices && !table.variable_count);
+
+    // A variable without name can't be hashed
+    variables[3].name = NULL;
+    TEST_CHECK_STATUS(bt_build_variable_table_alloc(variables, TEST_FUNCTION_COUNT, &table), MSL_INVALID_PARAMETER);
+    TEST_CHECK(!table.slot_indices);
+    return MSL_SUCCESS;
+}
+
+int test_builtin_table(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_reference_entries);
+    CHECK_CALL(test_full_entries);
+    CHECK_CALL(test_function_array_end);
+    CHECK_CALL(test_variable_table);
+    return last_status;
+}
@@ -0,0 +1,433 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/ds_builder.h"
+
+#define TEST_LOG_CAPACITY 256
+#define TEST_TEXT_SIZE 32
+#define TEST_MAP_INDEX 3
+#define TEST_LIST_INDEX 5
+#define TEST_REFUSED_KEY "refused"
+
+// Everything the stub runner is asked to add, in order
+typedef struct test_ds_entry_s
+{
+    int32_t container;
+    char key[TEST_TEXT_SIZE];
+    DS_VALUE_TYPE type;
+    double real;
+    int64_t i64;
+    char text[TEST_TEXT_SIZE];
+} test_ds_entry_t;
+
+static test_ds_entry_t ds_log[TEST_LOG_CAPACITY];
+static size_t ds_log_count = 0;
+static size_t ds_list_add_calls = 0;
+static int ds_largest_batch = 0;
+static int ds_live_strings = 0;
+
+static test_ds_entry_t* test_log_entry(int32_t container, const char* key, DS_VALUE_TYPE type)
+{
+    if (ds_log_count == TEST_LOG_CAPACITY) return &ds_log[TEST_LOG_CAPACITY - 1];
+
+    test_ds_entry_t* entry = &ds_log[ds_log_count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->container = container;
+    entry->type = type;
+    if (key) strncpy(entry->key, key, TEST_TEXT_SIZE - 1);
+    return entry;
+}
+
+static void test_log_reset(void)
+{
+    ds_log_count = 0;
+    ds_list_add_calls = 0;
+    ds_largest_batch = 0;
+}
+
+static int test_create_ds_map(int count, ...)
+{
+    (void)count;
+    return TEST_MAP_INDEX;
+}
+
+static int test_ds_list_create(void)
+{
+    return TEST_LIST_INDEX;
+}
+
+static bool test_map_add_double(int map, const char* key, double value)
+{
+    if (!strcmp(key, TEST_REFUSED_KEY)) return false;
+
+    test_log_entry(map, key, DS_VALUE_REAL)->real = value;
+    return true;
+}
+
+static bool test_map_add_string(int map, const char* key, const char* value)
+{
+    strncpy(test_log_entry(map, key, DS_VALUE_STRING)->text, value, TEST_TEXT_SIZE - 1);
+    return true;
+}
+
+static bool test_map_add_int64(int map, const char* key, int64_t value)
+{
+    test_log_entry(map, key, DS_VALUE_INT64)->i64 = value;
+    return true;
+}
+
+static void test_map_add_bool(int map, const char* key, bool value)
+{
+    test_log_entry(map, key, DS_VALUE_BOOL)->real = value ? 1.0 : 0.0;
+}
+
+static void test_map_add_list(int map, const char* key, int list)
+{
+    test_log_entry(map, key, DS_VALUE_LIST)->i64 = list;
+}
+
+static void test_map_add_rvalue(int map, const char* key, rvalue_t* value)
+{
+    test_log_entry(map, key, DS_VALUE_RVALUE)->real = value->real;
+}
+
+static void test_list_add_int64(int list, int64_t value)
+{
+    test_log_entry(list, NULL, DS_VALUE_INT64)->i64 = value;
+}
+
+static void test_list_add_map(int list, int map)
+{
+    test_log_entry(list, NULL, DS_VALUE_MAP)->i64 = map;
+}
+
+static void test_create_string(rvalue_t* value, const char* text)
+{
+    ref_string_t* string = (ref_string_t*)calloc(1, sizeof(ref_string_t));
+    size_t length = strlen(text);
+    char* copy = (char*)malloc(length + 1);
+    memcpy(copy, text, length + 1);
+
+    string->thing = copy;
+    string->ref_count = 1;
+    string->size = (int32_t)length;
+    ds_live_strings++;
+
+    value->pointer = string;
+    value->flags = 0;
+    value->kind = VALUE_STRING;
+}
+
+static void test_free_rvalue(rvalue_t* value)
+{
+    if ((value->kind & RVALUE_KIND_MASK) == VALUE_STRING)
+    {
+        ref_string_t* string = (ref_string_t*)value->pointer;
+        if (!--string->ref_count)
+        {
+            free((char*)string->thing);
+            free(string);
+            ds_live_strings--;
+        }
+    }
+
+    value->real = 0.0;
+    value->kind = VALUE_UNDEFINED;
+}
+
+// Stands for the ds_list_add builtin, the list then the values
+static void test_list_add(rvalue_t* result, instance_t* self, instance_t* other, int argument_count, rvalue_t* arguments)
+{
+    (void)result;
+    (void)self;
+    (void)other;
+
+    ds_list_add_calls++;
+    if (argument_count > ds_largest_batch) ds_largest_batch = argument_count;
+
+    int32_t list = (int32_t)arguments[0].real;
+    for (int i = 1; i < argument_count; i++)
+    {
+        switch (arguments[i].kind & RVALUE_KIND_MASK)
+        {
+        case VALUE_STRING:
+        {
+            const ref_string_t* string = (const ref_string_t*)arguments[i].pointer;
+            strncpy(test_log_entry(list, NULL, DS_VALUE_STRING)->text, string->thing, TEST_TEXT_SIZE - 1);
+            break;
+        }
+        case VALUE_BOOL:
+            test_log_entry(list, NULL, DS_VALUE_BOOL)->real = arguments[i].real;
+            break;
+        case VALUE_REAL:
+            test_log_entry(list, NULL, DS_VALUE_REAL)->real = arguments[i].real;
+            break;
+        default:
+            test_log_entry(list, NULL, DS_VALUE_RVALUE)->real = arguments[i].real;
+            break;
+        }
+    }
+}
+
+static yyrunner_interface_t test_runner(void)
+{
+    yyrunner_interface_t runner;
+    memset(&runner, 0, sizeof(runner));
+    runner.CreateDsMap = test_create_ds_map;
+    runner.DsListCreate = test_ds_list_create;
+    runner.DsMapAddDouble = test_map_add_double;
+    runner.DsMapAddString = test_map_add_string;
+    runner.DsMapAddInt64 = test_map_add_int64;
+    runner.DsMapAddBool = test_map_add_bool;
+    runner.DsMapAddList = test_map_add_list;
+    runner.DsMapAddrvalue_t = test_map_add_rvalue;
+    runner.DsListAddInt64 = test_list_add_int64;
+    runner.DsListAddMap = test_list_add_map;
+    runner.YYCreateString = test_create_string;
+    runner.FREE_rvalue_t = test_free_rvalue;
+    return runner;
+}
+
+static ds_value_t test_value(DS_VALUE_TYPE type)
+{
+    ds_value_t value;
+    memset(&value, 0, sizeof(value));
+    value.type = type;
+    return value;
+}
+
+static bool test_logged(size_t index, int32_t container, const char* key, DS_VALUE_TYPE type)
+{
+    if (index >= ds_log_count) return false;
+
+    const test_ds_entry_t* entry = &ds_log[index];
+    return entry->container == container && entry->type == type && !strcmp(entry->key, key ? key : "");
+}
+
+static int test_create(void)
+{
+    yyrunner_interface_t runner = test_runner();
+    int32_t index = -1;
+
+    TEST_CHECK_STATUS(db_create_map(&runner, &index), MSL_SUCCESS);
+    TEST_CHECK(index == TEST_MAP_INDEX);
+    TEST_CHECK_STATUS(db_create_list(&runner, &index), MSL_SUCCESS);
+    TEST_CHECK(index == TEST_LIST_INDEX);
+
+    // Runners too old to export them
+    runner.CreateDsMap = NULL;
+    runner.DsListCreate = NULL;
+    TEST_CHECK_STATUS(db_create_map(&runner, &index), MSL_EXTERNAL_ERROR);
+    TEST_CHECK_STATUS(db_create_list(&runner, &index), MSL_EXTERNAL_ERROR);
+    return MSL_SUCCESS;
+}
+
+static int test_map_bulk(void)
+{
+    yyrunner_interface_t runner = test_runner();
+    const char* keys[3] = { "x", "y", "z" };
+    const double reals[3] = { 1.5, -2.0, 8.0 };
+    const char* strings[3] = { "one", "two", "three" };
+
+    test_log_reset();
+    TEST_CHECK_STATUS(db_map_add_reals(&runner, TEST_MAP_INDEX, keys, reals, 3), MSL_SUCCESS);
+    TEST_CHECK_STATUS(db_map_add_strings(&runner, TEST_MAP_INDEX, keys, strings, 3), MSL_SUCCESS);
+    TEST_CHECK(ds_log_count == 6);
+    for (size_t i = 0; i < 3; i++)
+    {
+        TEST_CHECK(test_logged(i, TEST_MAP_INDEX, keys[i], DS_VALUE_REAL) && ds_log[i].real == reals[i]);
+        TEST_CHECK(test_logged(i + 3, TEST_MAP_INDEX, keys[i], DS_VALUE_STRING) && !strcmp(ds_log[i + 3].text, strings[i]));
+    }
+
+    // Stops on the refused key, the ones before it stay
+    const char* refused_keys[3] = { "a", TEST_REFUSED_KEY, "c" };
+    test_log_reset();
+    TEST_CHECK_STATUS(db_map_add_reals(&runner, TEST_MAP_INDEX, refused_keys, reals, 3), MSL_EXTERNAL_ERROR);
+    TEST_CHECK(ds_log_count == 1 && test_logged(0, TEST_MAP_INDEX, "a", DS_VALUE_REAL));
+
+    runner.DsMapAddString = NULL;
+    TEST_CHECK_STATUS(db_map_add_strings(&runner, TEST_MAP_INDEX, keys, strings, 3), MSL_EXTERNAL_ERROR);
+    return MSL_SUCCESS;
+}
+
+static int test_map_values(void)
+{
+    yyrunner_interface_t runner = test_runner();
+    rvalue_t borrowed = { 0 };
+    borrowed.real = 42.0;
+    borrowed.kind = VALUE_REAL;
+
+    const char* keys[6] = { "real", "i64", "flag", "name", "items", "raw" };
+    ds_value_t values[6];
+    values[0] = test_value(DS_VALUE_REAL);
+    values[0].real = 0.25;
+    values[1] = test_value(DS_VALUE_INT64);
+    values[1].i64 = INT64_MIN + 1;
+    values[2] = test_value(DS_VALUE_BOOL);
+    values[2].boolean = true;
+    values[3] = test_value(DS_VALUE_STRING);
+    values[3].string = "hero";
+    values[4] = test_value(DS_VALUE_LIST);
+    values[4].index = TEST_LIST_INDEX;
+    values[5] = test_value(DS_VALUE_RVALUE);
+    values[5].rvalue = &borrowed;
+
+    test_log_reset();
+    TEST_CHECK_STATUS(db_map_add_values(&runner, TEST_MAP_INDEX, keys, values, 6), MSL_SUCCESS);
+    TEST_CHECK(ds_log_count == 6);
+    TEST_CHECK(test_logged(0, TEST_MAP_INDEX, "real", DS_VALUE_REAL) && ds_log[0].real == 0.25);
+    TEST_CHECK(test_logged(1, TEST_MAP_INDEX, "i64", DS_VALUE_INT64) && ds_log[1].i64 == INT64_MIN + 1);
+    TEST_CHECK(test_logged(2, TEST_MAP_INDEX, "flag", DS_VALUE_BOOL) && ds_log[2].real == 1.0);
+    TEST_CHECK(test_logged(3, TEST_MAP_INDEX, "name", DS_VALUE_STRING) && !strcmp(ds_log[3].text, "hero"));
+    TEST_CHECK(test_logged(4, TEST_MAP_INDEX, "items", DS_VALUE_LIST) && ds_log[4].i64 == TEST_LIST_INDEX);
+    TEST_CHECK(test_logged(5, TEST_MAP_INDEX, "raw", DS_VALUE_RVALUE) && ds_log[5].real == 42.0);
+
+    // A map inside a map can't be marked through the runner
+    values[1] = test_value(DS_VALUE_MAP);
+    test_log_reset();
+    TEST_CHECK_STATUS(db_map_add_values(&runner, TEST_MAP_INDEX, keys, values, 6), MSL_INVALID_PARAMETER);
+    TEST_CHECK(ds_log_count == 1);
+
+    runner.DsMapAddInt64 = NULL;
+    values[1] = test_value(DS_VALUE_INT64);
+    TEST_CHECK_STATUS(db_map_add_values(&runner, TEST_MAP_INDEX, keys, values, 6), MSL_EXTERNAL_ERROR);
+    return MSL_SUCCESS;
+}
+
+// Enough values for several ds_list_add batches, split by the ones the runner adds itself
+static int test_list_values(void)
+{
+    yyrunner_interface_t runner = test_runner();
+    builtin_handle_t list_add = { test_list_add, 0, -1 };
+    uint64_t random_state = 7;
+
+    enum { TEST_LIST_VALUES = BUILTIN_ARGUMENTS_CAPACITY * 3 + 1 };
+    ds_value_t values[TEST_LIST_VALUES];
+    char texts[TEST_LIST_VALUES][TEST_TEXT_SIZE];
+
+    for (size_t i = 0; i < TEST_LIST_VALUES; i++)
+    {
+        switch (test_random(&random_state) % 5)
+        {
+        case 0:
+            values[i] = test_value(DS_VALUE_REAL);
+            values[i].real = (double)i;
+            break;
+        case 1:
+            values[i] = test_value(DS_VALUE_BOOL);
+            values[i].boolean = i % 2;
+            break;
+        case 2:
+            snprintf(texts[i], TEST_TEXT_SIZE, "value %zu", i);
+            values[i] = test_value(DS_VALUE_STRING);
+            values[i].string = texts[i];
+            break;
+        case 3:
+            values[i] = test_value(DS_VALUE_INT64);
+            values[i].i64 = (int64_t)i;
+            break;
+        default:
+            values[i] = test_value(DS_VALUE_MAP);
+            values[i].index = (int32_t)i;
+            break;
+        }
+    }
+
+    test_log_reset();
+    TEST_CHECK_STATUS(db_list_add_values(&runner, &list_add, TEST_LIST_INDEX, values, TEST_LIST_VALUES), MSL_SUCCESS);
+    TEST_CHECK(ds_log_count == TEST_LIST_VALUES);
+    TEST_CHECK(ds_largest_batch <= BUILTIN_ARGUMENTS_CAPACITY);
+    TEST_CHECK(ds_live_strings == 0);
+
+    // Same order as given
+    for (size_t i = 0; i < TEST_LIST_VALUES && i < ds_log_count; i++)
+    {
+        const test_ds_entry_t* entry = &ds_log[i];
+        TEST_CHECK(entry->container == TEST_LIST_INDEX && entry->type == values[i].type);
+
+        switch (values[i].type)
+        {
+        case DS_VALUE_REAL:
+            TEST_CHECK(entry->real == values[i].real);
+            break;
+        case DS_VALUE_BOOL:
+            TEST_CHECK(entry->real == (values[i].boolean ? 1.0 : 0.0));
+            break;
+        case DS_VALUE_STRING:
+            TEST_CHECK(!strcmp(entry->text, values[i].string));
+            break;
+        case DS_VALUE_INT64:
+            TEST_CHECK(entry->i64 == values[i].i64);
+            break;
+        default:
+            TEST_CHECK(entry->i64 == values[i].index);
+            break;
+        }
+    }
+
+    // A long run of reals fills whole batches
+    ds_value_t reals[BUILTIN_ARGUMENTS_CAPACITY * 2];
+    for (size_t i = 0; i < BUILTIN_ARGUMENTS_CAPACITY * 2; i++)
+    {
+        reals[i] = test_value(DS_VALUE_REAL);
+        reals[i].real = (double)i;
+    }
+    test_log_reset();
+    TEST_CHECK_STATUS(db_list_add_values(&runner, &list_add, TEST_LIST_INDEX, reals, BUILTIN_ARGUMENTS_CAPACITY * 2), MSL_SUCCESS);
+    TEST_CHECK(ds_log_count == BUILTIN_ARGUMENTS_CAPACITY * 2);
+    TEST_CHECK(ds_largest_batch == BUILTIN_ARGUMENTS_CAPACITY);
+    TEST_CHECK(ds_list_add_calls == 3);
+    return MSL_SUCCESS;
+}
+
+static int test_list_failures(void)
+{
+    yyrunner_interface_t runner = test_runner();
+    builtin_handle_t list_add = { test_list_add, 0, -1 };
+
+    ds_value_t values[3];
+    values[0] = test_value(DS_VALUE_STRING);
+    values[0].string = "kept";
+    values[1] = test_value(DS_VALUE_LIST);
+    values[1].index = 1;
+    values[2] = test_value(DS_VALUE_REAL);
+
+    // What came before the refused value is still added, and its strings released
+    test_log_reset();
+    TEST_CHECK_STATUS(db_list_add_values(&runner, &list_add, TEST_LIST_INDEX, values, 3), MSL_INVALID_PARAMETER);
+    TEST_CHECK(ds_log_count == 1 && !strcmp(ds_log[0].text, "kept"));
+    TEST_CHECK(ds_live_strings == 0);
+
+    // Without ds_list_add only the values the runner adds itself work
+    ds_value_t native[2];
+    native[0] = test_value(DS_VALUE_INT64);
+    native[0].i64 = 9;
+    native[1] = test_value(DS_VALUE_MAP);
+    native[1].index = TEST_MAP_INDEX;
+    test_log_reset();
+    TEST_CHECK_STATUS(db_list_add_values(&runner, NULL, TEST_LIST_INDEX, native, 2), MSL_SUCCESS);
+    TEST_CHECK(ds_log_count == 2 && ds_list_add_calls == 0);
+    TEST_CHECK_STATUS(db_list_add_values(&runner, NULL, TEST_LIST_INDEX, &values[2], 1), MSL_INVALID_PARAMETER);
+
+    runner.DsListAddMap = NULL;
+    TEST_CHECK_STATUS(db_list_add_values(&runner, &list_add, TEST_LIST_INDEX, native, 2), MSL_EXTERNAL_ERROR);
+
+    runner.YYCreateString = NULL;
+    TEST_CHECK_STATUS(db_list_add_values(&runner, &list_add, TEST_LIST_INDEX, values, 1), MSL_EXTERNAL_ERROR);
+    return MSL_SUCCESS;
+}
+
+int test_ds_builder(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_create);
+    CHECK_CALL(test_map_bulk);
+    CHECK_CALL(test_map_values);
+    CHECK_CALL(test_list_values);
+    CHECK_CALL(test_list_failures);
+    return last_status;
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <string.h>
+#include "test.h"
+
+int test_failures = 0;
+
+static const test_suite_t test_suites[] = {
+    { "builtin_table", test_builtin_table },
+    { "ds_builder", test_ds_builder },
+    { "module_table", test_module_table },
+    { "object", test_object },
+    { "room", test_room },
+    { "rvalue_array", test_rvalue_array },
+    { "rvalue_string", test_rvalue_string },
+    { "serializer", test_serializer },
+    { "snapshot", test_snapshot },
+    { "spatial", test_spatial },
+    { "walker", test_walker },
+};
+
+// Runs the suite given as argument, or all of them
+int main(int argc, char** argv)
+{
+    const char* selected = argc > 1 ? argv[1] : NULL;
+    int failed_suites = 0;
+    int run_suites = 0;
+
+    for (size_t i = 0; i < sizeof(test_suites) / sizeof(test_suites[0]); i++)
+    {
+        if (selected && strcmp(selected, test_suites[i].name)) continue;
+
+        test_failures = 0;
+        int status = test_suites[i].run();
+        bool passed = status == MSL_SUCCESS && !test_failures;
+
+        printf("%s: %s\n", test_suites[i].name, passed ? "passed" : "FAILED");
+        if (!passed) failed_suites++;
+        run_suites++;
+    }
+
+    if (!run_suites)
+    {
+        fprintf(stderr, "unknown suite %s\n", selected);
+        return 1;
+    }
+
+    return failed_suites ? 1 : 0;
+}
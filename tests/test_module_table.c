@@ -0,0 +1,191 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/module_table.h"
+
+#define TEST_MODULE_COUNT 4096
+
+// Every live module is where dense_positions says, and every slot agrees with its module
+static void test_check_dense_positions(const module_table_t* table)
+{
+    for (size_t i = 0; i < table->count; i++)
+    {
+        uint32_t slot = MODULE_HANDLE_SLOT(table->modules[i]->handle);
+        TEST_CHECK(slot < table->slot_count);
+        TEST_CHECK(table->dense_positions[slot] == i);
+    }
+
+    size_t live = 0;
+    for (size_t slot = 0; slot < table->slot_count; slot++)
+    {
+        if (table->dense_positions[slot] != MODULE_TABLE_FREE_SLOT) live++;
+    }
+    TEST_CHECK(live == table->count);
+    TEST_CHECK(live + table->free_count == table->slot_count);
+}
+
+static int test_insert_resolve(void)
+{
+    module_table_t table = { 0 };
+    module_t** stored = (module_t**)malloc(TEST_MODULE_COUNT * sizeof(module_t*));
+    module_handle_t* handles = (module_handle_t*)malloc(TEST_MODULE_COUNT * sizeof(module_handle_t));
+    if (!stored || !handles)
+    {
+        free(stored);
+        free(handles);
+        return MSL_ALLOCATION_ERROR;
+    }
+
+    for (uint32_t i = 0; i < TEST_MODULE_COUNT; i++)
+    {
+        module_t module = { 0 };
+        module.image_size = i;
+        TEST_CHECK_STATUS(mt_insert(&table, &module, &stored[i]), MSL_SUCCESS);
+        handles[i] = stored[i]->handle;
+        TEST_CHECK(handles[i] != MODULE_HANDLE_NULL);
+    }
+
+    TEST_CHECK(table.count == TEST_MODULE_COUNT);
+    TEST_CHECK(table.chunk_count == TEST_MODULE_COUNT / MODULE_TABLE_CHUNK_SIZE);
+
+    // The first modules didn't move while later chunks were added
+    for (uint32_t i = 0; i < TEST_MODULE_COUNT; i++)
+    {
+        module_t* module = NULL;
+        TEST_CHECK_STATUS(mt_resolve(&table, handles[i], &module), MSL_SUCCESS);
+        TEST_CHECK(module == stored[i]);
+        TEST_CHECK(module->image_size == i);
+    }
+
+    test_check_dense_positions(&table);
+    TEST_CHECK_STATUS(mt_destroy(&table), MSL_SUCCESS);
+    TEST_CHECK(!table.chunks && !table.count && !table.slot_count);
+
+    free(stored);
+    free(handles);
+    return MSL_SUCCESS;
+}
+
+static int test_stale_handles(void)
+{
+    module_table_t table = { 0 };
+    module_t module = { 0 };
+    module_t* first = NULL;
+    module_t* second = NULL;
+    module_t* resolved = NULL;
+
+    TEST_CHECK_STATUS(mt_insert(&table, &module, &first), MSL_SUCCESS);
+    module_handle_t stale = first->handle;
+    uint32_t slot = MODULE_HANDLE_SLOT(stale);
+
+    TEST_CHECK_STATUS(mt_remove(&table, stale), MSL_SUCCESS);
+    TEST_CHECK_STATUS(mt_resolve(&table, stale, &resolved), MSL_OBJECT_NOT_FOUND);
+    TEST_CHECK_STATUS(mt_get_slot(&table, slot, &resolved), MSL_OBJECT_NOT_FOUND);
+    TEST_CHECK_STATUS(mt_remove(&table, stale), MSL_OBJECT_NOT_FOUND);
+
+    // The freed slot is reused first, under a new generation
+    TEST_CHECK_STATUS(mt_insert(&table, &module, &second), MSL_SUCCESS);
+    TEST_CHECK(second == first);
+    TEST_CHECK(MODULE_HANDLE_SLOT(second->handle) == slot);
+    TEST_CHECK(MODULE_HANDLE_GENERATION(second->handle) == MODULE_HANDLE_GENERATION(stale) + 1);
+    TEST_CHECK_STATUS(mt_resolve(&table, stale, &resolved), MSL_OBJECT_NOT_FOUND);
+    TEST_CHECK_STATUS(mt_resolve(&table, second->handle, &resolved), MSL_SUCCESS);
+    TEST_CHECK_STATUS(mt_get_slot(&table, slot, &resolved), MSL_SUCCESS);
+
+    // Neither a slot past the table nor the null handle resolve
+    TEST_CHECK_STATUS(mt_resolve(&table, MODULE_HANDLE(MODULE_TABLE_CHUNK_SIZE, 1), &resolved), MSL_OBJECT_NOT_FOUND);
+    TEST_CHECK_STATUS(mt_resolve(&table, MODULE_HANDLE_NULL, &resolved), MSL_OBJECT_NOT_FOUND);
+
+    // A generation wrapping around skips 0
+    table.generations[slot] = UINT32_MAX;
+    second->handle = MODULE_HANDLE(slot, UINT32_MAX);
+    TEST_CHECK_STATUS(mt_remove(&table, second->handle), MSL_SUCCESS);
+    TEST_CHECK(table.generations[slot] == 1);
+
+    TEST_CHECK_STATUS(mt_destroy(&table), MSL_SUCCESS);
+    return MSL_SUCCESS;
+}
+
+// Loads and unloads modules at random, checking the table against a plain list of what should be live
+static int test_churn(void)
+{
+    module_table_t table = { 0 };
+    module_t** live_modules = (module_t**)malloc(TEST_MODULE_COUNT * sizeof(module_t*));
+    module_handle_t* live_handles = (module_handle_t*)malloc(TEST_MODULE_COUNT * sizeof(module_handle_t));
+    module_handle_t* dead_handles = (module_handle_t*)malloc(8 * TEST_MODULE_COUNT * sizeof(module_handle_t));
+    if (!live_modules || !live_handles || !dead_handles)
+    {
+        free(live_modules);
+        free(live_handles);
+        free(dead_handles);
+        return MSL_ALLOCATION_ERROR;
+    }
+
+    size_t live_count = 0;
+    size_t dead_count = 0;
+    uint64_t state = 0x4d534c;
+
+    for (int step = 0; step < 8 * TEST_MODULE_COUNT; step++)
+    {
+        bool insert = live_count < TEST_MODULE_COUNT && (!live_count || test_random(&state) % 3);
+        if (insert)
+        {
+            module_t module = { 0 };
+            module.image_size = (uint32_t)step;
+            module_t* stored = NULL;
+            TEST_CHECK_STATUS(mt_insert(&table, &module, &stored), MSL_SUCCESS);
+            live_modules[live_count] = stored;
+            live_handles[live_count++] = stored->handle;
+        }
+        else
+        {
+            size_t victim = test_random(&state) % live_count;
+            TEST_CHECK_STATUS(mt_remove(&table, live_handles[victim]), MSL_SUCCESS);
+            dead_handles[dead_count++] = live_handles[victim];
+            live_count--;
+            live_modules[victim] = live_modules[live_count];
+            live_handles[victim] = live_handles[live_count];
+        }
+
+        if (step % 1024) continue;
+
+        TEST_CHECK(table.count == live_count);
+        test_check_dense_positions(&table);
+    }
+
+    // Live modules are still at the address they were given, dead handles all fail
+    for (size_t i = 0; i < live_count; i++)
+    {
+        module_t* module = NULL;
+        TEST_CHECK_STATUS(mt_resolve(&table, live_handles[i], &module), MSL_SUCCESS);
+        TEST_CHECK(module == live_modules[i]);
+        TEST_CHECK(module->handle == live_handles[i]);
+    }
+
+    for (size_t i = 0; i < dead_count; i++)
+    {
+        module_t* module = NULL;
+        TEST_CHECK_STATUS(mt_resolve(&table, dead_handles[i], &module), MSL_OBJECT_NOT_FOUND);
+    }
+
+    test_check_dense_positions(&table);
+    TEST_CHECK_STATUS(mt_destroy(&table), MSL_SUCCESS);
+
+    free(live_modules);
+    free(live_handles);
+    free(dead_handles);
+    return MSL_SUCCESS;
+}
+
+int test_module_table(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_insert_resolve);
+    CHECK_CALL(test_stale_handles);
+    CHECK_CALL(test_churn);
+    return last_status;
+}
@@ -0,0 +1,468 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/object.h"
+#include "../include/module.h"
+
+#define TEST_MODULES 4
+#define TEST_INTERFACES 200
+#define TEST_NAME_SIZE 32
+#define TEST_LAZY_CREATIONS 4
+#define TEST_OBSERVERS 6
+#define TEST_NOTIFICATIONS 64
+
+// What module.c and interface.c provide to object.c, only as far as the registry needs them
+FUNC_VEC(interface_table_entry_t)
+
+module_table_t global_module_table;
+startup_timings_t global_startup_timings;
+
+// The interfaces a lazy module creates once activated
+typedef struct test_lazy_creation_s
+{
+    module_t* module;
+    interface_base_t* intf;
+    const char* name;
+} test_lazy_creation_t;
+
+static test_lazy_creation_t lazy_creations[TEST_LAZY_CREATIONS];
+static size_t lazy_creation_count = 0;
+static int activation_count = 0;
+static int create_count = 0;
+static int destroy_count = 0;
+
+int md_activate_module(module_t* module)
+{
+    int last_status = MSL_SUCCESS;
+    activation_count++;
+    module->flags.is_lazy = false;
+
+    for (size_t i = 0; i < lazy_creation_count; i++)
+    {
+        if (lazy_creations[i].module != module) continue;
+
+        CHECK_CALL(ob_create_interface, module, lazy_creations[i].intf, lazy_creations[i].name);
+    }
+
+    CHECK_CALL(obp_release_reserved_interfaces, module);
+    return last_status;
+}
+
+int mdp_get_module_base_address(module_t* module, void** module_base)
+{
+    *module_base = module->image_base.pointer;
+    return MSL_SUCCESS;
+}
+
+// What the operation callbacks were called with, in order
+typedef struct test_notification_s
+{
+    module_t* observer;
+    module_t* affected_module;
+    MODULE_OPERATION_TYPE type;
+    bool is_future_call;
+} test_notification_t;
+
+static module_t observers[TEST_OBSERVERS];
+static test_notification_t notifications[TEST_NOTIFICATIONS];
+static size_t notification_count = 0;
+static int failing_observer = -1;
+
+static int test_observe(size_t index, module_t* affected_module, MODULE_OPERATION_TYPE type, operation_info_t* information)
+{
+    if (notification_count < TEST_NOTIFICATIONS)
+    {
+        test_notification_t* notification = &notifications[notification_count++];
+        notification->observer = &observers[index];
+        notification->affected_module = affected_module;
+        notification->type = type;
+        notification->is_future_call = information->is_future_call;
+    }
+
+    return (int)index == failing_observer ? MSL_EXTERNAL_ERROR : MSL_SUCCESS;
+}
+
+#define TEST_OBSERVER(I) \
+static int test_observer_##I(module_t* affected_module, MODULE_OPERATION_TYPE type, operation_info_t* information) \
+{ \
+    return test_observe(I, affected_module, type, information); \
+}
+
+TEST_OBSERVER(0)
+TEST_OBSERVER(1)
+TEST_OBSERVER(2)
+TEST_OBSERVER(3)
+TEST_OBSERVER(4)
+TEST_OBSERVER(5)
+
+static const ModuleCallback observer_callbacks[TEST_OBSERVERS] = {
+    test_observer_0, test_observer_1, test_observer_2, test_observer_3, test_observer_4, test_observer_5,
+};
+
+static int test_create_interface(void)
+{
+    create_count++;
+    return MSL_SUCCESS;
+}
+
+static int test_destroy_interface(void)
+{
+    destroy_count++;
+    return MSL_SUCCESS;
+}
+
+static interface_base_t test_interface_base(void)
+{
+    interface_base_t interface_base;
+    memset(&interface_base, 0, sizeof(interface_base));
+    interface_base.create = test_create_interface;
+    interface_base.destroy = test_destroy_interface;
+    return interface_base;
+}
+
+static void test_release_module(module_t* module)
+{
+    if (module->interface_table.arr)
+        CLEAR_FREE_VECTOR(interface_table_entry_t)(&module->interface_table, NULL);
+    memset(module, 0, sizeof(*module));
+}
+
+static bool test_resolves_to(const char* name, module_t* module, interface_base_t* interface_base)
+{
+    module_t* owner = NULL;
+    interface_table_entry_t* table_entry = NULL;
+    interface_base_t* found = NULL;
+
+    if (ob_get_interface(name, &found) != MSL_SUCCESS || found != interface_base) return false;
+    if (obp_lookup_interface_owner(name, true, &owner, &table_entry) != MSL_SUCCESS) return false;
+    return owner == module && table_entry->intf == interface_base && table_entry->owner_module == module;
+}
+
+static int test_case_folding(void)
+{
+    module_t first;
+    module_t second;
+    memset(&first, 0, sizeof(first));
+    memset(&second, 0, sizeof(second));
+    interface_base_t interface_base = test_interface_base();
+    interface_base_t other_base = test_interface_base();
+    module_t* owner = NULL;
+    interface_table_entry_t* table_entry = NULL;
+
+    create_count = 0;
+    TEST_CHECK_STATUS(ob_create_interface(&first, &interface_base, "YYTK_Main"), MSL_SUCCESS);
+    TEST_CHECK(create_count == 1);
+
+    TEST_CHECK(test_resolves_to("YYTK_Main", &first, &interface_base));
+    TEST_CHECK(test_resolves_to("yytk_main", &first, &interface_base));
+    TEST_CHECK(test_resolves_to("YYTK_MAIN", &first, &interface_base));
+    TEST_CHECK_STATUS(ob_interface_exists("yYtK_mAiN"), MSL_SUCCESS);
+    TEST_CHECK_STATUS(ob_interface_exists("YYTK_Mai"), MSL_OBJECT_NOT_FOUND);
+
+    // Case sensitive lookups still go through the registry but want the exact name
+    TEST_CHECK_STATUS(obp_lookup_interface_owner("YYTK_Main", false, &owner, &table_entry), MSL_SUCCESS);
+    TEST_CHECK(owner == &first && !strcmp(table_entry->interface_name, "YYTK_Main"));
+    TEST_CHECK_STATUS(obp_lookup_interface_owner("yytk_main", false, &owner, &table_entry), MSL_OBJECT_NOT_FOUND);
+
+    // Another case is the same name, for any module
+    TEST_CHECK_STATUS(ob_create_interface(&second, &other_base, "yytk_MAIN"), MSL_OBJECT_ALREADY_EXISTS);
+    TEST_CHECK_STATUS(ob_create_interface(&first, &other_base, "YYTK_MAIN"), MSL_OBJECT_ALREADY_EXISTS);
+    TEST_CHECK(create_count == 1);
+    TEST_CHECK(second.interface_table.size == 0);
+
+    // Names that can't be folded are refused, and never found
+    char long_name[INTERFACE_NAME_CAPACITY + 1];
+    memset(long_name, 'a', INTERFACE_NAME_CAPACITY);
+    long_name[INTERFACE_NAME_CAPACITY] = 0;
+    TEST_CHECK_STATUS(ob_create_interface(&second, &other_base, long_name), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(ob_interface_exists(long_name), MSL_OBJECT_NOT_FOUND);
+
+    // Only the owner destroys it, under any case
+    destroy_count = 0;
+    TEST_CHECK_STATUS(ob_destroy_interface(&second, "YYTK_Main"), MSL_ACCESS_DENIED);
+    TEST_CHECK_STATUS(ob_destroy_interface(&first, "yytk_main"), MSL_SUCCESS);
+    TEST_CHECK(destroy_count == 1);
+    TEST_CHECK(first.interface_table.size == 0);
+    TEST_CHECK_STATUS(ob_interface_exists("YYTK_Main"), MSL_OBJECT_NOT_FOUND);
+
+    // The name is free again
+    TEST_CHECK_STATUS(ob_create_interface(&second, &other_base, "YYTK_MAIN"), MSL_SUCCESS);
+    TEST_CHECK(test_resolves_to("yytk_main", &second, &other_base));
+    TEST_CHECK_STATUS(ob_destroy_interface(&second, "YYTK_MAIN"), MSL_SUCCESS);
+
+    test_release_module(&first);
+    test_release_module(&second);
+    return MSL_SUCCESS;
+}
+
+// The registry gives the owner, the entry is then found anywhere in its table
+static int test_table_position(void)
+{
+    module_t module;
+    memset(&module, 0, sizeof(module));
+    interface_base_t bases[3] = { test_interface_base(), test_interface_base(), test_interface_base() };
+    const char* names[3] = { "First", "Second", "Third" };
+    module_t* owner = NULL;
+    interface_table_entry_t* table_entry = NULL;
+
+    for (size_t i = 0; i < 3; i++)
+        TEST_CHECK_STATUS(ob_create_interface(&module, &bases[i], names[i]), MSL_SUCCESS);
+    TEST_CHECK(module.interface_table.size == 3);
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        TEST_CHECK_STATUS(obp_lookup_interface_owner(names[i], false, &owner, &table_entry), MSL_SUCCESS);
+        TEST_CHECK(table_entry == &module.interface_table.arr[i]);
+        TEST_CHECK(table_entry->intf == &bases[i] && table_entry->interface_name == names[i]);
+    }
+
+    // The entries after a removed one move down the table and are still found
+    TEST_CHECK_STATUS(ob_destroy_interface(&module, "first"), MSL_SUCCESS);
+    TEST_CHECK(module.interface_table.size == 2);
+    TEST_CHECK(test_resolves_to("SECOND", &module, &bases[1]));
+    TEST_CHECK(test_resolves_to("THIRD", &module, &bases[2]));
+
+    TEST_CHECK_STATUS(ob_destroy_interface(&module, "third"), MSL_SUCCESS);
+    TEST_CHECK(test_resolves_to("second", &module, &bases[1]));
+    TEST_CHECK_STATUS(ob_destroy_interface(&module, "second"), MSL_SUCCESS);
+
+    test_release_module(&module);
+    return MSL_SUCCESS;
+}
+
+// Removing an entry moves the last one in its place, its name has to follow it
+static int test_unregister(void)
+{
+    static module_t modules[TEST_MODULES];
+    static interface_base_t bases[TEST_INTERFACES];
+    static char names[TEST_INTERFACES][TEST_NAME_SIZE];
+    static char upper_names[TEST_INTERFACES][TEST_NAME_SIZE];
+    static size_t owners[TEST_INTERFACES];
+    static bool alive[TEST_INTERFACES];
+    uint64_t random_state = 48;
+
+    memset(modules, 0, sizeof(modules));
+    for (size_t i = 0; i < TEST_INTERFACES; i++)
+    {
+        bases[i] = test_interface_base();
+        snprintf(names[i], TEST_NAME_SIZE, "Interface_%zu", i);
+        for (size_t j = 0; j < TEST_NAME_SIZE; j++)
+            upper_names[i][j] = (char)toupper((unsigned char)names[i][j]);
+
+        owners[i] = (size_t)(test_random(&random_state) % TEST_MODULES);
+        TEST_CHECK_STATUS(ob_create_interface(&modules[owners[i]], &bases[i], names[i]), MSL_SUCCESS);
+        alive[i] = true;
+    }
+
+    // The last registered goes first so its slot is the one moved the most
+    TEST_CHECK_STATUS(ob_destroy_interface(&modules[owners[0]], upper_names[0]), MSL_SUCCESS);
+    alive[0] = false;
+
+    for (int round = 0; round < 4; round++)
+    {
+        for (size_t i = 0; i < TEST_INTERFACES; i++)
+        {
+            if (!alive[i] || test_random(&random_state) % 3) continue;
+
+            TEST_CHECK_STATUS(ob_destroy_interface(&modules[owners[i]], upper_names[i]), MSL_SUCCESS);
+            alive[i] = false;
+        }
+
+        for (size_t i = 0; i < TEST_INTERFACES; i++)
+        {
+            if (alive[i])
+                TEST_CHECK(test_resolves_to(upper_names[i], &modules[owners[i]], &bases[i]));
+            else
+                TEST_CHECK_STATUS(ob_interface_exists(names[i]), MSL_OBJECT_NOT_FOUND);
+        }
+
+        // The freed names can be taken again, by another module
+        for (size_t i = 0; i < TEST_INTERFACES; i++)
+        {
+            if (alive[i] || test_random(&random_state) % 2) continue;
+
+            owners[i] = (owners[i] + 1) % TEST_MODULES;
+            TEST_CHECK_STATUS(ob_create_interface(&modules[owners[i]], &bases[i], names[i]), MSL_SUCCESS);
+            alive[i] = true;
+        }
+    }
+
+    TEST_CHECK_STATUS(obp_unregister_interface("missing"), MSL_OBJECT_NOT_FOUND);
+
+    for (size_t i = 0; i < TEST_INTERFACES; i++)
+    {
+        if (alive[i])
+            TEST_CHECK_STATUS(ob_destroy_interface(&modules[owners[i]], names[i]), MSL_SUCCESS);
+        TEST_CHECK_STATUS(ob_interface_exists(names[i]), MSL_OBJECT_NOT_FOUND);
+    }
+
+    for (size_t i = 0; i < TEST_MODULES; i++)
+    {
+        TEST_CHECK(modules[i].interface_table.size == 0);
+        test_release_module(&modules[i]);
+    }
+    return MSL_SUCCESS;
+}
+
+// A lazy module holds its names until the first lookup initializes it
+static int test_reservations(void)
+{
+    module_t lazy;
+    module_t other;
+    memset(&lazy, 0, sizeof(lazy));
+    memset(&other, 0, sizeof(other));
+    lazy.flags.is_lazy = true;
+    interface_base_t lazy_base = test_interface_base();
+    interface_base_t other_base = test_interface_base();
+    interface_base_t* found = NULL;
+
+    lazy_creations[0] = (test_lazy_creation_t){ &lazy, &lazy_base, "Lazy_Created" };
+    lazy_creation_count = 1;
+    activation_count = 0;
+
+    TEST_CHECK_STATUS(obp_reserve_interface(&lazy, "Lazy_Created"), MSL_SUCCESS);
+    TEST_CHECK_STATUS(obp_reserve_interface(&lazy, "Lazy_Forgotten"), MSL_SUCCESS);
+    TEST_CHECK_STATUS(obp_reserve_interface(&other, "LAZY_CREATED"), MSL_OBJECT_ALREADY_EXISTS);
+
+    // Reserved names are taken for everyone else
+    TEST_CHECK_STATUS(ob_create_interface(&other, &other_base, "lazy_forgotten"), MSL_OBJECT_ALREADY_EXISTS);
+    TEST_CHECK(activation_count == 0);
+
+    // The first lookup initializes the module, which creates the interface in its reserved slot
+    TEST_CHECK_STATUS(ob_get_interface("LAZY_CREATED", &found), MSL_SUCCESS);
+    TEST_CHECK(found == &lazy_base);
+    TEST_CHECK(activation_count == 1 && !lazy.flags.is_lazy);
+    TEST_CHECK(test_resolves_to("lazy_created", &lazy, &lazy_base));
+    TEST_CHECK(activation_count == 1);
+
+    // The name it never created was released while it initialized
+    TEST_CHECK_STATUS(ob_get_interface("lazy_forgotten", &found), MSL_OBJECT_NOT_FOUND);
+    TEST_CHECK(activation_count == 1);
+    TEST_CHECK_STATUS(ob_create_interface(&other, &other_base, "Lazy_Forgotten"), MSL_SUCCESS);
+    TEST_CHECK(test_resolves_to("lazy_forgotten", &other, &other_base));
+
+    // A reservation of a module that isn't lazy anymore isn't found
+    TEST_CHECK_STATUS(obp_reserve_interface(&lazy, "Lazy_Late"), MSL_SUCCESS);
+    TEST_CHECK_STATUS(ob_interface_exists("lazy_late"), MSL_OBJECT_NOT_FOUND);
+    TEST_CHECK(activation_count == 1);
+
+    // Releasing only drops the names still waiting for their interface
+    TEST_CHECK_STATUS(obp_release_reserved_interfaces(&lazy), MSL_SUCCESS);
+    TEST_CHECK_STATUS(obp_reserve_interface(&other, "lazy_late"), MSL_SUCCESS);
+    TEST_CHECK(test_resolves_to("Lazy_Created", &lazy, &lazy_base));
+    TEST_CHECK_STATUS(obp_release_reserved_interfaces(&other), MSL_SUCCESS);
+    TEST_CHECK(test_resolves_to("Lazy_Forgotten", &other, &other_base));
+
+    TEST_CHECK_STATUS(ob_destroy_interface(&lazy, "Lazy_Created"), MSL_SUCCESS);
+    TEST_CHECK_STATUS(ob_destroy_interface(&other, "Lazy_Forgotten"), MSL_SUCCESS);
+    TEST_CHECK_STATUS(obp_unregister_interface("lazy_late"), MSL_OBJECT_NOT_FOUND);
+
+    lazy_creation_count = 0;
+    test_release_module(&lazy);
+    test_release_module(&other);
+    return MSL_SUCCESS;
+}
+
+static int test_entry(module_t* module, const char* path)
+{
+    (void)module;
+    (void)path;
+    return MSL_SUCCESS;
+}
+
+static size_t test_count_notifications(module_t* observer, module_t* affected_module, bool is_future_call)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < notification_count; i++)
+    {
+        const test_notification_t* notification = &notifications[i];
+        if (notification->observer == observer && notification->affected_module == affected_module &&
+            notification->is_future_call == is_future_call && notification->type == OPERATION_INITIALIZE)
+            count++;
+    }
+    return count;
+}
+
+// Every observer, thread safe or not, has each notification before the dispatch returns
+static int test_operation_callbacks(void)
+{
+    module_t* loaded[TEST_OBSERVERS + 1];
+    module_t affected;
+    memset(&affected, 0, sizeof(affected));
+    affected.module_initialize = test_entry;
+
+    for (size_t i = 0; i < TEST_OBSERVERS; i++)
+    {
+        memset(&observers[i], 0, sizeof(observers[i]));
+        TEST_CHECK_STATUS(obp_set_module_operation_callback(&observers[i], observer_callbacks[i]), MSL_SUCCESS);
+        TEST_CHECK_STATUS(ob_set_operation_callback_thread_safe(&observers[i], i % 2), MSL_SUCCESS);
+        TEST_CHECK(observers[i].flags.has_pooled_operation_callback == (i % 2 == 1));
+        loaded[i] = &observers[i];
+    }
+    loaded[TEST_OBSERVERS] = &affected;
+    global_module_table.modules = loaded;
+    global_module_table.count = TEST_OBSERVERS + 1;
+
+    // Outside of a batch and inside one, nested or not
+    for (int depth = 0; depth < 3; depth++)
+    {
+        for (int i = 0; i < depth; i++)
+            TEST_CHECK_STATUS(obp_begin_operation_batch(), MSL_SUCCESS);
+
+        notification_count = 0;
+        TEST_CHECK_STATUS(obp_dispatch_module_operation_callbacks(&affected, affected.module_initialize, true), MSL_SUCCESS);
+        for (size_t i = 0; i < TEST_OBSERVERS; i++)
+            TEST_CHECK(test_count_notifications(&observers[i], &affected, true) == 1);
+        TEST_CHECK(notification_count == TEST_OBSERVERS);
+
+        TEST_CHECK_STATUS(obp_dispatch_module_operation_callbacks(&affected, affected.module_initialize, false), MSL_SUCCESS);
+        for (size_t i = 0; i < TEST_OBSERVERS; i++)
+            TEST_CHECK(test_count_notifications(&observers[i], &affected, false) == 1);
+        TEST_CHECK(notification_count == TEST_OBSERVERS * 2);
+
+        // Per observer, the future call comes first
+        for (size_t i = 0; i < notification_count; i++)
+        {
+            if (notifications[i].is_future_call) continue;
+            for (size_t j = i + 1; j < notification_count; j++)
+                TEST_CHECK(notifications[j].observer != notifications[i].observer || !notifications[j].is_future_call);
+        }
+
+        for (int i = 0; i < depth; i++)
+            TEST_CHECK_STATUS(obp_end_operation_batch(), MSL_SUCCESS);
+        TEST_CHECK(notification_count == TEST_OBSERVERS * 2);
+    }
+    TEST_CHECK_STATUS(obp_end_operation_batch(), MSL_INVALID_PARAMETER);
+
+    // A failing thread safe callback fails the dispatch, and leaves nothing queued
+    failing_observer = 3;
+    TEST_CHECK_STATUS(obp_begin_operation_batch(), MSL_SUCCESS);
+    notification_count = 0;
+    TEST_CHECK_STATUS(obp_dispatch_module_operation_callbacks(&affected, affected.module_initialize, true), MSL_EXTERNAL_ERROR);
+    TEST_CHECK(test_count_notifications(&observers[3], &affected, true) == 1);
+    failing_observer = -1;
+    TEST_CHECK_STATUS(obp_dispatch_module_operation_callbacks(&affected, affected.module_initialize, true), MSL_SUCCESS);
+    TEST_CHECK(test_count_notifications(&observers[3], &affected, true) == 2);
+    TEST_CHECK(test_count_notifications(&observers[5], &affected, true) == 2);
+    TEST_CHECK_STATUS(obp_end_operation_batch(), MSL_SUCCESS);
+
+    global_module_table.modules = NULL;
+    global_module_table.count = 0;
+    return MSL_SUCCESS;
+}
+
+int test_object(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_case_folding);
+    CHECK_CALL(test_table_position);
+    CHECK_CALL(test_unregister);
+    CHECK_CALL(test_reservations);
+    CHECK_CALL(test_operation_callbacks);
+    return last_status;
+}
@@ -0,0 +1,279 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/room.h"
+
+#define TEST_INSTANCE_COUNT 1000
+
+// Large enough for an instance of any layout, YYObjectBase included
+#define TEST_INSTANCE_SIZE (sizeof(yyobject_base_t) + sizeof(instance_t))
+
+typedef struct test_room_s test_room_t;
+
+// Instances laid out back to back, linked in the order of the array
+struct test_room_s
+{
+    char* storage;
+    instance_t* instances[TEST_INSTANCE_COUNT];
+    OLINKEDLIST(instance_t) active_instances;
+    size_t members_offset;
+};
+
+static instance_internal_t* test_members(test_room_t* room, size_t index)
+{
+    return (instance_internal_t*)((char*)room->instances[index] + room->members_offset);
+}
+
+static int test_room_create(INSTANCE_LAYOUT layout, size_t count, test_room_t* room)
+{
+    int last_status = MSL_SUCCESS;
+    const instance_accessors_t* accessors = NULL;
+    CHECK_CALL(rm_get_instance_accessors, layout, &accessors);
+
+    memset(room, 0, sizeof(*room));
+    room->members_offset = accessors->members_offset;
+    room->storage = (char*)calloc(TEST_INSTANCE_COUNT, TEST_INSTANCE_SIZE);
+    if (!room->storage) return MSL_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < TEST_INSTANCE_COUNT; i++)
+        room->instances[i] = (instance_t*)(room->storage + i * TEST_INSTANCE_SIZE);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        instance_internal_t* members = test_members(room, i);
+        members->id = 100000 + (int32_t)i;
+        members->object_index = (int32_t)(i % 5);
+        members->flink = i + 1 < count ? room->instances[i + 1] : NULL;
+        members->blink = i ? room->instances[i - 1] : NULL;
+    }
+
+    room->active_instances.first = count ? room->instances[0] : NULL;
+    room->active_instances.last = count ? room->instances[count - 1] : NULL;
+    room->active_instances.count = (int32_t)count;
+    return MSL_SUCCESS;
+}
+
+// Drains the iterator batch by batch, the yielded instances are written to walked
+static size_t test_drain(instance_iterator_t* iterator, size_t capacity, instance_t** walked)
+{
+    instance_t* batch[16];
+    size_t total = 0;
+    size_t count = 0;
+
+    do
+    {
+        TEST_CHECK_STATUS(rm_iterator_next_batch(iterator, batch, capacity, &count), MSL_SUCCESS);
+        TEST_CHECK(count <= capacity);
+        if (total + count > TEST_INSTANCE_COUNT) break;
+
+        memcpy(&walked[total], batch, count * sizeof(instance_t*));
+        total += count;
+    } while (count);
+
+    TEST_CHECK(!iterator->next);
+    return total;
+}
+
+static int test_walk_all(void)
+{
+    int last_status = MSL_SUCCESS;
+    static instance_t* walked[TEST_INSTANCE_COUNT];
+
+    for (int32_t layout = 0; layout < INSTANCE_LAYOUT_COUNT; layout++)
+    {
+        test_room_t room;
+        CHECK_CALL(test_room_create, (INSTANCE_LAYOUT)layout, TEST_INSTANCE_COUNT, &room);
+
+        // Batches not dividing the room, then a single instance at a time
+        size_t capacities[] = { 7, 16, 1 };
+        for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++)
+        {
+            instance_iterator_t iterator;
+            TEST_CHECK_STATUS(rm_iterator_init(&room.active_instances, INSTANCE_ITERATOR_ALL_OBJECTS, room.members_offset, &iterator), MSL_SUCCESS);
+
+            size_t total = test_drain(&iterator, capacities[c], walked);
+            TEST_CHECK(total == TEST_INSTANCE_COUNT);
+            for (size_t i = 0; i < total; i++)
+                TEST_CHECK(walked[i] == room.instances[i]);
+        }
+
+        free(room.storage);
+    }
+
+    return last_status;
+}
+
+static int test_walk_object(void)
+{
+    int last_status = MSL_SUCCESS;
+    static instance_t* walked[TEST_INSTANCE_COUNT];
+    test_room_t room;
+    CHECK_CALL(test_room_create, INSTANCE_LAYOUT_SEQUENCE_INSTANCE_ONLY, TEST_INSTANCE_COUNT, &room);
+
+    // Only every fifth instance is of object 3, the last one included
+    instance_iterator_t iterator;
+    TEST_CHECK_STATUS(rm_iterator_init(&room.active_instances, 3, room.members_offset, &iterator), MSL_SUCCESS);
+    test_members(&room, TEST_INSTANCE_COUNT - 1)->object_index = 3;
+
+    size_t total = test_drain(&iterator, 16, walked);
+    TEST_CHECK(total == TEST_INSTANCE_COUNT / 5 + 1);
+    for (size_t i = 0; i < total; i++)
+    {
+        size_t expected = i < TEST_INSTANCE_COUNT / 5 ? 5 * i + 3 : TEST_INSTANCE_COUNT - 1;
+        TEST_CHECK(walked[i] == room.instances[expected]);
+    }
+
+    // No instance of the object, the walk still ends
+    TEST_CHECK_STATUS(rm_iterator_init(&room.active_instances, 42, room.members_offset, &iterator), MSL_SUCCESS);
+    TEST_CHECK(test_drain(&iterator, 16, walked) == 0);
+
+    free(room.storage);
+    return last_status;
+}
+
+static int test_walk_edges(void)
+{
+    int last_status = MSL_SUCCESS;
+    static instance_t* walked[TEST_INSTANCE_COUNT];
+    instance_iterator_t iterator;
+    test_room_t room;
+
+    // Empty room
+    CHECK_CALL(test_room_create, INSTANCE_LAYOUT_MEMBERS_ONLY, 0, &room);
+    TEST_CHECK_STATUS(rm_iterator_init(&room.active_instances, INSTANCE_ITERATOR_ALL_OBJECTS, room.members_offset, &iterator), MSL_SUCCESS);
+    TEST_CHECK(test_drain(&iterator, 16, walked) == 0);
+    free(room.storage);
+
+    // A flink chain looping back is cut by the instance count of the list
+    CHECK_CALL(test_room_create, INSTANCE_LAYOUT_MEMBERS_ONLY, 10, &room);
+    test_members(&room, 9)->flink = room.instances[0];
+    TEST_CHECK_STATUS(rm_iterator_init(&room.active_instances, 1, room.members_offset, &iterator), MSL_SUCCESS);
+    TEST_CHECK(test_drain(&iterator, 16, walked) == 2);
+    TEST_CHECK_STATUS(rm_iterator_init(&room.active_instances, INSTANCE_ITERATOR_ALL_OBJECTS, room.members_offset, &iterator), MSL_SUCCESS);
+    TEST_CHECK(test_drain(&iterator, 3, walked) == 10);
+    free(room.storage);
+
+    // A single instance is yielded without reading its members,
+    // a byte stands for an instance of unknown layout
+    char lone_instance = 0;
+    TEST_CHECK_STATUS(rm_iterator_init_single((instance_t*)&lone_instance, &iterator), MSL_SUCCESS);
+    TEST_CHECK(test_drain(&iterator, 16, walked) == 1);
+    TEST_CHECK(walked[0] == (instance_t*)&lone_instance);
+
+    TEST_CHECK_STATUS(rm_iterator_init_single(NULL, &iterator), MSL_SUCCESS);
+    TEST_CHECK(test_drain(&iterator, 16, walked) == 0);
+
+    size_t count = 1;
+    TEST_CHECK_STATUS(rm_iterator_init(NULL, INSTANCE_ITERATOR_ALL_OBJECTS, 0, &iterator), MSL_NULL_BUFFER);
+    TEST_CHECK_STATUS(rm_iterator_next_batch(&iterator, NULL, 16, &count), MSL_NULL_BUFFER);
+    TEST_CHECK(!count);
+    return last_status;
+}
+
+// Every accessor reads the field at the offset of its layout
+static int test_accessors(void)
+{
+    int last_status = MSL_SUCCESS;
+
+    for (int32_t layout = 0; layout < INSTANCE_LAYOUT_COUNT; layout++)
+    {
+        const instance_accessors_t* accessors = NULL;
+        test_room_t room;
+        CHECK_CALL(rm_get_instance_accessors, (INSTANCE_LAYOUT)layout, &accessors);
+        CHECK_CALL(test_room_create, (INSTANCE_LAYOUT)layout, 3, &room);
+        TEST_CHECK(accessors->layout == (INSTANCE_LAYOUT)layout);
+
+        for (size_t i = 0; i < 3; i++)
+        {
+            instance_t* instance = room.instances[i];
+            instance_internal_t* members = test_members(&room, i);
+            instance_internal_t* read_members = NULL;
+            members->x = 1.5f * (float)i;
+            members->y = -2.5f * (float)i;
+
+            TEST_CHECK(accessors->get_members(instance) == members);
+            TEST_CHECK(accessors->get_id(instance) == members->id);
+            TEST_CHECK(accessors->get_object_index(instance) == members->object_index);
+            TEST_CHECK(accessors->get_x(instance) == members->x);
+            TEST_CHECK(accessors->get_y(instance) == members->y);
+            TEST_CHECK(accessors->get_flink(instance) == members->flink);
+            TEST_CHECK(INSTANCE_MEMBER(accessors, instance, id) == members->id);
+            TEST_CHECK_STATUS(rm_get_instance_members(instance, accessors->members_offset, &read_members), MSL_SUCCESS);
+            TEST_CHECK(read_members == members);
+        }
+
+        free(room.storage);
+    }
+
+    const instance_accessors_t* accessors = NULL;
+    TEST_CHECK_STATUS(rm_get_instance_accessors((INSTANCE_LAYOUT)-1, &accessors), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(rm_get_instance_accessors(INSTANCE_LAYOUT_COUNT, &accessors), MSL_INVALID_PARAMETER);
+    return last_status;
+}
+
+static int test_detect_layout(void)
+{
+    int last_status = MSL_SUCCESS;
+
+    for (int32_t layout = 0; layout < INSTANCE_LAYOUT_COUNT; layout++)
+    {
+        test_room_t room;
+        room_t* runner_room = (room_t*)calloc(1, sizeof(room_t));
+        layer_instance_element_t elements[2] = { 0 };
+        INSTANCE_LAYOUT detected = INSTANCE_LAYOUT_COUNT;
+        if (!runner_room) return MSL_ALLOCATION_ERROR;
+        CHECK_CALL(test_room_create, (INSTANCE_LAYOUT)layout, 2, &room);
+
+        // The id the "id" builtin would return only reads back through the right layout
+        int32_t instance_id = test_members(&room, 0)->id;
+        TEST_CHECK_STATUS(rm_detect_layout_by_id(room.instances[0], instance_id, &detected), MSL_SUCCESS);
+        TEST_CHECK(detected == (INSTANCE_LAYOUT)layout);
+        TEST_CHECK_STATUS(rm_detect_layout_by_id(room.instances[0], -7, &detected), MSL_OBJECT_NOT_FOUND);
+
+        // Without the builtin, the element of that id points back at the instance.
+        // Elements of other instances, even found through a wrong layout, don't count.
+        HASHMAP(int32_t, p_layer_instance_element_t)* lookup = &runner_room->with_backgrounds.internals.instance_element_lookup;
+        elements[0].instance = room.instances[0];
+        elements[1].instance = room.instances[1];
+        TEST_CHECK_STATUS(INSERT(int32_t, p_layer_instance_element_t)(lookup, instance_id, &elements[0]), MSL_SUCCESS);
+        for (int32_t other = 0; other < INSTANCE_LAYOUT_COUNT; other++)
+        {
+            const instance_accessors_t* accessors = NULL;
+            CHECK_CALL(rm_get_instance_accessors, (INSTANCE_LAYOUT)other, &accessors);
+            if (other == layout) continue;
+
+            TEST_CHECK_STATUS(INSERT(int32_t, p_layer_instance_element_t)(lookup, accessors->get_id(room.instances[0]), &elements[1]), MSL_SUCCESS);
+        }
+
+        detected = INSTANCE_LAYOUT_COUNT;
+        TEST_CHECK_STATUS(rm_detect_layout_by_elements(runner_room, room.instances[0], &detected), MSL_SUCCESS);
+        TEST_CHECK(detected == (INSTANCE_LAYOUT)layout);
+
+        // The other instance only reads back through the wrong layouts, more than one match is refused
+        TEST_CHECK_STATUS(rm_detect_layout_by_elements(runner_room, room.instances[1], &detected), MSL_OBJECT_NOT_FOUND);
+
+        DESTROY_HASHMAP(int32_t, p_layer_instance_element_t)(lookup);
+        free(runner_room);
+        free(room.storage);
+    }
+
+    INSTANCE_LAYOUT detected = INSTANCE_LAYOUT_COUNT;
+    TEST_CHECK_STATUS(rm_detect_layout_by_id(NULL, 0, &detected), MSL_NULL_BUFFER);
+    TEST_CHECK_STATUS(rm_detect_layout_by_elements(NULL, NULL, &detected), MSL_NULL_BUFFER);
+    return last_status;
+}
+
+int test_room(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_walk_all);
+    CHECK_CALL(test_walk_object);
+    CHECK_CALL(test_walk_edges);
+    CHECK_CALL(test_accessors);
+    CHECK_CALL(test_detect_layout);
+    return last_status;
+}
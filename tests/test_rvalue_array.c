@@ -0,0 +1,150 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <string.h>
+#include "test.h"
+#include "../include/rvalue_array.h"
+
+// Enough for a few vector iterations and every tail length
+#define TEST_ARRAY_SIZE 13
+
+// Bits above the kind mask are set by some runners, they must be ignored
+#define TEST_KIND_HIGH_BITS 0x10000000
+
+static void test_fill_reals(rvalue_t* data, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        memset(&data[i], 0, sizeof(rvalue_t));
+        data[i].real = (double)i * 1.25 - 4.0;
+        data[i].kind = i % 2 ? (RVALUE_TYPE)(VALUE_REAL | TEST_KIND_HIGH_BITS) : VALUE_REAL;
+    }
+}
+
+static int test_read_reals(void)
+{
+    rvalue_t data[TEST_ARRAY_SIZE] = { 0 };
+    double values[TEST_ARRAY_SIZE];
+
+    for (size_t count = 0; count <= TEST_ARRAY_SIZE; count++)
+    {
+        test_fill_reals(data, count);
+        memset(values, 0, sizeof(values));
+        TEST_CHECK_STATUS(ra_read_reals(data, count, values), MSL_SUCCESS);
+        for (size_t i = 0; i < count; i++)
+            TEST_CHECK(values[i] == data[i].real);
+
+        // A single non real element fails the read, wherever it is
+        for (size_t odd = 0; odd < count; odd++)
+        {
+            test_fill_reals(data, count);
+            data[odd].kind = VALUE_INT32;
+            TEST_CHECK_STATUS(ra_read_reals(data, count, values), MSL_INVALID_PARAMETER);
+        }
+    }
+
+    TEST_CHECK_STATUS(ra_read_reals(NULL, 0, values), MSL_NULL_BUFFER);
+    return MSL_SUCCESS;
+}
+
+static int test_write_reals(void)
+{
+    rvalue_t data[TEST_ARRAY_SIZE] = { 0 };
+    double values[TEST_ARRAY_SIZE];
+    RVALUE_TYPE plain_kinds[] = { VALUE_PTR, VALUE_UNDEFINED, VALUE_INT32, VALUE_INT64, VALUE_NULL, VALUE_BOOL };
+
+    for (size_t i = 0; i < TEST_ARRAY_SIZE; i++)
+        values[i] = 100.0 + (double)i;
+
+    for (size_t count = 0; count <= TEST_ARRAY_SIZE; count++)
+    {
+        // Plain elements of any kind become reals
+        test_fill_reals(data, count);
+        for (size_t i = 0; i < count; i += 3)
+            data[i].kind = plain_kinds[i % (sizeof(plain_kinds) / sizeof(plain_kinds[0]))];
+
+        TEST_CHECK_STATUS(ra_write_reals(data, count, values), MSL_SUCCESS);
+        for (size_t i = 0; i < count; i++)
+        {
+            TEST_CHECK(data[i].kind == VALUE_REAL);
+            TEST_CHECK(data[i].real == values[i]);
+        }
+
+        // An element holding a runner reference keeps the whole array untouched
+        for (size_t referenced = 0; referenced < count; referenced++)
+        {
+            rvalue_t before[TEST_ARRAY_SIZE];
+            test_fill_reals(data, count);
+            data[referenced].kind = referenced % 2 ? VALUE_STRING : VALUE_ARRAY;
+            memcpy(before, data, count * sizeof(rvalue_t));
+
+            TEST_CHECK_STATUS(ra_write_reals(data, count, values), MSL_INVALID_PARAMETER);
+            TEST_CHECK(!memcmp(before, data, count * sizeof(rvalue_t)));
+        }
+    }
+
+    TEST_CHECK_STATUS(ra_write_reals(data, 1, NULL), MSL_NULL_BUFFER);
+    return MSL_SUCCESS;
+}
+
+static int test_copy(void)
+{
+    rvalue_t data[TEST_ARRAY_SIZE] = { 0 };
+    rvalue_t values[TEST_ARRAY_SIZE];
+
+    test_fill_reals(data, TEST_ARRAY_SIZE);
+    TEST_CHECK_STATUS(ra_copy_out(data, TEST_ARRAY_SIZE, values), MSL_SUCCESS);
+    TEST_CHECK(!memcmp(data, values, sizeof(data)));
+
+    // Copying in needs plain old and new values
+    for (size_t i = 0; i < TEST_ARRAY_SIZE; i++)
+        values[i].real = -(double)i;
+    TEST_CHECK_STATUS(ra_copy_in(data, TEST_ARRAY_SIZE, values), MSL_SUCCESS);
+    TEST_CHECK(!memcmp(data, values, sizeof(data)));
+
+    values[5].kind = VALUE_OBJECT;
+    TEST_CHECK_STATUS(ra_copy_in(data, TEST_ARRAY_SIZE, values), MSL_INVALID_PARAMETER);
+    TEST_CHECK((data[5].kind & RVALUE_KIND_MASK) == VALUE_REAL);
+
+    values[5].kind = VALUE_REAL;
+    data[7].kind = VALUE_STRING;
+    TEST_CHECK_STATUS(ra_copy_in(data, TEST_ARRAY_SIZE, values), MSL_INVALID_PARAMETER);
+    TEST_CHECK(data[0].real == values[0].real);
+    return MSL_SUCCESS;
+}
+
+static int test_get_data(void)
+{
+    // Stands in for the runner array object, the storage pointer lives at the offset
+    struct { int64_t header; rvalue_t* storage; } array_object = { 0, NULL };
+    rvalue_t storage[2];
+    rvalue_t array = { 0 };
+    rvalue_t* data = NULL;
+    int64_t offset = (int64_t)((char*)&array_object.storage - (char*)&array_object);
+
+    array.pointer = &array_object;
+    array.kind = VALUE_ARRAY;
+    TEST_CHECK_STATUS(ra_get_data(&array, offset, &data), MSL_NULL_BUFFER);
+
+    array_object.storage = storage;
+    TEST_CHECK_STATUS(ra_get_data(&array, offset, &data), MSL_SUCCESS);
+    TEST_CHECK(data == storage);
+
+    // The offset is unknown until detected
+    TEST_CHECK_STATUS(ra_get_data(&array, 0, &data), MSL_MODULE_INTERNAL_ERROR);
+
+    array.kind = VALUE_REAL;
+    TEST_CHECK_STATUS(ra_get_data(&array, offset, &data), MSL_INVALID_PARAMETER);
+    return MSL_SUCCESS;
+}
+
+int test_rvalue_array(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_read_reals);
+    CHECK_CALL(test_write_reals);
+    CHECK_CALL(test_copy);
+    CHECK_CALL(test_get_data);
+    return last_status;
+}
@@ -0,0 +1,123 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <math.h>
+#include <string.h>
+#include "test.h"
+#include "../include/rvalue_string.h"
+
+static rvalue_t test_rvalue_real(double value)
+{
+    rvalue_t rvalue = { 0 };
+    rvalue.real = value;
+    rvalue.kind = VALUE_REAL;
+    return rvalue;
+}
+
+// Formats into a buffer and compares, the length must match the text
+static void test_check_format(rvalue_t value, const char* expected)
+{
+    char buffer[RVALUE_STRING_SCRATCH_SIZE];
+    size_t length = 0;
+
+    TEST_CHECK_STATUS(rs_to_buffer(&value, buffer, sizeof(buffer), &length), MSL_SUCCESS);
+    TEST_CHECK(length == strlen(expected));
+    TEST_CHECK(!strcmp(buffer, expected));
+}
+
+static int test_format_reals(void)
+{
+    test_check_format(test_rvalue_real(0.0), "0");
+    test_check_format(test_rvalue_real(-12.0), "-12");
+    test_check_format(test_rvalue_real(1.5), "1.50");
+    test_check_format(test_rvalue_real(-0.001), "0.00");
+    test_check_format(test_rvalue_real(9007199254740991.0), "9007199254740991");
+    test_check_format(test_rvalue_real(NAN), "NaN");
+    test_check_format(test_rvalue_real(INFINITY), "inf");
+    test_check_format(test_rvalue_real(-INFINITY), "-inf");
+
+    // Past 2^53 "%.0f" would need up to 309 digits, far more than the scratch buffer
+    test_check_format(test_rvalue_real(9007199254740992.0), "9.00719925474099e+15");
+    test_check_format(test_rvalue_real(1e300), "1e+300");
+    test_check_format(test_rvalue_real(-1.7976931348623157e308), "-1.79769313486232e+308");
+
+    // A buffer too small reports the length it needed
+    char buffer[4];
+    size_t length = 0;
+    rvalue_t value = test_rvalue_real(-1e300);
+    TEST_CHECK_STATUS(rs_to_buffer(&value, buffer, sizeof(buffer), &length), MSL_INSUFFICIENT_MEMORY);
+    TEST_CHECK(length == strlen("-1e+300"));
+    TEST_CHECK_STATUS(rs_to_buffer(&value, NULL, 0, &length), MSL_INSUFFICIENT_MEMORY);
+    TEST_CHECK(length == strlen("-1e+300"));
+    return MSL_SUCCESS;
+}
+
+static int test_format_scalars(void)
+{
+    rvalue_t value = { 0 };
+
+    value.kind = VALUE_INT32;
+    value.i32 = -42;
+    test_check_format(value, "-42");
+
+    value.kind = VALUE_INT64;
+    value.i64 = INT64_MIN;
+    test_check_format(value, "-9223372036854775808");
+
+    value.kind = VALUE_BOOL;
+    value.real = 1.0;
+    test_check_format(value, "true");
+    value.real = 0.0;
+    test_check_format(value, "false");
+
+    value.kind = VALUE_UNDEFINED;
+    test_check_format(value, "undefined");
+    value.kind = VALUE_NULL;
+    test_check_format(value, "null");
+
+    // Arrays and structs need the runner
+    char buffer[16];
+    size_t length = 0;
+    value.kind = VALUE_ARRAY;
+    TEST_CHECK_STATUS(rs_to_buffer(&value, buffer, sizeof(buffer), &length), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(rs_to_buffer(NULL, buffer, sizeof(buffer), &length), MSL_NULL_BUFFER);
+    return MSL_SUCCESS;
+}
+
+static int test_views(void)
+{
+    ref_string_t storage;
+    rvalue_t value;
+    string_view_t view;
+
+    TEST_CHECK_STATUS(rs_init_borrowed(&storage, "asset_name", &value), MSL_SUCCESS);
+    TEST_CHECK(value.kind == VALUE_STRING);
+    TEST_CHECK(storage.ref_count == RVALUE_STRING_PINNED_REF_COUNT);
+    TEST_CHECK_STATUS(rs_get_view(&value, &view), MSL_SUCCESS);
+    TEST_CHECK(view.data == storage.thing && view.length == strlen("asset_name"));
+    test_check_format(value, "asset_name");
+
+    // Literals of some runners have no size
+    storage.size = 0;
+    TEST_CHECK_STATUS(rs_get_view(&value, &view), MSL_SUCCESS);
+    TEST_CHECK(view.length == strlen("asset_name"));
+
+    storage.thing = NULL;
+    TEST_CHECK_STATUS(rs_get_view(&value, &view), MSL_NULL_BUFFER);
+    TEST_CHECK(!view.data && !view.length);
+
+    value = test_rvalue_real(1.0);
+    TEST_CHECK_STATUS(rs_get_view(&value, &view), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(rs_init_borrowed(&storage, NULL, &value), MSL_NULL_BUFFER);
+    return MSL_SUCCESS;
+}
+
+int test_rvalue_string(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_format_reals);
+    CHECK_CALL(test_format_scalars);
+    CHECK_CALL(test_views);
+    return last_status;
+}
@@ -0,0 +1,496 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/serializer.h"
+
+#define TEST_STRUCT_CAPACITY 16
+#define TEST_SERIALIZER_PATH "test_serializer.msls"
+
+typedef struct test_array_s test_array_t;
+typedef struct test_struct_s test_struct_t;
+
+// Runner side of the values, reference counted like the runner does it.
+// live_objects drops back to 0 once everything made is freed.
+static int live_objects = 0;
+
+struct test_array_s
+{
+    int64_t header;
+    rvalue_t* data;
+    int length;
+    int ref_count;
+};
+
+// Starts with a YYObjectBase, like every runner struct
+struct test_struct_s
+{
+    yyobject_base_t base;
+    int count;
+    char* names[TEST_STRUCT_CAPACITY];
+    rvalue_t values[TEST_STRUCT_CAPACITY];
+    int ref_count;
+};
+
+static void test_copy_rvalue(rvalue_t* destination, const rvalue_t* source)
+{
+    *destination = *source;
+
+    switch (source->kind & RVALUE_KIND_MASK)
+    {
+    case VALUE_STRING:
+        ((ref_string_t*)source->pointer)->ref_count++;
+        break;
+    case VALUE_ARRAY:
+        ((test_array_t*)source->pointer)->ref_count++;
+        break;
+    case VALUE_OBJECT:
+        ((test_struct_t*)source->pointer)->ref_count++;
+        break;
+    default:
+        break;
+    }
+}
+
+static void test_free_rvalue(rvalue_t* value)
+{
+    switch (value->kind & RVALUE_KIND_MASK)
+    {
+    case VALUE_STRING:
+    {
+        ref_string_t* string = (ref_string_t*)value->pointer;
+        if (--string->ref_count) break;
+
+        free((char*)string->thing);
+        free(string);
+        live_objects--;
+        break;
+    }
+    case VALUE_ARRAY:
+    {
+        test_array_t* array = (test_array_t*)value->pointer;
+        if (--array->ref_count) break;
+
+        for (int i = 0; i < array->length; i++)
+            test_free_rvalue(&array->data[i]);
+        free(array->data);
+        free(array);
+        live_objects--;
+        break;
+    }
+    case VALUE_OBJECT:
+    {
+        test_struct_t* object = (test_struct_t*)value->pointer;
+        if (--object->ref_count) break;
+
+        for (int i = 0; i < object->count; i++)
+        {
+            free(object->names[i]);
+            test_free_rvalue(&object->values[i]);
+        }
+        free(object);
+        live_objects--;
+        break;
+    }
+    default:
+        break;
+    }
+
+    value->real = 0.0;
+    value->kind = VALUE_UNDEFINED;
+}
+
+static void test_create_string(rvalue_t* value, const char* text)
+{
+    ref_string_t* string = (ref_string_t*)calloc(1, sizeof(ref_string_t));
+    size_t length = strlen(text);
+    char* copy = (char*)malloc(length + 1);
+    memcpy(copy, text, length + 1);
+
+    string->thing = copy;
+    string->ref_count = 1;
+    string->size = (int32_t)length;
+    live_objects++;
+
+    value->pointer = string;
+    value->flags = 0;
+    value->kind = VALUE_STRING;
+}
+
+static void test_create_array(rvalue_t* value, int count, const double* values)
+{
+    test_array_t* array = (test_array_t*)calloc(1, sizeof(test_array_t));
+    array->data = (rvalue_t*)calloc(count ? (size_t)count : 1, sizeof(rvalue_t));
+    array->length = count;
+    array->ref_count = 1;
+    for (int i = 0; i < count; i++)
+        array->data[i].real = values[i];
+    live_objects++;
+
+    value->pointer = array;
+    value->flags = 0;
+    value->kind = VALUE_ARRAY;
+}
+
+static int test_array_length(rvalue_t* value)
+{
+    return ((test_array_t*)value->pointer)->length;
+}
+
+static void test_create_struct(rvalue_t* value)
+{
+    test_struct_t* object = (test_struct_t*)calloc(1, sizeof(test_struct_t));
+    object->base.object_kind = OBJECT_KIND_YYOBJECTBASE;
+    object->ref_count = 1;
+    live_objects++;
+
+    value->pointer = object;
+    value->flags = 0;
+    value->kind = VALUE_OBJECT;
+}
+
+static rvalue_t* test_struct_member(rvalue_t* value, const char* name)
+{
+    test_struct_t* object = (test_struct_t*)value->pointer;
+    for (int i = 0; i < object->count; i++)
+    {
+        if (!strcmp(object->names[i], name)) return &object->values[i];
+    }
+    return NULL;
+}
+
+static void test_struct_add(rvalue_t* value, const char* name, rvalue_t* member)
+{
+    test_struct_t* object = (test_struct_t*)value->pointer;
+    rvalue_t* existing = test_struct_member(value, name);
+    if (existing)
+    {
+        test_free_rvalue(existing);
+        test_copy_rvalue(existing, member);
+        return;
+    }
+
+    if (object->count == TEST_STRUCT_CAPACITY) return;
+
+    size_t length = strlen(name);
+    object->names[object->count] = (char*)malloc(length + 1);
+    memcpy(object->names[object->count], name, length + 1);
+    test_copy_rvalue(&object->values[object->count++], member);
+}
+
+static int test_struct_keys(rvalue_t* value, const char** keys, int* count)
+{
+    test_struct_t* object = (test_struct_t*)value->pointer;
+    if (!keys) return object->count;
+
+    for (int i = 0; i < object->count && i < *count; i++)
+        keys[i] = object->names[i];
+    return object->count;
+}
+
+static const yyrunner_interface_t* test_runner(void)
+{
+    static yyrunner_interface_t runner;
+    runner.COPY_rvalue_t = test_copy_rvalue;
+    runner.FREE_rvalue_t = test_free_rvalue;
+    runner.YYCreateString = test_create_string;
+    runner.YYCreateArray = test_create_array;
+    runner.YYArrayGetLength = test_array_length;
+    runner.StructCreate = test_create_struct;
+    runner.StructAddrvalue_t = test_struct_add;
+    runner.StructGetMember = test_struct_member;
+    runner.StructGetKeys = test_struct_keys;
+    return &runner;
+}
+
+static rvalue_t* test_array_data(rvalue_t* value)
+{
+    return ((test_array_t*)value->pointer)->data;
+}
+
+// Moves member into the struct, the caller's reference is given away
+static void test_struct_give(rvalue_t* value, const char* name, rvalue_t member)
+{
+    test_struct_add(value, name, &member);
+    test_free_rvalue(&member);
+}
+
+static rvalue_t test_scalar(RVALUE_TYPE kind, double real)
+{
+    rvalue_t value = { 0 };
+    value.real = real;
+    value.kind = kind;
+    return value;
+}
+
+static rvalue_t test_string(const char* text)
+{
+    rvalue_t value;
+    test_create_string(&value, text);
+    return value;
+}
+
+// Same kinds, same values, same members in the same order
+static bool test_equal(const rvalue_t* first, const rvalue_t* second)
+{
+    if ((first->kind & RVALUE_KIND_MASK) != (second->kind & RVALUE_KIND_MASK)) return false;
+
+    switch (first->kind & RVALUE_KIND_MASK)
+    {
+    case VALUE_REAL:
+    case VALUE_BOOL:
+        return first->real == second->real;
+    case VALUE_INT32:
+        return first->i32 == second->i32;
+    case VALUE_INT64:
+        return first->i64 == second->i64;
+    case VALUE_STRING:
+    {
+        const ref_string_t* a = (const ref_string_t*)first->pointer;
+        const ref_string_t* b = (const ref_string_t*)second->pointer;
+        return a->size == b->size && !memcmp(a->thing, b->thing, (size_t)a->size);
+    }
+    case VALUE_ARRAY:
+    {
+        const test_array_t* a = (const test_array_t*)first->pointer;
+        const test_array_t* b = (const test_array_t*)second->pointer;
+        if (a->length != b->length) return false;
+        for (int i = 0; i < a->length; i++)
+        {
+            if (!test_equal(&a->data[i], &b->data[i])) return false;
+        }
+        return true;
+    }
+    case VALUE_OBJECT:
+    {
+        const test_struct_t* a = (const test_struct_t*)first->pointer;
+        const test_struct_t* b = (const test_struct_t*)second->pointer;
+        if (a->count != b->count) return false;
+        for (int i = 0; i < a->count; i++)
+        {
+            if (strcmp(a->names[i], b->names[i]) || !test_equal(&a->values[i], &b->values[i])) return false;
+        }
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+static int64_t test_array_offset(void)
+{
+    return (int64_t)offsetof(test_array_t, data);
+}
+
+// A save of every kind, with repeated strings and keys, nested arrays and structs
+static int test_round_trip(void)
+{
+    const yyrunner_interface_t* runner = test_runner();
+    rvalue_t saved;
+    rvalue_t loaded;
+    double reals[3] = { 1.0, 2.0, 3.0 };
+
+    test_create_struct(&saved);
+    test_struct_give(&saved, "name", test_string("hero"));
+    test_struct_give(&saved, "hp", test_scalar(VALUE_REAL, 12.5));
+    test_struct_give(&saved, "alive", test_scalar(VALUE_BOOL, 1.0));
+    test_struct_give(&saved, "nothing", test_scalar(VALUE_UNDEFINED, 0.0));
+    test_struct_give(&saved, "empty", test_scalar(VALUE_NULL, 0.0));
+
+    rvalue_t level = test_scalar(VALUE_INT32, 0.0);
+    level.i32 = -7;
+    test_struct_give(&saved, "level", level);
+    rvalue_t xp = test_scalar(VALUE_INT64, 0.0);
+    xp.i64 = INT64_MAX - 3;
+    test_struct_give(&saved, "xp", xp);
+
+    rvalue_t tags;
+    test_create_array(&tags, 3, reals);
+    test_array_data(&tags)[0] = test_string("a");
+    test_array_data(&tags)[2] = test_string("hero");
+    test_struct_give(&saved, "tags", tags);
+
+    // Items share their keys, and one holds a nested array and an empty one
+    rvalue_t inventory;
+    test_create_array(&inventory, 3, reals);
+    for (int i = 0; i < 3; i++)
+    {
+        rvalue_t item;
+        test_create_struct(&item);
+        test_struct_give(&item, "name", test_string(i == 1 ? "sword" : "potion"));
+        test_struct_give(&item, "count", test_scalar(VALUE_REAL, (double)i));
+        if (i == 2)
+        {
+            rvalue_t grid;
+            rvalue_t row;
+            test_create_array(&grid, 2, reals);
+            test_create_array(&row, 3, reals);
+            test_free_rvalue(&test_array_data(&grid)[0]);
+            test_array_data(&grid)[0] = row;
+            test_struct_give(&item, "grid", grid);
+
+            rvalue_t nothing;
+            test_create_array(&nothing, 0, NULL);
+            test_struct_give(&item, "nothing", nothing);
+        }
+        test_array_data(&inventory)[i] = item;
+    }
+    test_struct_give(&saved, "inventory", inventory);
+
+    rvalue_t empty_struct;
+    test_create_struct(&empty_struct);
+    test_struct_give(&saved, "empty_struct", empty_struct);
+
+    // A struct shared without a cycle is written once per reference
+    rvalue_t shared;
+    test_create_struct(&shared);
+    test_struct_give(&shared, "x", test_scalar(VALUE_REAL, 4.0));
+    test_struct_add(&saved, "first", &shared);
+    test_struct_give(&saved, "second", shared);
+
+    TEST_CHECK_STATUS(sr_save(runner, test_array_offset(), &saved, TEST_SERIALIZER_PATH), MSL_SUCCESS);
+    TEST_CHECK_STATUS(sr_load(runner, test_array_offset(), TEST_SERIALIZER_PATH, &loaded), MSL_SUCCESS);
+    TEST_CHECK(test_equal(&saved, &loaded));
+
+    // The loaded copies of the shared struct are separate
+    if ((loaded.kind & RVALUE_KIND_MASK) == VALUE_OBJECT)
+    {
+        rvalue_t* first = test_struct_member(&loaded, "first");
+        rvalue_t* second = test_struct_member(&loaded, "second");
+        TEST_CHECK(first && second && first->pointer != second->pointer);
+    }
+
+    test_free_rvalue(&saved);
+    test_free_rvalue(&loaded);
+    TEST_CHECK(live_objects == 0);
+    remove(TEST_SERIALIZER_PATH);
+    return MSL_SUCCESS;
+}
+
+// Strings larger than the write buffer skip it
+static int test_large_string(void)
+{
+    const yyrunner_interface_t* runner = test_runner();
+    size_t length = SERIALIZER_BUFFER_SIZE * 2 + 5;
+    char* text = (char*)malloc(length + 1);
+    if (!text) return MSL_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < length; i++)
+        text[i] = (char)('a' + i % 26);
+    text[length] = '\0';
+
+    double reals[2] = { 0.0, 0.0 };
+    rvalue_t saved;
+    rvalue_t loaded;
+    test_create_array(&saved, 2, reals);
+    test_array_data(&saved)[1] = test_string(text);
+    free(text);
+
+    TEST_CHECK_STATUS(sr_save(runner, test_array_offset(), &saved, TEST_SERIALIZER_PATH), MSL_SUCCESS);
+    TEST_CHECK_STATUS(sr_load(runner, test_array_offset(), TEST_SERIALIZER_PATH, &loaded), MSL_SUCCESS);
+    TEST_CHECK(test_equal(&saved, &loaded));
+
+    test_free_rvalue(&saved);
+    test_free_rvalue(&loaded);
+    TEST_CHECK(live_objects == 0);
+    remove(TEST_SERIALIZER_PATH);
+    return MSL_SUCCESS;
+}
+
+static int test_refused_values(void)
+{
+    const yyrunner_interface_t* runner = test_runner();
+    double reals[1] = { 0.0 };
+
+    // A struct holding itself can't be written, and keeps its visited field
+    rvalue_t cycle;
+    test_create_struct(&cycle);
+    test_struct_add(&cycle, "self", &cycle);
+    ((test_struct_t*)cycle.pointer)->base.visited = 3;
+    TEST_CHECK_STATUS(sr_save(runner, test_array_offset(), &cycle, TEST_SERIALIZER_PATH), MSL_INVALID_PARAMETER);
+    TEST_CHECK(((test_struct_t*)cycle.pointer)->base.visited == 3);
+
+    // Break the cycle so both references go away
+    test_free_rvalue(test_struct_member(&cycle, "self"));
+    test_free_rvalue(&cycle);
+
+    // Arrays nested deeper than the limit
+    rvalue_t deep;
+    test_create_array(&deep, 1, reals);
+    rvalue_t* innermost = &deep;
+    for (int depth = 0; depth < SERIALIZER_MAX_DEPTH; depth++)
+    {
+        rvalue_t inner;
+        test_create_array(&inner, 1, reals);
+        test_array_data(innermost)[0] = inner;
+        innermost = &test_array_data(innermost)[0];
+    }
+    TEST_CHECK_STATUS(sr_save(runner, test_array_offset(), &deep, TEST_SERIALIZER_PATH), MSL_INVALID_PARAMETER);
+    test_free_rvalue(&deep);
+
+    TEST_CHECK(live_objects == 0);
+    remove(TEST_SERIALIZER_PATH);
+    return MSL_SUCCESS;
+}
+
+// Damaged files leave nothing behind
+static int test_damaged_files(void)
+{
+    const yyrunner_interface_t* runner = test_runner();
+    rvalue_t saved;
+    rvalue_t loaded;
+
+    test_create_struct(&saved);
+    test_struct_give(&saved, "name", test_string("hero"));
+    test_struct_give(&saved, "hp", test_scalar(VALUE_REAL, 1.0));
+    TEST_CHECK_STATUS(sr_save(runner, test_array_offset(), &saved, TEST_SERIALIZER_PATH), MSL_SUCCESS);
+    test_free_rvalue(&saved);
+
+    // Every truncation of the file fails to load
+    FILE* file = fopen(TEST_SERIALIZER_PATH, "rb");
+    uint8_t content[256];
+    size_t size = file ? fread(content, 1, sizeof(content), file) : 0;
+    if (file) fclose(file);
+    TEST_CHECK(size > 8 && size < sizeof(content));
+
+    for (size_t truncated = 0; truncated < size; truncated++)
+    {
+        file = fopen(TEST_SERIALIZER_PATH, "wb");
+        if (!file) break;
+        fwrite(content, 1, truncated, file);
+        fclose(file);
+
+        int status = sr_load(runner, test_array_offset(), TEST_SERIALIZER_PATH, &loaded);
+        TEST_CHECK(status == MSL_UNREADABLE_FILE);
+        TEST_CHECK(loaded.kind == VALUE_UNDEFINED);
+    }
+
+    // Another magic
+    content[0] ^= 0xFF;
+    file = fopen(TEST_SERIALIZER_PATH, "wb");
+    if (file)
+    {
+        fwrite(content, 1, size, file);
+        fclose(file);
+    }
+    TEST_CHECK_STATUS(sr_load(runner, test_array_offset(), TEST_SERIALIZER_PATH, &loaded), MSL_INVALID_SIGNATURE);
+
+    TEST_CHECK(live_objects == 0);
+    remove(TEST_SERIALIZER_PATH);
+    TEST_CHECK_STATUS(sr_load(runner, test_array_offset(), TEST_SERIALIZER_PATH, &loaded), MSL_ACCESS_DENIED);
+    return MSL_SUCCESS;
+}
+
+int test_serializer(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_round_trip);
+    CHECK_CALL(test_large_string);
+    CHECK_CALL(test_refused_values);
+    CHECK_CALL(test_damaged_files);
+    return last_status;
+}
@@ -0,0 +1,224 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/snapshot.h"
+
+// Not a multiple of the batch size nor of the vector widths
+#define TEST_SNAPSHOT_COUNT 301
+
+#define TEST_INSTANCE_SIZE (sizeof(yyobject_base_t) + sizeof(instance_t))
+
+typedef struct test_instances_s test_instances_t;
+
+struct test_instances_s
+{
+    char* storage;
+    OLINKEDLIST(instance_t) active_instances;
+    size_t members_offset;
+};
+
+static instance_t* test_instance(const test_instances_t* instances, size_t index)
+{
+    return (instance_t*)(instances->storage + index * TEST_INSTANCE_SIZE);
+}
+
+static instance_internal_t* test_members(const test_instances_t* instances, size_t index)
+{
+    return (instance_internal_t*)((char*)test_instance(instances, index) + instances->members_offset);
+}
+
+// Every field of an instance gets a value of its own
+static float test_field_value(size_t index, size_t field)
+{
+    return (float)index * 0.5f + (float)field * 1000.0f;
+}
+
+static const float* test_member_field(const instance_internal_t* members, size_t field)
+{
+    const float* fields[SNAPSHOT_FIELD_COUNT] =
+    {
+        &members->x, &members->y, &members->speed, &members->direction,
+        &members->horizontal_speed, &members->vertical_speed,
+        &members->image_index, &members->image_speed,
+        &members->image_scale_x, &members->image_scale_y,
+        &members->image_angle, &members->image_alpha,
+        &members->bounding_box.left, &members->bounding_box.top,
+        &members->bounding_box.right, &members->bounding_box.bottom,
+    };
+    return fields[field];
+}
+
+static const float* test_snapshot_field(const instance_snapshot_t* snapshot, size_t field)
+{
+    const float* fields[SNAPSHOT_FIELD_COUNT] =
+    {
+        snapshot->x, snapshot->y, snapshot->speed, snapshot->direction,
+        snapshot->horizontal_speed, snapshot->vertical_speed,
+        snapshot->image_index, snapshot->image_speed,
+        snapshot->image_scale_x, snapshot->image_scale_y,
+        snapshot->image_angle, snapshot->image_alpha,
+        snapshot->bbox_left, snapshot->bbox_top,
+        snapshot->bbox_right, snapshot->bbox_bottom,
+    };
+    return fields[field];
+}
+
+static int test_instances_create(test_instances_t* instances)
+{
+    int last_status = MSL_SUCCESS;
+    const instance_accessors_t* accessors = NULL;
+    CHECK_CALL(rm_get_instance_accessors, INSTANCE_LAYOUT_SEQUENCE_INSTANCE_ONLY, &accessors);
+
+    instances->members_offset = accessors->members_offset;
+    instances->storage = (char*)calloc(TEST_SNAPSHOT_COUNT, TEST_INSTANCE_SIZE);
+    if (!instances->storage) return MSL_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < TEST_SNAPSHOT_COUNT; i++)
+    {
+        instance_internal_t* members = test_members(instances, i);
+        for (size_t field = 0; field < SNAPSHOT_FIELD_COUNT; field++)
+            *(float*)test_member_field(members, field) = test_field_value(i, field);
+
+        members->object_index = 1;
+        members->flink = i + 1 < TEST_SNAPSHOT_COUNT ? test_instance(instances, i + 1) : NULL;
+    }
+
+    instances->active_instances.first = test_instance(instances, 0);
+    instances->active_instances.last = test_instance(instances, TEST_SNAPSHOT_COUNT - 1);
+    instances->active_instances.count = TEST_SNAPSHOT_COUNT;
+    return MSL_SUCCESS;
+}
+
+static int test_capture(test_instances_t* instances, instance_snapshot_t* snapshot)
+{
+    int last_status = MSL_SUCCESS;
+    instance_iterator_t iterator;
+    CHECK_CALL(rm_iterator_init, &instances->active_instances, INSTANCE_ITERATOR_ALL_OBJECTS, instances->members_offset, &iterator);
+    CHECK_CALL(sn_capture, &iterator, snapshot);
+    return last_status;
+}
+
+static int test_capture_apply(void)
+{
+    int last_status = MSL_SUCCESS;
+    test_instances_t instances;
+    instance_snapshot_t snapshot = { 0 };
+    CHECK_CALL(test_instances_create, &instances);
+
+    // Captured twice, the second capture reuses the arrays of the first
+    for (int pass = 0; pass < 2; pass++)
+    {
+        TEST_CHECK_STATUS(test_capture(&instances, &snapshot), MSL_SUCCESS);
+        TEST_CHECK(snapshot.count == TEST_SNAPSHOT_COUNT);
+        TEST_CHECK(snapshot.capacity >= TEST_SNAPSHOT_COUNT);
+    }
+
+    for (size_t i = 0; i < snapshot.count; i++)
+    {
+        TEST_CHECK(snapshot.instances[i] == test_instance(&instances, i));
+        for (size_t field = 0; field < SNAPSHOT_FIELD_COUNT; field++)
+            TEST_CHECK(test_snapshot_field(&snapshot, field)[i] == test_field_value(i, field));
+    }
+
+    // Only the fields of the mask are written back
+    for (size_t i = 0; i < snapshot.count; i++)
+    {
+        snapshot.x[i] = -1.0f;
+        snapshot.y[i] = -2.0f;
+        snapshot.bbox_bottom[i] = -3.0f;
+    }
+
+    TEST_CHECK_STATUS(sn_apply(&snapshot, SNAPSHOT_X | SNAPSHOT_BBOX_BOTTOM), MSL_SUCCESS);
+    for (size_t i = 0; i < snapshot.count; i++)
+    {
+        instance_internal_t* members = test_members(&instances, i);
+        TEST_CHECK(members->x == -1.0f);
+        TEST_CHECK(members->y == test_field_value(i, 1));
+        TEST_CHECK(members->bounding_box.bottom == -3.0f);
+        TEST_CHECK(members->speed == test_field_value(i, 2));
+    }
+
+    TEST_CHECK_STATUS(sn_destroy(&snapshot), MSL_SUCCESS);
+    TEST_CHECK(!snapshot.arena && !snapshot.instances && !snapshot.capacity);
+
+    // Without a detected layout nothing is read
+    instance_iterator_t iterator;
+    TEST_CHECK_STATUS(rm_iterator_init_single(test_instance(&instances, 0), &iterator), MSL_SUCCESS);
+    TEST_CHECK_STATUS(sn_capture(&iterator, &snapshot), MSL_INVALID_PARAMETER);
+    snapshot.members_offset = INSTANCE_MEMBERS_OFFSET_UNKNOWN;
+    TEST_CHECK_STATUS(sn_apply(&snapshot, SNAPSHOT_ALL), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(sn_destroy(&snapshot), MSL_SUCCESS);
+
+    free(instances.storage);
+    return last_status;
+}
+
+// Each kernel matches the plain loop, or says it isn't built for this target
+static int test_kernels(void)
+{
+    int last_status = MSL_SUCCESS;
+    test_instances_t instances;
+    instance_snapshot_t snapshot = { 0 };
+    float expected[TEST_SNAPSHOT_COUNT];
+    float distances[TEST_SNAPSHOT_COUNT];
+    float x[TEST_SNAPSHOT_COUNT];
+    float y[TEST_SNAPSHOT_COUNT];
+
+    CHECK_CALL(test_instances_create, &instances);
+    CHECK_CALL(test_capture, &instances, &snapshot);
+
+    for (size_t i = 0; i < snapshot.count; i++)
+    {
+        float dx = snapshot.x[i] - 3.0f;
+        float dy = snapshot.y[i] + 7.0f;
+        expected[i] = dx * dx + dy * dy;
+    }
+
+    int(*distance_kernels[])(const instance_snapshot_t*, float, float, float*) =
+        { sn_distance_squared, sn_distance_squared_sse, sn_distance_squared_avx2 };
+    for (size_t k = 0; k < sizeof(distance_kernels) / sizeof(distance_kernels[0]); k++)
+    {
+        memset(distances, 0, sizeof(distances));
+        int status = distance_kernels[k](&snapshot, 3.0f, -7.0f, distances);
+        TEST_CHECK(status == MSL_SUCCESS || (k && status == MSL_INVALID_ARCH));
+        if (status) continue;
+
+        TEST_CHECK(!memcmp(distances, expected, sizeof(expected)));
+    }
+
+    int(*integrate_kernels[])(instance_snapshot_t*, float) =
+        { sn_integrate_speed, sn_integrate_speed_sse, sn_integrate_speed_avx2 };
+    for (size_t k = 0; k < sizeof(integrate_kernels) / sizeof(integrate_kernels[0]); k++)
+    {
+        for (size_t i = 0; i < snapshot.count; i++)
+        {
+            snapshot.x[i] = test_field_value(i, 0);
+            snapshot.y[i] = test_field_value(i, 1);
+            x[i] = snapshot.x[i] + snapshot.horizontal_speed[i] * 0.25f;
+            y[i] = snapshot.y[i] + snapshot.vertical_speed[i] * 0.25f;
+        }
+
+        int status = integrate_kernels[k](&snapshot, 0.25f);
+        TEST_CHECK(status == MSL_SUCCESS || (k && status == MSL_INVALID_ARCH));
+        if (status) continue;
+
+        TEST_CHECK(!memcmp(snapshot.x, x, sizeof(x)));
+        TEST_CHECK(!memcmp(snapshot.y, y, sizeof(y)));
+    }
+
+    TEST_CHECK_STATUS(sn_destroy(&snapshot), MSL_SUCCESS);
+    free(instances.storage);
+    return last_status;
+}
+
+int test_snapshot(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_capture_apply);
+    CHECK_CALL(test_kernels);
+    return last_status;
+}
@@ -0,0 +1,211 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "../include/spatial.h"
+
+#define TEST_SPATIAL_COUNT 2000
+#define TEST_SPATIAL_QUERIES 300
+#define TEST_SPATIAL_NEAREST 12
+
+typedef struct test_spatial_room_s test_spatial_room_t;
+
+// Boxes of the room, the instances are only used as keys and never read
+struct test_spatial_room_s
+{
+    char instance_storage[TEST_SPATIAL_COUNT];
+    instance_t* instances[TEST_SPATIAL_COUNT];
+    float left[TEST_SPATIAL_COUNT];
+    float top[TEST_SPATIAL_COUNT];
+    float right[TEST_SPATIAL_COUNT];
+    float bottom[TEST_SPATIAL_COUNT];
+    instance_snapshot_t snapshot;
+};
+
+static float test_random_float(uint64_t* state, float low, float high)
+{
+    return low + (high - low) * (float)(test_random(state) % 100000) / 100000.0f;
+}
+
+// Small boxes over a wide area around the origin, and now and then a huge one
+static void test_spatial_place(test_spatial_room_t* room, size_t index, uint64_t* state)
+{
+    float x = test_random_float(state, -3000.0f, 3000.0f);
+    float y = test_random_float(state, -2000.0f, 2000.0f);
+    float half_width = test_random(state) % 50 ? test_random_float(state, 0.0f, 24.0f) : test_random_float(state, 100.0f, 400.0f);
+    float half_height = test_random_float(state, 0.0f, 24.0f);
+
+    room->left[index] = x - half_width;
+    room->right[index] = x + half_width;
+    room->top[index] = y - half_height;
+    room->bottom[index] = y + half_height;
+}
+
+// The snapshot holds count instances, taken in order from start
+static void test_spatial_snapshot(test_spatial_room_t* room, size_t start, size_t count)
+{
+    room->snapshot.instances = &room->instances[start];
+    room->snapshot.bbox_left = &room->left[start];
+    room->snapshot.bbox_top = &room->top[start];
+    room->snapshot.bbox_right = &room->right[start];
+    room->snapshot.bbox_bottom = &room->bottom[start];
+    room->snapshot.count = count;
+}
+
+static float test_box_distance(const test_spatial_room_t* room, size_t index, float x, float y)
+{
+    float dx = fmaxf(fmaxf(room->left[index] - x, x - room->right[index]), 0.0f);
+    float dy = fmaxf(fmaxf(room->top[index] - y, y - room->bottom[index]), 0.0f);
+    return sqrtf(dx * dx + dy * dy);
+}
+
+static int test_compare_pointers(const void* first, const void* second)
+{
+    uintptr_t a = (uintptr_t)*(instance_t* const*)first;
+    uintptr_t b = (uintptr_t)*(instance_t* const*)second;
+    return (a > b) - (a < b);
+}
+
+// Same instances, whatever the order
+static void test_check_same_set(instance_t** found, size_t found_count, instance_t** expected, size_t expected_count)
+{
+    TEST_CHECK(found_count == expected_count);
+    if (found_count != expected_count) return;
+
+    qsort(found, found_count, sizeof(instance_t*), test_compare_pointers);
+    qsort(expected, expected_count, sizeof(instance_t*), test_compare_pointers);
+    TEST_CHECK(!memcmp(found, expected, found_count * sizeof(instance_t*)));
+}
+
+static void test_spatial_queries(const spatial_grid_t* grid, const test_spatial_room_t* room, size_t start, size_t count, uint64_t* state)
+{
+    static instance_t* found[TEST_SPATIAL_COUNT];
+    static instance_t* expected[TEST_SPATIAL_COUNT];
+    float distances[TEST_SPATIAL_NEAREST];
+    size_t found_count = 0;
+
+    for (int query = 0; query < TEST_SPATIAL_QUERIES; query++)
+    {
+        float x = test_random_float(state, -3500.0f, 3500.0f);
+        float y = test_random_float(state, -2500.0f, 2500.0f);
+
+        // From a few pixels to most of the room, the widest walk the buckets
+        float extent = query % 10 ? test_random_float(state, 1.0f, 300.0f) : test_random_float(state, 1000.0f, 6000.0f);
+        yyrect_t rect = { x, y, x + extent, y + extent * 0.5f };
+
+        size_t expected_count = 0;
+        for (size_t i = start; i < start + count; i++)
+        {
+            if (room->left[i] <= rect.right && room->right[i] >= rect.left && room->top[i] <= rect.bottom && room->bottom[i] >= rect.top)
+                expected[expected_count++] = room->instances[i];
+        }
+
+        TEST_CHECK_STATUS(sg_query_rect(grid, rect, found, TEST_SPATIAL_COUNT, &found_count), MSL_SUCCESS);
+        test_check_same_set(found, found_count, expected, expected_count);
+
+        expected_count = 0;
+        for (size_t i = start; i < start + count; i++)
+        {
+            if (test_box_distance(room, i, x, y) <= extent)
+                expected[expected_count++] = room->instances[i];
+        }
+
+        TEST_CHECK_STATUS(sg_query_radius(grid, x, y, extent, found, TEST_SPATIAL_COUNT, &found_count), MSL_SUCCESS);
+        test_check_same_set(found, found_count, expected, expected_count);
+
+        // Ties may come in any order, the distances must match the brute force ones
+        float nearest[TEST_SPATIAL_NEAREST];
+        size_t nearest_count = 0;
+        for (size_t i = start; i < start + count; i++)
+        {
+            float distance = test_box_distance(room, i, x, y);
+            if (nearest_count == TEST_SPATIAL_NEAREST && distance >= nearest[nearest_count - 1]) continue;
+
+            size_t position = nearest_count < TEST_SPATIAL_NEAREST ? nearest_count++ : TEST_SPATIAL_NEAREST - 1;
+            while (position > 0 && nearest[position - 1] > distance)
+            {
+                nearest[position] = nearest[position - 1];
+                position--;
+            }
+            nearest[position] = distance;
+        }
+
+        TEST_CHECK_STATUS(sg_query_nearest(grid, x, y, TEST_SPATIAL_NEAREST, found, distances, &found_count), MSL_SUCCESS);
+        TEST_CHECK(found_count == nearest_count);
+        for (size_t i = 0; i < found_count && i < nearest_count; i++)
+        {
+            TEST_CHECK(fabsf(distances[i] - nearest[i]) <= 1e-3f);
+
+            size_t index = (size_t)((char*)found[i] - room->instance_storage);
+            TEST_CHECK(index >= start && index < start + count);
+            TEST_CHECK(fabsf(test_box_distance(room, index, x, y) - distances[i]) <= 1e-3f);
+        }
+    }
+}
+
+static int test_spatial_against_brute_force(void)
+{
+    int last_status = MSL_SUCCESS;
+    test_spatial_room_t* room = (test_spatial_room_t*)calloc(1, sizeof(test_spatial_room_t));
+    spatial_grid_t grid;
+    uint64_t state = 0x5350;
+    if (!room) return MSL_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < TEST_SPATIAL_COUNT; i++)
+    {
+        room->instances[i] = (instance_t*)&room->instance_storage[i];
+        test_spatial_place(room, i, &state);
+    }
+
+    CHECK_CALL_GOTO_ERROR(sg_create, cleanup, 0.0f, &grid);
+
+    // A first room, then instances moving, leaving, and new ones coming in
+    test_spatial_snapshot(room, 0, TEST_SPATIAL_COUNT / 2);
+    TEST_CHECK_STATUS(sg_update(&grid, &room->snapshot), MSL_SUCCESS);
+    TEST_CHECK(grid.live_count == TEST_SPATIAL_COUNT / 2);
+    test_spatial_queries(&grid, room, 0, TEST_SPATIAL_COUNT / 2, &state);
+
+    for (size_t i = TEST_SPATIAL_COUNT / 4; i < TEST_SPATIAL_COUNT / 2; i++)
+    {
+        if (i % 3) test_spatial_place(room, i, &state);
+    }
+
+    test_spatial_snapshot(room, TEST_SPATIAL_COUNT / 4, TEST_SPATIAL_COUNT * 3 / 4);
+    TEST_CHECK_STATUS(sg_update(&grid, &room->snapshot), MSL_SUCCESS);
+    TEST_CHECK(grid.live_count == TEST_SPATIAL_COUNT * 3 / 4);
+    test_spatial_queries(&grid, room, TEST_SPATIAL_COUNT / 4, TEST_SPATIAL_COUNT * 3 / 4, &state);
+
+    // A full buffer keeps what fit and says more were left out
+    instance_t* found[4];
+    size_t found_count = 0;
+    yyrect_t everything = { -1e6f, -1e6f, 1e6f, 1e6f };
+    TEST_CHECK_STATUS(sg_query_rect(&grid, everything, found, 4, &found_count), MSL_INSUFFICIENT_MEMORY);
+    TEST_CHECK(found_count == 4);
+
+    // An empty room leaves nothing to find
+    float distances[4];
+    test_spatial_snapshot(room, 0, 0);
+    TEST_CHECK_STATUS(sg_update(&grid, &room->snapshot), MSL_SUCCESS);
+    TEST_CHECK(!grid.live_count);
+    TEST_CHECK_STATUS(sg_query_rect(&grid, everything, found, 4, &found_count), MSL_SUCCESS);
+    TEST_CHECK(!found_count);
+    TEST_CHECK_STATUS(sg_query_nearest(&grid, 0.0f, 0.0f, 4, found, distances, &found_count), MSL_SUCCESS);
+    TEST_CHECK(!found_count);
+
+    TEST_CHECK_STATUS(sg_destroy(&grid), MSL_SUCCESS);
+
+    cleanup:
+    free(room);
+    return last_status;
+}
+
+int test_spatial(void)
+{
+    int last_status = MSL_SUCCESS;
+    CHECK_CALL(test_spatial_against_brute_force);
+    return last_status;
+}
@@ -0,0 +1,213 @@
+// Copyright (C) 2025 Rémy Cases
+// See LICENSE file for extended copyright information.
+// This file is part of MSLYYC_exploration project from https://github.com/remyCases/MSLYYC_exploration.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "test.h"
+#include "../include/utils.h"
+
+#define TEST_WALKER_TEMPLATE "test_walker_XXXXXX"
+#define TEST_WALKER_FILES 13
+
+// Depth of each file below the root, and whether it ends with .dll in any case
+typedef struct test_walker_file_s
+{
+    const char* path;
+    uint32_t depth;
+    bool is_dll;
+} test_walker_file_t;
+
+static const test_walker_file_t walker_files[TEST_WALKER_FILES] = {
+    { "root.dll", 0, true },
+    { "root.txt", 0, false },
+    { "UPPER.DLL", 0, true },
+    { "dll", 0, false },
+    { "a/one.dll", 1, true },
+    { "a/one.Dll.bak", 1, false },
+    { "a/b/two.dll", 2, true },
+    { "a/b/c/three.dll", 3, true },
+    { "a/b/c/d/four.dll", 4, true },
+    { "e/five.dll", 1, true },
+    { "e/.hidden.dll", 1, true },
+    { "f/g/h/six.txt", 3, false },
+    { "empty.dll/seven.dll", 1, true },
+};
+
+static const char* walker_folders[] = {
+    "a", "a/b", "a/b/c", "a/b/c/d", "e", "f", "f/g", "f/g/h", "empty.dll", "i", "i/j",
+};
+
+static char walker_root[sizeof(TEST_WALKER_TEMPLATE)];
+
+static int test_walker_write(const char* relative)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", walker_root, relative);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return MSL_ACCESS_DENIED;
+    fputs(relative, file);
+    fclose(file);
+    return MSL_SUCCESS;
+}
+
+static int test_walker_create(void)
+{
+    int last_status = MSL_SUCCESS;
+    char path[256];
+
+    memcpy(walker_root, TEST_WALKER_TEMPLATE, sizeof(TEST_WALKER_TEMPLATE));
+    if (!mkdtemp(walker_root)) return MSL_ACCESS_DENIED;
+
+    for (size_t i = 0; i < sizeof(walker_folders) / sizeof(walker_folders[0]); i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", walker_root, walker_folders[i]);
+        if (mkdir(path, 0700)) return MSL_ACCESS_DENIED;
+    }
+
+    for (size_t i = 0; i < TEST_WALKER_FILES; i++)
+    {
+        CHECK_CALL(test_walker_write, walker_files[i].path);
+    }
+
+    // A link to a folder above is never followed
+    snprintf(path, sizeof(path), "%s/a/b/loop", walker_root);
+    if (symlink("..", path)) return MSL_ACCESS_DENIED;
+
+    return MSL_SUCCESS;
+}
+
+static void test_walker_remove(void)
+{
+    char path[256];
+
+    snprintf(path, sizeof(path), "%s/a/b/loop", walker_root);
+    unlink(path);
+
+    for (size_t i = 0; i < TEST_WALKER_FILES; i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", walker_root, walker_files[i].path);
+        unlink(path);
+    }
+
+    for (size_t i = sizeof(walker_folders) / sizeof(walker_folders[0]); i > 0; i--)
+    {
+        snprintf(path, sizeof(path), "%s/%s", walker_root, walker_folders[i - 1]);
+        rmdir(path);
+    }
+
+    rmdir(walker_root);
+}
+
+// Walks from root and checks every expected file comes out once, with its full path
+static int test_walk(const char* root, const char* extension, uint32_t max_depth)
+{
+    directory_walker_t* walker = (directory_walker_t*)malloc(sizeof(directory_walker_t));
+    if (!walker) return MSL_ALLOCATION_ERROR;
+
+    uint32_t seen[TEST_WALKER_FILES] = { 0 };
+    size_t root_length = strlen(walker_root);
+    bool found = false;
+    size_t count = 0;
+
+    TEST_CHECK_STATUS(walker_open(root, extension, max_depth, walker), MSL_SUCCESS);
+    while (walker_next(walker, &found) == MSL_SUCCESS && found)
+    {
+        count++;
+        TEST_CHECK(walker->path_length == strlen(walker->path));
+        TEST_CHECK(!strncmp(walker->path, walker_root, root_length) && walker->path[root_length] == '/');
+        TEST_CHECK(walker->name > walker->path && walker->name[-1] == '/' && !strchr(walker->name, '/'));
+
+        size_t i = 0;
+        while (i < TEST_WALKER_FILES && strcmp(walker->path + root_length + 1, walker_files[i].path)) i++;
+        TEST_CHECK(i < TEST_WALKER_FILES);
+        if (i < TEST_WALKER_FILES) seen[i]++;
+    }
+    TEST_CHECK_STATUS(walker_close(walker), MSL_SUCCESS);
+    TEST_CHECK(walker->open_count == 0);
+
+    size_t expected = 0;
+    for (size_t i = 0; i < TEST_WALKER_FILES; i++)
+    {
+        bool wanted = walker_files[i].depth <= max_depth && (!extension || walker_files[i].is_dll);
+        TEST_CHECK(seen[i] == (wanted ? 1u : 0u));
+        expected += wanted;
+    }
+    TEST_CHECK(count == expected);
+
+    free(walker);
+    return MSL_SUCCESS;
+}
+
+static int test_walker_depths(void)
+{
+    int last_status = MSL_SUCCESS;
+    char root[sizeof(walker_root) + 1];
+
+    for (uint32_t depth = 0; depth <= 5; depth++)
+    {
+        CHECK_CALL(test_walk, walker_root, NULL, depth);
+        CHECK_CALL(test_walk, walker_root, ".dll", depth);
+        CHECK_CALL(test_walk, walker_root, ".DLL", depth);
+    }
+
+    // A trailing separator isn't doubled, and depths past the limit are clamped
+    snprintf(root, sizeof(root), "%s/", walker_root);
+    CHECK_CALL(test_walk, root, ".dll", WALKER_MAX_DEPTH * 2);
+    return MSL_SUCCESS;
+}
+
+static int test_walker_failures(void)
+{
+    directory_walker_t* walker = (directory_walker_t*)malloc(sizeof(directory_walker_t));
+    if (!walker) return MSL_ALLOCATION_ERROR;
+
+    char missing[sizeof(walker_root) + 16];
+    snprintf(missing, sizeof(missing), "%s/missing", walker_root);
+    bool found = true;
+
+    TEST_CHECK(walker_open(missing, NULL, 1, walker) != MSL_SUCCESS);
+    TEST_CHECK_STATUS(walker_next(walker, &found), MSL_SUCCESS);
+    TEST_CHECK(!found);
+    TEST_CHECK_STATUS(walker_close(walker), MSL_SUCCESS);
+
+    TEST_CHECK_STATUS(walker_open("", NULL, 1, walker), MSL_INVALID_PARAMETER);
+    TEST_CHECK_STATUS(walker_close(walker), MSL_SUCCESS);
+
+    // A root longer than the path buffer
+    char* long_root = (char*)malloc(WALKER_PATH_CAPACITY + 1);
+    if (long_root)
+    {
+        memset(long_root, 'a', WALKER_PATH_CAPACITY);
+        long_root[WALKER_PATH_CAPACITY] = 0;
+        TEST_CHECK_STATUS(walker_open(long_root, NULL, 1, walker), MSL_INVALID_PARAMETER);
+        TEST_CHECK_STATUS(walker_close(walker), MSL_SUCCESS);
+        free(long_root);
+    }
+
+    // Closing halfway closes every open folder
+    TEST_CHECK_STATUS(walker_open(walker_root, NULL, WALKER_MAX_DEPTH, walker), MSL_SUCCESS);
+    while (walker_next(walker, &found) == MSL_SUCCESS && found && walker->open_count < 3);
+    TEST_CHECK(walker->open_count >= 3);
+    TEST_CHECK_STATUS(walker_close(walker), MSL_SUCCESS);
+    TEST_CHECK(walker->open_count == 0);
+
+    free(walker);
+    return MSL_SUCCESS;
+}
+
+int test_walker(void)
+{
+    int last_status = test_walker_create();
+    if (last_status == MSL_SUCCESS)
+    {
+        last_status = test_walker_depths();
+        if (last_status == MSL_SUCCESS) last_status = test_walker_failures();
+    }
+
+    test_walker_remove();
+    return last_status;
+}